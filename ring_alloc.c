@@ -0,0 +1,117 @@
+#ifndef RING_ALLOC_C
+#define RING_ALLOC_C
+
+#include "ring_buffer.c"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Page-size and NUMA aware allocation for large rings.
+ *
+ * Large rings walk through many pages per lap, so with 4 KiB pages the hot
+ * path takes TLB misses, and on multi-socket hosts the pages land wherever
+ * the first toucher ran. ring_init_opts() maps the data region itself so it
+ * can ask for huge pages, bind it to a NUMA node before any page is faulted
+ * in, and pre-fault every page so the first lap doesn't take page faults.
+ */
+typedef enum {
+    RING_PAGES_DEFAULT,     /* Normal pages */
+    RING_PAGES_THP,         /* Transparent huge pages via madvise(); best effort */
+    RING_PAGES_HUGE_2M,     /* Explicit 2 MiB hugetlb pages; fails if none reserved */
+    RING_PAGES_HUGE_1G      /* Explicit 1 GiB hugetlb pages; fails if none reserved */
+} ring_page_size_t;
+
+typedef struct {
+    ring_page_size_t pages;
+    int numa_node;          /* Bind the data region to this node; -1 for no binding */
+    bool prefault;          /* Touch every page during init */
+} ring_alloc_opts_t;
+
+#define RING_ALLOC_OPTS_DEFAULT ((ring_alloc_opts_t){ RING_PAGES_DEFAULT, -1, true })
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#define RING_NUMA_MPOL_BIND 2   /* MPOL_BIND from <numaif.h>, without libnuma */
+
+static void ring_release_mapping(ring_buffer_t *rb) {
+    munmap(rb->data, rb->capacity);
+}
+
+static size_t ring_page_bytes(ring_page_size_t pages) {
+    switch (pages) {
+    case RING_PAGES_HUGE_2M: return (size_t)2 << 20;
+    case RING_PAGES_HUGE_1G: return (size_t)1 << 30;
+    case RING_PAGES_THP:
+    case RING_PAGES_DEFAULT:
+    default: break;
+    }
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static bool ring_bind_node(void *addr, size_t len, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long nodemask[4] = {0};
+    size_t bits = sizeof(nodemask) * 8;
+    if (node < 0 || (size_t)node >= bits) return false;
+
+    nodemask[node / (sizeof(unsigned long) * 8)] |= 1UL << (node % (sizeof(unsigned long) * 8));
+    return syscall(SYS_mbind, addr, len, RING_NUMA_MPOL_BIND, nodemask, bits + 1, 0) == 0;
+#else
+    (void)addr;
+    (void)len;
+    (void)node;
+    return false;
+#endif
+}
+
+/*
+ * Initialize `rb` with a freshly mapped data region described by `opts`.
+ * `capacity` must be a power of two and a multiple of the chosen page size.
+ * Returns false on invalid arguments, if the requested huge pages aren't
+ * available, or if the NUMA binding fails.
+ */
+bool ring_init_opts(ring_buffer_t *rb, size_t capacity, const ring_alloc_opts_t *opts) {
+    size_t page = ring_page_bytes(opts->pages);
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    if (capacity % page != 0) return false;
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (opts->pages == RING_PAGES_HUGE_2M) flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+    if (opts->pages == RING_PAGES_HUGE_1G) flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+#else
+    if (opts->pages == RING_PAGES_HUGE_2M || opts->pages == RING_PAGES_HUGE_1G) return false;
+#endif
+
+    uint8_t *data = mmap(NULL, capacity, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (data == MAP_FAILED) return false;
+
+#ifdef MADV_HUGEPAGE
+    if (opts->pages == RING_PAGES_THP) madvise(data, capacity, MADV_HUGEPAGE);
+#endif
+
+    /* Bind before the first touch so every page is allocated on the node */
+    if (opts->numa_node >= 0 && !ring_bind_node(data, capacity, opts->numa_node)) {
+        munmap(data, capacity);
+        return false;
+    }
+
+    if (opts->prefault) {
+        for (size_t off = 0; off < capacity; off += page) {
+            ((volatile uint8_t *)data)[off] = 0;
+        }
+    }
+
+    ring_setup(rb, data, capacity);
+    rb->release = ring_release_mapping;
+    return true;
+}
+
+#endif /* RING_ALLOC_C */
@@ -0,0 +1,159 @@
+#ifndef RING_BROADCAST_C
+#define RING_BROADCAST_C
+
+#include "ring_buffer.c"
+
+/*
+ * Single-producer, multi-reader broadcast ring: the producer writes each
+ * message once and every reader sees every byte through its own tail.
+ *
+ * As in the core ring, positions are free-running byte counters (masked
+ * only on access), so a reader's lag is simply `head - tail`.
+ *
+ * RING_BROADCAST_BLOCKING gates the producer on the slowest reader.
+ * RING_BROADCAST_LOSSY never holds up the producer; a reader that falls more
+ * than `capacity` bytes behind is told how many bytes it lost and skips to
+ * the live edge, which is always on a push boundary. Lossy readers validate
+ * each copy seqlock-style against the producer's claim cursor, so a message
+ * overwritten mid-copy is reported as lost rather than returned torn.
+ */
+#define RING_BROADCAST_MAX_READERS 16
+
+typedef enum {
+    RING_BROADCAST_BLOCKING,
+    RING_BROADCAST_LOSSY
+} ring_broadcast_policy_t;
+
+/* Per-reader state, one cache line each */
+typedef struct {
+    alignas(CACHE_LINE) atomic_size_t tail;
+    size_t cached_head;
+} ring_reader_t;
+
+typedef struct {
+    /* ring.head / ring.cached_tail are the producer position and cached
+     * slowest-reader tail; ring.tail is unused */
+    ring_buffer_t ring;
+    ring_broadcast_policy_t policy;
+    size_t num_readers;
+
+    /* Lossy mode: end of the region the producer may be overwriting */
+    alignas(CACHE_LINE) atomic_size_t claim;
+
+    ring_reader_t readers[RING_BROADCAST_MAX_READERS];
+} ring_broadcast_t;
+
+/*
+ * Initialize a broadcast ring for exactly `num_readers` readers, identified
+ * as 0 .. num_readers - 1. `capacity` and `buffer` are as for ring_init().
+ */
+bool ring_broadcast_init(ring_broadcast_t *b, size_t capacity, void *buffer,
+                         size_t num_readers, ring_broadcast_policy_t policy) {
+    if (num_readers == 0 || num_readers > RING_BROADCAST_MAX_READERS) return false;
+    if (!ring_init(&b->ring, capacity, buffer)) return false;
+
+    b->policy = policy;
+    b->num_readers = num_readers;
+    atomic_init(&b->claim, 0);
+    for (size_t i = 0; i < RING_BROADCAST_MAX_READERS; i++) {
+        atomic_init(&b->readers[i].tail, 0);
+        b->readers[i].cached_head = 0;
+    }
+    return true;
+}
+
+void ring_broadcast_destroy(ring_broadcast_t *b) {
+    ring_destroy(&b->ring);
+}
+
+static size_t ring_broadcast_min_tail(ring_broadcast_t *b, size_t head) {
+    size_t min_tail = head;
+    for (size_t i = 0; i < b->num_readers; i++) {
+        size_t tail = atomic_load_explicit(&b->readers[i].tail, memory_order_acquire);
+        if (head - tail > head - min_tail) min_tail = tail;
+    }
+    return min_tail;
+}
+
+/*
+ * Producer: write `len` bytes once for all readers. In blocking mode returns
+ * false if the slowest reader hasn't freed enough space; in lossy mode only
+ * fails if `len` exceeds the capacity.
+ */
+bool ring_broadcast_push(ring_broadcast_t *b, uint8_t *src, size_t len) {
+    ring_buffer_t *rb = &b->ring;
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    if (len > rb->capacity) return false;
+
+    if (b->policy == RING_BROADCAST_BLOCKING) {
+        if (len > rb->capacity - (head - rb->cached_tail)) {
+            rb->cached_tail = ring_broadcast_min_tail(b, head);
+            if (len > rb->capacity - (head - rb->cached_tail)) return false;
+        }
+    } else {
+        /* Announce the overwrite before touching the data */
+        atomic_store_explicit(&b->claim, head + len, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+
+    ring_copy_in(rb, head & rb->mask, src, len);
+
+    atomic_store_explicit(&rb->head, head + len, memory_order_release);
+    return true;
+}
+
+/*
+ * Reader `reader`: copy the next `len` bytes into `dst`. Returns false if
+ * fewer than `len` bytes are available. In lossy mode `*lost` (if non-NULL)
+ * is set to the number of bytes skipped because the producer lapped this
+ * reader; they are skipped even when the call then returns false.
+ */
+bool ring_broadcast_pop(ring_broadcast_t *b, size_t reader, uint8_t *dst, size_t len, size_t *lost) {
+    ring_buffer_t *rb = &b->ring;
+    ring_reader_t *r = &b->readers[reader];
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    if (lost != NULL) *lost = 0;
+
+    if (len > r->cached_head - tail) {
+        r->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+
+        if (b->policy == RING_BROADCAST_LOSSY && r->cached_head - tail > rb->capacity) {
+            goto overrun;
+        }
+        if (len > r->cached_head - tail) return false;
+    }
+
+    if (b->policy == RING_BROADCAST_LOSSY) {
+        ring_copy_out_speculative(rb, tail & rb->mask, dst, len);
+    } else {
+        ring_copy_out(rb, tail & rb->mask, dst, len);
+    }
+
+    if (b->policy == RING_BROADCAST_LOSSY) {
+        /* Anything the producer started writing over during the copy is torn */
+        atomic_thread_fence(memory_order_acquire);
+        size_t claim = atomic_load_explicit(&b->claim, memory_order_relaxed);
+        if (claim - tail > rb->capacity) {
+            r->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+            goto overrun;
+        }
+    }
+
+    atomic_store_explicit(&r->tail, tail + len, memory_order_release);
+    return true;
+
+overrun:
+    if (lost != NULL) *lost = r->cached_head - tail;
+    atomic_store_explicit(&r->tail, r->cached_head, memory_order_release);
+    return false;
+}
+
+/* Bytes published but not yet read by `reader` (may exceed capacity if lossy) */
+size_t ring_broadcast_lag(ring_broadcast_t *b, size_t reader) {
+    size_t head = atomic_load_explicit(&b->ring.head, memory_order_acquire);
+    return head - atomic_load_explicit(&b->readers[reader].tail, memory_order_acquire);
+}
+
+#endif /* RING_BROADCAST_C */
@@ -1,51 +1,1036 @@
+#ifndef RING_BUFFER_C
+#define RING_BUFFER_C
+
 #include <stdalign.h>
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
-#define BUFFER_SIZE 1024
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BUFFER_SIZE 1024    /* Default capacity used by the tests and examples */
 #define CACHE_LINE 64
 
+/* Spin-wait hint: frees pipeline resources for the sibling hyperthread */
+#if defined(__x86_64__) || defined(__i386__)
+#define ring_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define ring_cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define ring_cpu_relax() ((void)0)
+#endif
+
+/*
+ * Copy hints, per ring (ring_set_hints) or per call (ring_push_hint /
+ * ring_pop_hint). They only change how bytes move, never what is moved.
+ *
+ * RING_HINT_STREAM writes the payload with non-temporal stores, so a
+ * producer pushing large frames that it never reads again doesn't evict its
+ * own working set from L1/L2. Only 64-byte-aligned chunks stream; the rest
+ * (and every copy shorter than RING_STREAM_MIN) goes through memcpy(). It is
+ * a loss for small or hot messages, since the consumer then reads from DRAM
+ * instead of the shared L3. Falls back to memcpy() without SSE2.
+ *
+ * RING_HINT_PREFETCH makes ring_pop() prefetch up to RING_PREFETCH_BYTES of
+ * the data following the message it just copied, when the producer has
+ * already published it, so the next pop hits the cache. It uses the
+ * non-temporal prefetch, matching a consumer that hands data off (to
+ * disk, say) rather than keeping it.
+ */
+#define RING_HINT_STREAM   0x1u
+#define RING_HINT_PREFETCH 0x2u
+
+#define RING_STREAM_MIN 256
+#define RING_PREFETCH_BYTES 512
+
+/* ============ Copy Kernels ============ */
+
+/*
+ * Payload copies go through a kernel picked once, at ring init, from what
+ * the running CPU supports (cpuid on x86, hwcap on AArch64 Linux), so one
+ * baseline build still uses the widest vectors each host has. Every SIMD
+ * kernel stores the first and last vector unaligned and everything in
+ * between at dst-aligned addresses, so a copy never splits a store across
+ * cache lines except at its two ends, wherever the wrap point cut it.
+ * Copies shorter than one vector go to memcpy().
+ *
+ * ring_copy_kernels[] is ordered best first; "memcpy" (the C library's,
+ * which may do its own dispatch) is always last and always supported.
+ */
+typedef void (*ring_copy_fn_t)(uint8_t *dst, const uint8_t *src, size_t len);
+
 typedef struct {
-    uint8_t data[BUFFER_SIZE];
-    
+    const char *name;
+    ring_copy_fn_t copy;
+    bool (*supported)(void);
+} ring_copy_kernel_t;
+
+static void ring_copy_memcpy(uint8_t *dst, const uint8_t *src, size_t len) {
+    memcpy(dst, src, len);
+}
+
+static bool ring_copy_always(void) {
+    return true;
+}
+
+/*
+ * Head, aligned body (four vectors per iteration, so loads run ahead of
+ * stores), tail: `width`-byte vectors via the given load/store ops.
+ */
+#define RING_COPY_BODY(vec_t, width, loadu, storeu, store)                       \
+    if (len < (width)) {                                                         \
+        memcpy(dst, src, len);                                                   \
+        return;                                                                  \
+    }                                                                            \
+    storeu((vec_t *)dst, loadu((const vec_t *)src));                             \
+    size_t i = (width) - ((uintptr_t)dst & ((width) - 1));                       \
+    for (; i + 4 * (width) <= len; i += 4 * (width)) {                           \
+        const uint8_t *s_ = src + i;                                             \
+        uint8_t *d_ = dst + i;                                                   \
+        __typeof__(loadu((const vec_t *)s_)) a_ = loadu((const vec_t *)s_);      \
+        __typeof__(a_) b_ = loadu((const vec_t *)(s_ + (width)));                \
+        __typeof__(a_) c_ = loadu((const vec_t *)(s_ + 2 * (width)));            \
+        __typeof__(a_) e_ = loadu((const vec_t *)(s_ + 3 * (width)));            \
+        store((vec_t *)d_, a_);                                                  \
+        store((vec_t *)(d_ + (width)), b_);                                      \
+        store((vec_t *)(d_ + 2 * (width)), c_);                                  \
+        store((vec_t *)(d_ + 3 * (width)), e_);                                  \
+    }                                                                            \
+    for (; i + (width) <= len; i += (width)) {                                   \
+        store((vec_t *)(dst + i), loadu((const vec_t *)(src + i)));              \
+    }                                                                            \
+    storeu((vec_t *)(dst + len - (width)), loadu((const vec_t *)(src + len - (width))))
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+static void ring_copy_sse2(uint8_t *dst, const uint8_t *src, size_t len) {
+    RING_COPY_BODY(__m128i, 16, _mm_loadu_si128, _mm_storeu_si128, _mm_store_si128);
+}
+
+__attribute__((target("avx2")))
+static void ring_copy_avx2(uint8_t *dst, const uint8_t *src, size_t len) {
+    RING_COPY_BODY(__m256i, 32, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_store_si256);
+}
+
+__attribute__((target("avx512f")))
+static void ring_copy_avx512(uint8_t *dst, const uint8_t *src, size_t len) {
+    RING_COPY_BODY(__m512i, 64, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_store_si512);
+}
+
+/* __builtin_cpu_supports also checks that the OS saves the wider registers */
+static bool ring_cpu_has_sse2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+static bool ring_cpu_has_avx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static bool ring_cpu_has_avx512(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+
+#define RING_HWCAP_ASIMD (1UL << 1)     /* HWCAP_ASIMD from <asm/hwcap.h> */
+
+static void ring_copy_neon(uint8_t *dst, const uint8_t *src, size_t len) {
+    RING_COPY_BODY(uint8_t, 16, vld1q_u8, vst1q_u8, vst1q_u8);
+}
+
+static bool ring_cpu_has_neon(void) {
+    return (getauxval(AT_HWCAP) & RING_HWCAP_ASIMD) != 0;
+}
+#endif
+
+static const ring_copy_kernel_t ring_copy_kernels[] = {
+#if defined(__x86_64__) || defined(__i386__)
+    { "avx512", ring_copy_avx512, ring_cpu_has_avx512 },
+    { "avx2", ring_copy_avx2, ring_cpu_has_avx2 },
+    { "sse2", ring_copy_sse2, ring_cpu_has_sse2 },
+#elif defined(__aarch64__) && defined(__linux__)
+    { "neon", ring_copy_neon, ring_cpu_has_neon },
+#endif
+    { "memcpy", ring_copy_memcpy, ring_copy_always }
+};
+
+#define RING_NUM_COPY_KERNELS (sizeof(ring_copy_kernels) / sizeof(ring_copy_kernels[0]))
+
+/* Kernel called `name`, or NULL if there is none or this CPU can't run it */
+const ring_copy_kernel_t *ring_copy_kernel_find(const char *name) {
+    for (size_t i = 0; i < RING_NUM_COPY_KERNELS; i++) {
+        if (strcmp(ring_copy_kernels[i].name, name) == 0) {
+            return ring_copy_kernels[i].supported() ? &ring_copy_kernels[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+/* Widest kernel this CPU supports; detected on first use, then cached */
+const ring_copy_kernel_t *ring_copy_kernel_best(void) {
+    static const ring_copy_kernel_t *_Atomic best;
+
+    const ring_copy_kernel_t *k = atomic_load_explicit(&best, memory_order_relaxed);
+    if (k == NULL) {
+        k = &ring_copy_kernels[RING_NUM_COPY_KERNELS - 1];
+        for (size_t i = 0; i < RING_NUM_COPY_KERNELS; i++) {
+            if (ring_copy_kernels[i].supported()) {
+                k = &ring_copy_kernels[i];
+                break;
+            }
+        }
+        atomic_store_explicit(&best, k, memory_order_relaxed);
+    }
+    return k;
+}
+
+/*
+ * Opt-in instrumentation: build with -DRING_STATS to have each side count
+ * its own operations. Every counter has a single writer (the side that owns
+ * it), so updates are a relaxed load and store rather than an atomic RMW,
+ * which compiles to plain moves; the atomics only make it legal for a
+ * monitoring thread to read them concurrently. Like head and tail they are
+ * size_t, so on 32-bit targets they wrap. Without RING_STATS the fields
+ * and all recording calls compile away.
+ */
+#define RING_STATS_BUCKETS 8    /* Occupancy histogram: fill level in eighths of capacity */
+
+#ifdef RING_STATS
+typedef struct {
+    atomic_size_t ops;          /* Successful operations (a batch counts once) */
+    atomic_size_t failed;       /* Calls that moved nothing: full / empty / too large */
+    atomic_size_t bytes;        /* Payload bytes moved */
+    atomic_size_t high_water;   /* Highest fill level seen on publish */
+    atomic_size_t occupancy[RING_STATS_BUCKETS];    /* Publishes per fill-level bucket */
+} ring_side_stats_t;
+#endif
+
+typedef struct ring_buffer ring_buffer_t;
+
+struct ring_buffer {
+    /* Read-only after ring_init(), shared by both sides */
+    uint8_t *data;
+    size_t capacity;
+    size_t mask;
+    bool mirrored;                          /* data[capacity..2*capacity) aliases data[0..capacity) */
+    unsigned hints;                         /* RING_HINT_* defaults for ring_push / ring_pop */
+    ring_copy_fn_t copy;                    /* Payload copy kernel, chosen at init */
+    void (*release)(ring_buffer_t *rb);     /* Frees `data`; NULL if caller-owned */
+
+    /*
+     * head and tail are free-running byte counters: they only ever grow and
+     * are masked on access, so head - tail is the fill level, the whole
+     * capacity is usable, and each is the total bytes written / read.
+     * They are size_t rather than uint64_t so that every access stays a
+     * plain lock-free word on any target; on 32-bit targets they (and the
+     * totals) wrap every 4 GiB, which the masked arithmetic is immune to.
+     */
+
+    /* Producer line: its own counter plus its private copy of the consumer's */
     alignas(CACHE_LINE) atomic_size_t head;
+    size_t cached_tail;
+    size_t staged;              /* ring_push_staged() bytes past head, unpublished */
+    size_t staged_msgs;
+    size_t flush_bytes;         /* ring_set_coalesce() thresholds; 0 = no limit */
+    size_t flush_msgs;
+#ifdef RING_STATS
+    ring_side_stats_t producer_stats;
+#endif
+
+    /* Consumer line: its own counter plus its private copy of the producer's */
     alignas(CACHE_LINE) atomic_size_t tail;
-} ring_buffer_t;
+    size_t cached_head;
+#ifdef RING_STATS
+    ring_side_stats_t consumer_stats;
+#endif
+};
 
-bool ring_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+/*
+ * Recording helpers. `used` is the fill level as the recording side sees it
+ * right after publishing (its cached copy of the remote counter may be
+ * stale, so the producer over-reports and the consumer under-reports).
+ */
+#ifdef RING_STATS
+static inline void ring_stat_add(atomic_size_t *counter, size_t n) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static inline void ring_stats_ok(ring_side_stats_t *st, size_t capacity, size_t bytes, size_t used) {
+    ring_stat_add(&st->ops, 1);
+    ring_stat_add(&st->bytes, bytes);
+    if (used > atomic_load_explicit(&st->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&st->high_water, used, memory_order_relaxed);
+    }
+
+    /* capacity is a power of two, so scaling to buckets is a shift */
+    size_t bucket = (used * RING_STATS_BUCKETS) >> __builtin_ctzll((unsigned long long)capacity);
+    if (bucket >= RING_STATS_BUCKETS) bucket = RING_STATS_BUCKETS - 1;
+    ring_stat_add(&st->occupancy[bucket], 1);
+}
+
+#define RING_STATS_OK(rb, side, bytes, used) \
+    ring_stats_ok(&(rb)->side##_stats, (rb)->capacity, (bytes), (used))
+#define RING_STATS_FAIL(rb, side) ring_stat_add(&(rb)->side##_stats.failed, 1)
+#else
+#define RING_STATS_OK(rb, side, bytes, used) ((void)0)
+#define RING_STATS_FAIL(rb, side) ((void)0)
+#endif
+
+static void ring_release_heap(ring_buffer_t *rb) {
+    free(rb->data);
+}
+
+/* Common tail of every initializer: empty ring over `data`, best copy kernel */
+static void ring_setup(ring_buffer_t *rb, uint8_t *data, size_t capacity) {
+    memset(rb, 0, sizeof(*rb));
+    rb->data = data;
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    rb->copy = ring_copy_kernel_best()->copy;
+    atomic_init(&rb->head, 0);
+    atomic_init(&rb->tail, 0);
+}
+
+/*
+ * Initialize a ring with `capacity` bytes of storage. `capacity` must be a
+ * non-zero power of two. If `buffer` is NULL the storage is allocated
+ * (cache-line aligned) and released by ring_destroy(); otherwise `buffer`
+ * must be CACHE_LINE aligned, at least `capacity` bytes, and stays owned by
+ * the caller. Returns false on invalid arguments or allocation failure.
+ */
+bool ring_init(ring_buffer_t *rb, size_t capacity, void *buffer) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    if (buffer != NULL && ((uintptr_t)buffer & (CACHE_LINE - 1)) != 0) return false;
+
+    void (*release)(ring_buffer_t *) = NULL;
+    if (buffer == NULL) {
+        /* aligned_alloc() wants the size to be a multiple of the alignment */
+        size_t alloc = capacity < CACHE_LINE ? CACHE_LINE : capacity;
+        buffer = aligned_alloc(CACHE_LINE, alloc);
+        if (buffer == NULL) return false;
+        release = ring_release_heap;
+    }
+
+    ring_setup(rb, buffer, capacity);
+    rb->release = release;
+    return true;
+}
+
+void ring_destroy(ring_buffer_t *rb) {
+    if (rb->release != NULL) rb->release(rb);
+    rb->data = NULL;
+    rb->capacity = 0;
+    rb->mask = 0;
+    rb->mirrored = false;
+    rb->hints = 0;
+    rb->release = NULL;
+}
+
+/* Set the default RING_HINT_* flags; call before either side starts */
+void ring_set_hints(ring_buffer_t *rb, unsigned hints) {
+    rb->hints = hints;
+}
+
+/*
+ * Override the copy kernel by name (see ring_copy_kernels[]); call before
+ * either side starts. Returns false, leaving the ring as it was, if the
+ * kernel is unknown or unsupported here.
+ */
+bool ring_set_copy_kernel(ring_buffer_t *rb, const char *name) {
+    const ring_copy_kernel_t *k = ring_copy_kernel_find(name);
+    if (k == NULL) return false;
+    rb->copy = k->copy;
+    return true;
+}
+
+/* Name of the kernel the ring copies with */
+const char *ring_copy_kernel_name(const ring_buffer_t *rb) {
+    for (size_t i = 0; i < RING_NUM_COPY_KERNELS; i++) {
+        if (ring_copy_kernels[i].copy == rb->copy) return ring_copy_kernels[i].name;
+    }
+    return "unknown";
+}
+
+/*
+ * Copy `len` bytes into / out of a `capacity`-byte data region starting at
+ * offset `pos` (an already masked counter). The span is split at the wrap
+ * point into at most two contiguous calls of the `copy` kernel, each of
+ * which aligns its own stores.
+ */
+static inline void ring_region_copy_in(ring_copy_fn_t copy, uint8_t *data, size_t capacity,
+                                       size_t pos, const uint8_t *src, size_t len) {
+    size_t first = capacity - pos;
+    if (len <= first) {
+        copy(data + pos, src, len);
+    } else {
+        copy(data + pos, src, first);
+        copy(data, src + first, len - first);
+    }
+}
+
+static inline void ring_region_copy_out(ring_copy_fn_t copy, const uint8_t *data,
+                                        size_t capacity, size_t pos, uint8_t *dst, size_t len) {
+    size_t first = capacity - pos;
+    if (len <= first) {
+        copy(dst, data + pos, len);
+    } else {
+        copy(dst, data + pos, first);
+        copy(dst + first, data, len - first);
+    }
+}
+
+/*
+ * memcpy() with non-temporal stores for the 64-byte-aligned body of `dst`.
+ * The stores are weakly ordered, so the caller must ring_stream_fence()
+ * before publishing the bytes.
+ */
+static inline void ring_stream_copy(uint8_t *dst, const uint8_t *src, size_t len) {
+#if defined(__SSE2__)
+    if (len >= RING_STREAM_MIN) {
+        size_t lead = (size_t)(-(uintptr_t)dst & (CACHE_LINE - 1));
+        memcpy(dst, src, lead);
+        dst += lead;
+        src += lead;
+        len -= lead;
+
+        for (; len >= CACHE_LINE; len -= CACHE_LINE, dst += CACHE_LINE, src += CACHE_LINE) {
+            __m128i a = _mm_loadu_si128((const __m128i *)src);
+            __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+            __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+            __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+            _mm_stream_si128((__m128i *)dst, a);
+            _mm_stream_si128((__m128i *)(dst + 16), b);
+            _mm_stream_si128((__m128i *)(dst + 32), c);
+            _mm_stream_si128((__m128i *)(dst + 48), d);
+        }
+    }
+#endif
+    memcpy(dst, src, len);
+}
+
+/* Order streamed stores before the release store that publishes them */
+static inline void ring_stream_fence(void) {
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
+/* A mirrored data region is contiguous for any span up to `capacity` bytes */
+static inline void ring_copy_in_hint(ring_buffer_t *rb, size_t pos, const uint8_t *src,
+                                     size_t len, unsigned hints) {
+    if (!(hints & RING_HINT_STREAM)) {
+        if (rb->mirrored) {
+            rb->copy(rb->data + pos, src, len);
+        } else {
+            ring_region_copy_in(rb->copy, rb->data, rb->capacity, pos, src, len);
+        }
+        return;
+    }
+
+    size_t first = rb->mirrored ? len : rb->capacity - pos;
+    if (len <= first) {
+        ring_stream_copy(rb->data + pos, src, len);
+    } else {
+        ring_stream_copy(rb->data + pos, src, first);
+        ring_stream_copy(rb->data, src + first, len - first);
+    }
+    ring_stream_fence();
+}
+
+static inline void ring_copy_in(ring_buffer_t *rb, size_t pos, const uint8_t *src, size_t len) {
+    ring_copy_in_hint(rb, pos, src, len, rb->hints);
+}
+
+static inline void ring_copy_out(const ring_buffer_t *rb, size_t pos, uint8_t *dst, size_t len) {
+    if (rb->mirrored) {
+        rb->copy(dst, rb->data + pos, len);
+    } else {
+        ring_region_copy_out(rb->copy, rb->data, rb->capacity, pos, dst, len);
+    }
+}
+
+/*
+ * ring_copy_out() for seqlock-validated readers (the lossy rings), which
+ * copy bytes the producer may be overwriting and throw the copy away if a
+ * fence-ordered check says it was torn. Kept out of line so that tsan.supp
+ * can suppress exactly this copy and TSan still checks the rest.
+ */
+__attribute__((noinline, unused))
+static void ring_copy_out_speculative(const ring_buffer_t *rb, size_t pos, uint8_t *dst, size_t len) {
+    ring_copy_out(rb, pos, dst, len);
+}
+
+/*
+ * Free space (producer side) and readable bytes (consumer side) for at least
+ * `len` bytes. The remote index is only re-read, pulling the other core's
+ * cache line, when the cached copy says the operation would fail. A stale
+ * cache is always conservative: the remote side only ever moves forward.
+ */
+static inline size_t ring_writable(ring_buffer_t *rb, size_t head, size_t len) {
+    size_t available = rb->capacity - (head - rb->cached_tail);
+    if (len > available) {
+        rb->cached_tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        available = rb->capacity - (head - rb->cached_tail);
+    }
+    return available;
+}
+
+static inline size_t ring_readable(ring_buffer_t *rb, size_t tail, size_t len) {
+    size_t available = rb->cached_head - tail;
+    if (len > available) {
+        rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+        available = rb->cached_head - tail;
+    }
+    return available;
+}
+
+/*
+ * Consumer side: warm the cache with already-published bytes starting at
+ * counter `pos`, up to RING_PREFETCH_BYTES or the cached head.
+ */
+static inline void ring_prefetch_from(const ring_buffer_t *rb, size_t pos) {
+    size_t n = rb->cached_head - pos;
+    if (n > RING_PREFETCH_BYTES) n = RING_PREFETCH_BYTES;
+    for (size_t off = 0; off < n; off += CACHE_LINE) {
+        __builtin_prefetch(rb->data + ((pos + off) & rb->mask), 0, 0);
+    }
+}
+
+/* ring_push() with explicit RING_HINT_* flags instead of the ring's defaults */
+bool ring_push_hint(ring_buffer_t *rb, uint8_t *src, size_t len, unsigned hints) {
     size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
-    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
-    
-    size_t available = (tail - head - 1) & (BUFFER_SIZE - 1);
-    if (len > available) return false;
-    
-    // Zero-copy: write directly into the ring buffer
-    for (size_t i = 0; i < len; i++) {
-        rb->data[(head + i) & (BUFFER_SIZE - 1)] = src[i];
+
+    if (len > ring_writable(rb, head, len)) {
+        RING_STATS_FAIL(rb, producer);
+        return false;
     }
-    
-    atomic_store_explicit(&rb->head, 
-                         (head + len) & (BUFFER_SIZE - 1), 
-                         memory_order_release);
+
+    ring_copy_in_hint(rb, head & rb->mask, src, len, hints);
+
+    atomic_store_explicit(&rb->head, head + len, memory_order_release);
+    RING_STATS_OK(rb, producer, len, head + len - rb->cached_tail);
     return true;
 }
 
-bool ring_pop(ring_buffer_t *rb, uint8_t *dst, size_t len) {
+bool ring_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    return ring_push_hint(rb, src, len, rb->hints);
+}
+
+/* ring_pop() with explicit RING_HINT_* flags instead of the ring's defaults */
+bool ring_pop_hint(ring_buffer_t *rb, uint8_t *dst, size_t len, unsigned hints) {
     size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (len > ring_readable(rb, tail, len)) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+
+    ring_copy_out(rb, tail & rb->mask, dst, len);
+    if (hints & RING_HINT_PREFETCH) ring_prefetch_from(rb, tail + len);
+
+    atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+    RING_STATS_OK(rb, consumer, len, rb->cached_head - (tail + len));
+    return true;
+}
+
+bool ring_pop(ring_buffer_t *rb, uint8_t *dst, size_t len) {
+    return ring_pop_hint(rb, dst, len, rb->hints);
+}
+
+/* ============ Monitoring ============ */
+
+/*
+ * Cheap telemetry from any thread. The counters never wrap back to zero on a
+ * lap, so they double as "bytes ever written / read" modulo SIZE_MAX + 1
+ * (every 4 GiB on 32-bit targets; difference two samples to get a rate), and
+ * the fill level is their difference. Values are a snapshot and may be stale
+ * by the time the caller looks at them.
+ */
+size_t ring_bytes_written(const ring_buffer_t *rb) {
+    return atomic_load_explicit(&rb->head, memory_order_acquire);
+}
+
+size_t ring_bytes_read(const ring_buffer_t *rb) {
+    return atomic_load_explicit(&rb->tail, memory_order_acquire);
+}
+
+/* Bytes pushed but not yet popped; tail is read first so this never underflows */
+size_t ring_used(const ring_buffer_t *rb) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
     size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
-    
-    size_t available = (head - tail) & (BUFFER_SIZE - 1);
-    if (len > available) return false;
-    
-    // Zero-copy: read directly from ring buffer
-    for (size_t i = 0; i < len; i++) {
-        dst[i] = rb->data[(tail + i) & (BUFFER_SIZE - 1)];
+    return head - tail;
+}
+
+/* ============ Instrumentation Snapshot ============ */
+
+typedef struct {
+    size_t ops;
+    size_t failed;
+    size_t bytes;
+    size_t high_water;
+    size_t occupancy[RING_STATS_BUCKETS];   /* [i]: fill level in [i/8, (i+1)/8) of capacity; full lands in the last */
+} ring_side_snapshot_t;
+
+typedef struct {
+    ring_side_snapshot_t producer;
+    ring_side_snapshot_t consumer;
+} ring_stats_t;
+
+#ifdef RING_STATS
+static void ring_side_snapshot(const ring_side_stats_t *st, ring_side_snapshot_t *out) {
+    out->ops = atomic_load_explicit(&st->ops, memory_order_relaxed);
+    out->failed = atomic_load_explicit(&st->failed, memory_order_relaxed);
+    out->bytes = atomic_load_explicit(&st->bytes, memory_order_relaxed);
+    out->high_water = atomic_load_explicit(&st->high_water, memory_order_relaxed);
+    for (size_t i = 0; i < RING_STATS_BUCKETS; i++) {
+        out->occupancy[i] = atomic_load_explicit(&st->occupancy[i], memory_order_relaxed);
+    }
+}
+#endif
+
+/*
+ * Copy both sides' counters into `out`. Safe to call from any thread while
+ * the ring is in use; each counter is read atomically, but the set is not a
+ * single consistent cut. Returns false (and zeroes `out`) when the ring was
+ * built without RING_STATS.
+ */
+bool ring_stats_snapshot(const ring_buffer_t *rb, ring_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+#ifdef RING_STATS
+    ring_side_snapshot(&rb->producer_stats, &out->producer);
+    ring_side_snapshot(&rb->consumer_stats, &out->consumer);
+    return true;
+#else
+    (void)rb;
+    return false;
+#endif
+}
+
+/* ============ Batched Push/Pop ============ */
+
+/* One message in a batch: `len` bytes at `base` */
+typedef struct {
+    uint8_t *base;
+    size_t len;
+} ring_iovec_t;
+
+/*
+ * Push up to `count` messages, each all-or-nothing, and publish the new head
+ * once for the whole batch. Returns the number of messages pushed; it stops
+ * at the first message that does not fit, so the result is always a prefix.
+ */
+size_t ring_push_batch(ring_buffer_t *rb, const ring_iovec_t *iov, size_t count) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) total += iov[i].len;
+    size_t available = ring_writable(rb, head, total);
+
+    size_t pos = head;
+    size_t n = 0;
+    for (; n < count && iov[n].len <= available; n++) {
+        ring_copy_in(rb, pos & rb->mask, iov[n].base, iov[n].len);
+        pos += iov[n].len;
+        available -= iov[n].len;
+    }
+
+    if (n > 0) {
+        atomic_store_explicit(&rb->head, pos, memory_order_release);
+        RING_STATS_OK(rb, producer, pos - head, pos - rb->cached_tail);
+    } else if (count > 0) {
+        RING_STATS_FAIL(rb, producer);
+    }
+    return n;
+}
+
+/*
+ * Pop up to `count` messages of exactly iov[i].len bytes each into
+ * iov[i].base, publishing the new tail once. Returns the number popped.
+ */
+size_t ring_pop_batch(ring_buffer_t *rb, const ring_iovec_t *iov, size_t count) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) total += iov[i].len;
+    size_t available = ring_readable(rb, tail, total);
+
+    size_t pos = tail;
+    size_t n = 0;
+    for (; n < count && iov[n].len <= available; n++) {
+        ring_copy_out(rb, pos & rb->mask, iov[n].base, iov[n].len);
+        pos += iov[n].len;
+        available -= iov[n].len;
+    }
+
+    if (n > 0) {
+        atomic_store_explicit(&rb->tail, pos, memory_order_release);
+        RING_STATS_OK(rb, consumer, pos - tail, rb->cached_head - pos);
+    } else if (count > 0) {
+        RING_STATS_FAIL(rb, consumer);
+    }
+    return n;
+}
+
+/* ============ Producer Write Combining ============ */
+
+/*
+ * Staged pushes copy straight into ring space past `head` but leave `head`
+ * alone, so a run of small pushes costs one release store (and one transfer
+ * of the producer's cache line to the consumer) instead of one each. The
+ * staged bytes are published together when ring_set_coalesce()'s byte or
+ * message threshold is reached, on ring_flush(), or when a push doesn't fit
+ * (so a consumer is never left waiting on data that can make room).
+ *
+ * The consumer sees nothing until a publish; a producer that may go idle
+ * must ring_flush(). Other producer calls (ring_push, batches, reserve,
+ * framing) don't know about staged bytes: ring_flush() before using them.
+ */
+
+/*
+ * Publish once `max_bytes` are staged or after `max_msgs` staged pushes; 0
+ * disables that limit (with both 0 only ring_flush() and a full ring
+ * publish). Producer only.
+ */
+void ring_set_coalesce(ring_buffer_t *rb, size_t max_bytes, size_t max_msgs) {
+    rb->flush_bytes = max_bytes;
+    rb->flush_msgs = max_msgs;
+}
+
+/* Publish everything staged so far. Producer only; a no-op if nothing is staged */
+void ring_flush(ring_buffer_t *rb) {
+    if (rb->staged == 0) return;
+
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed) + rb->staged;
+    atomic_store_explicit(&rb->head, head, memory_order_release);
+    RING_STATS_OK(rb, producer, rb->staged, head - rb->cached_tail);
+    rb->staged = 0;
+    rb->staged_msgs = 0;
+}
+
+/* Bytes written by ring_push_staged() that the consumer can't see yet */
+size_t ring_staged(const ring_buffer_t *rb) {
+    return rb->staged;
+}
+
+/*
+ * Like ring_push(), but the bytes are only staged; see above for when they
+ * become visible. Returns false, after publishing whatever was staged, if
+ * `len` bytes don't fit.
+ */
+bool ring_push_staged(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    size_t pos = atomic_load_explicit(&rb->head, memory_order_relaxed) + rb->staged;
+
+    if (len > ring_writable(rb, pos, len)) {
+        ring_flush(rb);
+        RING_STATS_FAIL(rb, producer);
+        return false;
+    }
+
+    ring_copy_in(rb, pos & rb->mask, src, len);
+    rb->staged += len;
+    rb->staged_msgs++;
+
+    if ((rb->flush_bytes != 0 && rb->staged >= rb->flush_bytes) ||
+        (rb->flush_msgs != 0 && rb->staged_msgs >= rb->flush_msgs)) {
+        ring_flush(rb);
+    }
+    return true;
+}
+
+/* ============ Zero-Copy Reserve/Commit and Peek/Release ============ */
+
+/*
+ * A region inside the ring. Regions that straddle the wrap point are
+ * reported as two segments (never on a mirrored ring); `second` is NULL
+ * when the region is contiguous.
+ */
+typedef struct {
+    uint8_t *first;
+    size_t first_len;
+    uint8_t *second;
+    size_t second_len;
+} ring_span_t;
+
+static inline void ring_span_at(const ring_buffer_t *rb, size_t pos, size_t len, ring_span_t *span) {
+    size_t first = rb->capacity - pos;
+    span->first = rb->data + pos;
+    if (len <= first || rb->mirrored) {
+        span->first_len = len;
+        span->second = NULL;
+        span->second_len = 0;
+    } else {
+        span->first_len = first;
+        span->second = rb->data;
+        span->second_len = len - first;
+    }
+}
+
+/*
+ * Producer: expose `len` writable bytes inside the ring without publishing
+ * them. Returns false if there is not enough free space. Fill the span in
+ * place, then call ring_commit() with at most `len` bytes.
+ */
+bool ring_reserve(ring_buffer_t *rb, size_t len, ring_span_t *span) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    if (len > ring_writable(rb, head, len)) {
+        RING_STATS_FAIL(rb, producer);
+        return false;
+    }
+
+    ring_span_at(rb, head & rb->mask, len, span);
+    return true;
+}
+
+/*
+ * Producer: like ring_reserve(), but only succeeds when the `len` bytes are
+ * contiguous, i.e. do not cross the wrap point. Returns NULL otherwise.
+ */
+uint8_t *ring_reserve_contiguous(ring_buffer_t *rb, size_t len) {
+    ring_span_t span;
+    if (!ring_reserve(rb, len, &span) || span.second != NULL) return NULL;
+    return span.first;
+}
+
+/* Producer: publish `len` bytes written through the last reservation */
+void ring_commit(ring_buffer_t *rb, size_t len) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    atomic_store_explicit(&rb->head, head + len, memory_order_release);
+    RING_STATS_OK(rb, producer, len, head + len - rb->cached_tail);
+}
+
+/*
+ * Consumer: expose the next `len` readable bytes in place without consuming
+ * them. Returns false if fewer than `len` bytes are available. Call
+ * ring_release() once done with (a prefix of) the span.
+ */
+bool ring_peek(ring_buffer_t *rb, size_t len, ring_span_t *span) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (len > ring_readable(rb, tail, len)) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+
+    ring_span_at(rb, tail & rb->mask, len, span);
+    return true;
+}
+
+/* Consumer: hand `len` peeked bytes back to the producer */
+void ring_release(ring_buffer_t *rb, size_t len) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+    RING_STATS_OK(rb, consumer, len, rb->cached_head - (tail + len));
+}
+
+/* ============ Draining Everything Readable ============ */
+
+/*
+ * Consumer: copy out everything readable, up to `max` bytes, and publish the
+ * tail once. The producer's counter is only re-read when the cached copy
+ * shows less than `max`, so one acquire load picks up a whole backlog: the
+ * further the consumer falls behind, the bigger its batches get. Returns
+ * the number of bytes popped, 0 if the ring is empty.
+ */
+size_t ring_pop_available(ring_buffer_t *rb, uint8_t *dst, size_t max) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    size_t n = ring_readable(rb, tail, max);
+    if (n > max) n = max;
+    if (n == 0) {
+        RING_STATS_FAIL(rb, consumer);
+        return 0;
+    }
+
+    ring_copy_out(rb, tail & rb->mask, dst, n);
+
+    atomic_store_explicit(&rb->tail, tail + n, memory_order_release);
+    RING_STATS_OK(rb, consumer, n, rb->cached_head - (tail + n));
+    return n;
+}
+
+/*
+ * ring_drain() callback: process the region in `span` in place and return
+ * how many bytes from its start were consumed (at most the span's total).
+ * Returning less leaves the rest, e.g. a partial record, for next time.
+ */
+typedef size_t (*ring_drain_fn_t)(const ring_span_t *span, void *ctx);
+
+/*
+ * Consumer: zero-copy ring_pop_available(). Everything readable, up to
+ * `max` bytes, goes to `fn` as one or two segments; the tail is then
+ * published once for whatever `fn` consumed. Returns that byte count, 0 if
+ * the ring was empty (`fn` is not called) or `fn` consumed nothing.
+ */
+size_t ring_drain(ring_buffer_t *rb, size_t max, ring_drain_fn_t fn, void *ctx) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    size_t n = ring_readable(rb, tail, max);
+    if (n > max) n = max;
+    if (n == 0) {
+        RING_STATS_FAIL(rb, consumer);
+        return 0;
+    }
+
+    ring_span_t span;
+    ring_span_at(rb, tail & rb->mask, n, &span);
+    size_t consumed = fn(&span, ctx);
+    if (consumed > n) consumed = n;
+
+    if (consumed > 0) {
+        atomic_store_explicit(&rb->tail, tail + consumed, memory_order_release);
+        RING_STATS_OK(rb, consumer, consumed, rb->cached_head - (tail + consumed));
+    }
+    return consumed;
+}
+
+/* ============ Length-Prefixed Message Framing ============ */
+
+/*
+ * Framed messages carry a 4-byte length header and are padded to a 4-byte
+ * boundary, so a header is never split by the wrap point. A header equal to
+ * RING_MSG_PAD marks filler up to the end of the data region, written by
+ * ring_push_msg_contiguous() so that whole frames never wrap. Producer and
+ * consumer publish header and payload together, so once a header is visible
+ * the full frame is too. Don't mix framed and raw calls on the same ring.
+ */
+#define RING_MSG_HEADER sizeof(uint32_t)
+#define RING_MSG_PAD UINT32_MAX
+
+static inline size_t ring_msg_frame_size(size_t len) {
+    return (RING_MSG_HEADER + len + (RING_MSG_HEADER - 1)) & ~(RING_MSG_HEADER - 1);
+}
+
+static bool ring_push_frame(ring_buffer_t *rb, const uint8_t *src, size_t len, bool contiguous) {
+    if (len >= RING_MSG_PAD) return false;
+
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t frame = ring_msg_frame_size(len);
+    size_t to_end = rb->capacity - (head & rb->mask);
+    bool may_pad = contiguous && !rb->mirrored;
+    size_t pad = (may_pad && frame > to_end) ? to_end : 0;
+
+    /* Padding is under one frame, so up to capacity / 2 always fits once drained */
+    if (may_pad && frame > rb->capacity / 2) return false;
+
+    if (pad + frame > ring_writable(rb, head, pad + frame)) {
+        RING_STATS_FAIL(rb, producer);
+        return false;
+    }
+
+    if (pad > 0) {
+        uint32_t marker = RING_MSG_PAD;
+        memcpy(rb->data + (head & rb->mask), &marker, RING_MSG_HEADER);
+        head += pad;
     }
-    
-    atomic_store_explicit(&rb->tail, 
-                         (tail + len) & (BUFFER_SIZE - 1), 
-                         memory_order_release);
+
+    uint32_t header = (uint32_t)len;
+    memcpy(rb->data + (head & rb->mask), &header, RING_MSG_HEADER);
+    ring_copy_in(rb, (head + RING_MSG_HEADER) & rb->mask, src, len);
+
+    atomic_store_explicit(&rb->head, head + frame, memory_order_release);
+    RING_STATS_OK(rb, producer, len, head + frame - rb->cached_tail);
     return true;
 }
+
+/* Push one framed message; its payload may straddle the wrap point */
+bool ring_push_msg(ring_buffer_t *rb, const uint8_t *src, size_t len) {
+    return ring_push_frame(rb, src, len, false);
+}
+
+/*
+ * Push one framed message, padding to the start of the data region if the
+ * frame would otherwise wrap, so ring_peek_msg() always returns a single
+ * segment for it. Costs up to one frame's worth of space per lap.
+ *
+ * Frames (payload plus header, rounded up to 4 bytes) larger than half the
+ * capacity are always rejected: at some head offsets the padding plus the
+ * frame exceeds the capacity, so the push could never succeed. Mirrored
+ * rings never pad and have no such limit.
+ */
+bool ring_push_msg_contiguous(ring_buffer_t *rb, const uint8_t *src, size_t len) {
+    return ring_push_frame(rb, src, len, true);
+}
+
+/*
+ * Locate the next frame for the consumer, skipping padding. Returns false if
+ * no message is available; otherwise sets `*pos` to the counter value of its
+ * header and `*len` to its payload length.
+ */
+static bool ring_next_frame(ring_buffer_t *rb, size_t *pos, size_t *len) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    if (ring_readable(rb, tail, RING_MSG_HEADER) < RING_MSG_HEADER) return false;
+
+    uint32_t header;
+    memcpy(&header, rb->data + (tail & rb->mask), RING_MSG_HEADER);
+    if (header == RING_MSG_PAD) {
+        /* Padding is always published together with the frame after it */
+        tail += rb->capacity - (tail & rb->mask);
+        memcpy(&header, rb->data, RING_MSG_HEADER);
+    }
+
+    *pos = tail;
+    *len = header;
+    return true;
+}
+
+/*
+ * Pop one framed message into `dst` (room for `cap` bytes) and store its
+ * length in `*len`. Returns false if the ring holds no message, or if the
+ * message is larger than `cap`; in that case it stays in the ring and `*len`
+ * reports the size needed.
+ */
+bool ring_pop_msg(ring_buffer_t *rb, uint8_t *dst, size_t cap, size_t *len) {
+    size_t pos;
+    if (!ring_next_frame(rb, &pos, len) || *len > cap) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+
+    ring_copy_out(rb, (pos + RING_MSG_HEADER) & rb->mask, dst, *len);
+
+    size_t tail = pos + ring_msg_frame_size(*len);
+    atomic_store_explicit(&rb->tail, tail, memory_order_release);
+    RING_STATS_OK(rb, consumer, *len, rb->cached_head - tail);
+    return true;
+}
+
+/*
+ * Expose the payload of the next framed message in place. The span has a
+ * single segment unless the frame was pushed with ring_push_msg() and wraps.
+ * Call ring_release_msg() when done with it.
+ */
+bool ring_peek_msg(ring_buffer_t *rb, ring_span_t *span) {
+    size_t pos, len;
+    if (!ring_next_frame(rb, &pos, &len)) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+
+    ring_span_at(rb, (pos + RING_MSG_HEADER) & rb->mask, len, span);
+    return true;
+}
+
+/* Consume the message returned by the last ring_peek_msg() */
+void ring_release_msg(ring_buffer_t *rb) {
+    size_t pos, len;
+    if (!ring_next_frame(rb, &pos, &len)) return;
+
+    size_t tail = pos + ring_msg_frame_size(len);
+    atomic_store_explicit(&rb->tail, tail, memory_order_release);
+    RING_STATS_OK(rb, consumer, len, rb->cached_head - tail);
+}
+
+#endif /* RING_BUFFER_C */
@@ -0,0 +1,149 @@
+#ifndef RING_CLOCK_C
+#define RING_CLOCK_C
+
+#include "ring_buffer.c"
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+/*
+ * Cheap timestamps for latency measurement.
+ *
+ * clock_gettime() costs about 20 ns even through the vDSO, which is the same
+ * order as an SPSC hand-off. The cycle counter is a single instruction:
+ * rdtsc on x86 (when the TSC is invariant, i.e. constant rate and synced
+ * across cores) and cntvct_el0 on AArch64. ring_clock_init() picks a source
+ * and calibrates it against CLOCK_MONOTONIC. Timestamps are raw ticks, so
+ * callers carry ticks in messages and only convert deltas (or histogram
+ * percentiles) to ns off the hot path.
+ *
+ * CLOCK_MONOTONIC stays available as the portable fallback; with it, ticks
+ * are nanoseconds.
+ */
+typedef enum {
+    RING_CLOCK_AUTO,        /* Cycle counter if usable, else monotonic */
+    RING_CLOCK_CYCLES,      /* rdtsc / cntvct_el0 */
+    RING_CLOCK_MONOTONIC    /* clock_gettime(CLOCK_MONOTONIC) */
+} ring_clock_source_t;
+
+typedef struct {
+    ring_clock_source_t source;     /* Never RING_CLOCK_AUTO after init */
+    double ns_per_tick;
+} ring_clock_t;
+
+#define RING_CLOCK_CALIBRATE_NS 20000000ULL     /* 20 ms calibration window */
+
+static inline uint64_t ring_clock_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Raw cycle counter; only meaningful if ring_clock_has_cycles() */
+static inline uint64_t ring_clock_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Like ring_clock_cycles(), but not executed until every earlier instruction
+ * has finished (rdtscp / isb), so the timestamp can't be taken early. Use it
+ * for the end of a measured interval.
+ */
+static inline uint64_t ring_clock_cycles_ordered(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned aux;
+    return __builtin_ia32_rdtscp(&aux);
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(v) :: "memory");
+    return v;
+#else
+    return 0;
+#endif
+}
+
+bool ring_clock_has_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    /* Invariant TSC: CPUID.80000007H:EDX[8]; rdtscp: CPUID.80000001H:EDX[27] */
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1U << 8))) return false;
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) || !(edx & (1U << 27))) return false;
+    return true;
+#elif defined(__aarch64__)
+    return true;    /* The generic timer is architecturally constant-rate */
+#else
+    return false;
+#endif
+}
+
+/*
+ * Select `source` and calibrate it. RING_CLOCK_AUTO falls back to the
+ * monotonic clock; an explicit RING_CLOCK_CYCLES returns false if the cycle
+ * counter is missing or not invariant. Calibration busy-waits for
+ * RING_CLOCK_CALIBRATE_NS on x86; AArch64 reads the counter frequency.
+ */
+bool ring_clock_init(ring_clock_t *c, ring_clock_source_t source) {
+    c->source = RING_CLOCK_MONOTONIC;
+    c->ns_per_tick = 1.0;
+    if (source == RING_CLOCK_MONOTONIC) return true;
+
+    if (!ring_clock_has_cycles()) return source == RING_CLOCK_AUTO;
+
+#if defined(__aarch64__)
+    uint64_t freq;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+    if (freq == 0) return source == RING_CLOCK_AUTO;
+    c->ns_per_tick = 1e9 / (double)freq;
+#else
+    uint64_t ns_start = ring_clock_monotonic_ns();
+    uint64_t ticks_start = ring_clock_cycles_ordered();
+    uint64_t ns_end;
+    do {
+        ns_end = ring_clock_monotonic_ns();
+    } while (ns_end - ns_start < RING_CLOCK_CALIBRATE_NS);
+    uint64_t ticks_end = ring_clock_cycles_ordered();
+
+    if (ticks_end <= ticks_start) return source == RING_CLOCK_AUTO;
+    c->ns_per_tick = (double)(ns_end - ns_start) / (double)(ticks_end - ticks_start);
+#endif
+
+    c->source = RING_CLOCK_CYCLES;
+    return true;
+}
+
+/* Current time in ticks of the selected source */
+static inline uint64_t ring_clock_now(const ring_clock_t *c) {
+    return c->source == RING_CLOCK_CYCLES ? ring_clock_cycles() : ring_clock_monotonic_ns();
+}
+
+/* Current time, ordered after all earlier instructions (for interval ends) */
+static inline uint64_t ring_clock_now_ordered(const ring_clock_t *c) {
+    return c->source == RING_CLOCK_CYCLES ? ring_clock_cycles_ordered() : ring_clock_monotonic_ns();
+}
+
+/* Convert a tick count (usually a delta) to nanoseconds */
+static inline uint64_t ring_clock_to_ns(const ring_clock_t *c, uint64_t ticks) {
+    return c->source == RING_CLOCK_CYCLES ? (uint64_t)((double)ticks * c->ns_per_tick) : ticks;
+}
+
+const char *ring_clock_name(const ring_clock_t *c) {
+    if (c->source == RING_CLOCK_MONOTONIC) return "CLOCK_MONOTONIC";
+#if defined(__aarch64__)
+    return "cntvct_el0";
+#else
+    return "rdtsc";
+#endif
+}
+
+#endif /* RING_CLOCK_C */
@@ -0,0 +1,137 @@
+#ifndef RING_HIST_C
+#define RING_HIST_C
+
+#include "ring_buffer.c"
+
+/*
+ * Fixed-memory log-linear histogram for hot-path latency tracking, in the
+ * style of HdrHistogram.
+ *
+ * Values below 2^RING_HIST_SUB_BITS get a bucket each. Above that, every
+ * power-of-two range is split into 2^(RING_HIST_SUB_BITS - 1) linear
+ * sub-buckets, so any recorded value is known to within 1 part in 128
+ * across the whole uint64_t range. Recording is a clz, a shift and one
+ * counter bump, with no allocation, so it is cheap enough to do inline in a
+ * consumer loop for hundreds of millions of samples.
+ *
+ * One thread records. As with the RING_STATS counters, each counter has a
+ * single writer and is updated with a relaxed load and store, so other
+ * threads may query or merge a histogram while it is being recorded into.
+ * The result is not a consistent cut, but every counter is read whole.
+ */
+#define RING_HIST_SUB_BITS 8
+#define RING_HIST_HALF (1U << (RING_HIST_SUB_BITS - 1))
+#define RING_HIST_BUCKETS ((64 - RING_HIST_SUB_BITS + 2) * RING_HIST_HALF)
+
+typedef struct {
+    _Atomic uint64_t counts[RING_HIST_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t min;
+    _Atomic uint64_t max;
+    _Atomic uint64_t sum;       /* Wraps only after ~584 years of nanoseconds */
+} ring_hist_t;
+
+static inline void ring_hist_bump(_Atomic uint64_t *counter, uint64_t n) {
+    atomic_store_explicit(counter,
+                          atomic_load_explicit(counter, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+static inline size_t ring_hist_index(uint64_t value) {
+    if (value < (1U << RING_HIST_SUB_BITS)) return (size_t)value;
+
+    /* Shift so the value keeps RING_HIST_SUB_BITS significant bits */
+    unsigned shift = 64 - RING_HIST_SUB_BITS - (unsigned)__builtin_clzll(value);
+    return (size_t)shift * RING_HIST_HALF + (size_t)(value >> shift);
+}
+
+/* Highest value that maps to bucket `index` */
+static inline uint64_t ring_hist_bucket_high(size_t index) {
+    if (index < (1U << RING_HIST_SUB_BITS)) return index;
+
+    unsigned shift = (unsigned)(index / RING_HIST_HALF) - 1;
+    uint64_t sub = index % RING_HIST_HALF + RING_HIST_HALF;
+    return ((sub + 1) << shift) - 1;
+}
+
+void ring_hist_init(ring_hist_t *h) {
+    for (size_t i = 0; i < RING_HIST_BUCKETS; i++) atomic_init(&h->counts[i], 0);
+    atomic_init(&h->total, 0);
+    atomic_init(&h->min, UINT64_MAX);
+    atomic_init(&h->max, 0);
+    atomic_init(&h->sum, 0);
+}
+
+/* Recording thread only */
+static inline void ring_hist_record(ring_hist_t *h, uint64_t value) {
+    ring_hist_bump(&h->counts[ring_hist_index(value)], 1);
+    ring_hist_bump(&h->total, 1);
+    ring_hist_bump(&h->sum, value);
+    if (value < atomic_load_explicit(&h->min, memory_order_relaxed)) {
+        atomic_store_explicit(&h->min, value, memory_order_relaxed);
+    }
+    if (value > atomic_load_explicit(&h->max, memory_order_relaxed)) {
+        atomic_store_explicit(&h->max, value, memory_order_relaxed);
+    }
+}
+
+uint64_t ring_hist_count(const ring_hist_t *h) {
+    return atomic_load_explicit(&h->total, memory_order_relaxed);
+}
+
+uint64_t ring_hist_min(const ring_hist_t *h) {
+    return ring_hist_count(h) == 0 ? 0 : atomic_load_explicit(&h->min, memory_order_relaxed);
+}
+
+uint64_t ring_hist_max(const ring_hist_t *h) {
+    return atomic_load_explicit(&h->max, memory_order_relaxed);
+}
+
+double ring_hist_mean(const ring_hist_t *h) {
+    uint64_t n = ring_hist_count(h);
+    if (n == 0) return 0.0;
+    return (double)atomic_load_explicit(&h->sum, memory_order_relaxed) / (double)n;
+}
+
+/*
+ * Value at `percentile` (0-100): the highest value in the bucket holding
+ * that rank, capped at the recorded maximum, so it never under-reports by
+ * more than the bucket width. Returns 0 for an empty histogram.
+ */
+uint64_t ring_hist_percentile(const ring_hist_t *h, double percentile) {
+    uint64_t n = ring_hist_count(h);
+    if (n == 0) return 0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)n + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < RING_HIST_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t high = ring_hist_bucket_high(i);
+            uint64_t max = ring_hist_max(h);
+            return high < max ? high : max;
+        }
+    }
+    return ring_hist_max(h);
+}
+
+/* Add `src` into `dst`; `dst` must not be recorded into concurrently */
+void ring_hist_merge(ring_hist_t *dst, const ring_hist_t *src) {
+    for (size_t i = 0; i < RING_HIST_BUCKETS; i++) {
+        ring_hist_bump(&dst->counts[i], atomic_load_explicit(&src->counts[i], memory_order_relaxed));
+    }
+    ring_hist_bump(&dst->total, ring_hist_count(src));
+    ring_hist_bump(&dst->sum, atomic_load_explicit(&src->sum, memory_order_relaxed));
+
+    uint64_t min = atomic_load_explicit(&src->min, memory_order_relaxed);
+    if (min < atomic_load_explicit(&dst->min, memory_order_relaxed)) {
+        atomic_store_explicit(&dst->min, min, memory_order_relaxed);
+    }
+    uint64_t max = ring_hist_max(src);
+    if (max > ring_hist_max(dst)) atomic_store_explicit(&dst->max, max, memory_order_relaxed);
+}
+
+#endif /* RING_HIST_C */
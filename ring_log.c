@@ -0,0 +1,741 @@
+#ifndef RING_LOG_C
+#define RING_LOG_C
+
+#include "ring_buffer.c"
+#include "ring_clock.c"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/*
+ * Asynchronous binary logger / flight recorder.
+ *
+ * Each logging thread gets its own SPSC ring (ring_log_writer()). A log call
+ * does no formatting: it takes a cycle-counter timestamp and copies the
+ * format id and the raw argument values into the thread's ring as one
+ * record. A background drain thread gathers everything readable from every
+ * ring and hands it to the file with one writev() per pass, straight from
+ * ring memory, then releases it. ring_log_decode() turns the file back into
+ * text offline, re-running printf with the registered format strings.
+ *
+ * Formats are registered once, up front (ring_log_format()); the drain
+ * thread writes each definition to the file before any record that uses
+ * it. Supported conversions are the printf integer, floating-point, %c, %s
+ * and %p conversions with flags, width and precision (but not `*`), plus
+ * %%. Strings are copied into the record, truncated so a record stays
+ * within RING_LOG_MAX_RECORD bytes.
+ *
+ * A log call never blocks: if the thread's ring is full the record is
+ * dropped and counted, and the drain thread writes the count to the file
+ * so the decoder can show the gap. The file is in host byte order.
+ *
+ * File layout: ring_log_file_header_t, then blocks, each a ring_log_block_t
+ * followed by `len` payload bytes:
+ *   RING_LOG_DEFINE   id = format id, payload = the format string (no NUL)
+ *   RING_LOG_RECORDS  id = writer, payload = whole records, oldest first
+ *   RING_LOG_DROPPED  id = writer, payload = uint64_t records dropped
+ * A record is a uint16_t total length, a uint16_t format id and a uint64_t
+ * timestamp in clock ticks, then the arguments: 4 bytes for int-sized
+ * integers, 8 for wider integers, doubles and pointers, and a uint16_t
+ * length plus the bytes for strings.
+ */
+#define RING_LOG_MAX_WRITERS 64
+#define RING_LOG_MAX_FORMATS 4096
+#define RING_LOG_MAX_ARGS 16
+#define RING_LOG_MAX_RECORD 512
+#define RING_LOG_MAX_RING (64u << 20)   /* Per-writer ring capacity; also bounds a block */
+#define RING_LOG_RECORD_HEADER 12
+#define RING_LOG_IDLE_US 1000           /* Drain thread sleep when every ring is empty */
+
+#define RING_LOG_MAGIC 0x474f4c52u      /* "RLOG" in memory on little-endian hosts */
+#define RING_LOG_VERSION 1
+
+typedef enum {
+    RING_LOG_ARG_NONE,      /* %% */
+    RING_LOG_ARG_INT,       /* int and narrower (promoted); 4 bytes */
+    RING_LOG_ARG_LONG,      /* Wider integers, each read as its own type; 8 bytes */
+    RING_LOG_ARG_LLONG,
+    RING_LOG_ARG_SIZE,
+    RING_LOG_ARG_INTMAX,
+    RING_LOG_ARG_PTRDIFF,
+    RING_LOG_ARG_DOUBLE,
+    RING_LOG_ARG_PTR,
+    RING_LOG_ARG_STR
+} ring_log_arg_t;
+
+enum {
+    RING_LOG_DEFINE = 1,
+    RING_LOG_RECORDS = 2,
+    RING_LOG_DROPPED = 3
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t start;             /* Clock ticks at ring_log_open() */
+    double ns_per_tick;
+} ring_log_file_header_t;
+
+typedef struct {
+    uint32_t type;              /* RING_LOG_DEFINE / RECORDS / DROPPED */
+    uint32_t len;               /* Payload bytes that follow */
+    uint32_t id;
+} ring_log_block_t;
+
+typedef struct {
+    const char *fmt;            /* Caller's string; must outlive the logger */
+    size_t fixed;               /* Record bytes besides string contents */
+    size_t num_args;
+    uint8_t args[RING_LOG_MAX_ARGS];
+} ring_log_format_t;
+
+typedef struct ring_log ring_log_t;
+
+typedef struct {
+    ring_buffer_t ring;
+    ring_log_t *lg;
+    uint32_t id;
+    _Atomic uint64_t dropped;   /* Logging thread only writes */
+    uint64_t reported;          /* Drain thread: drops already in the file */
+} ring_log_writer_t;
+
+struct ring_log {
+    int fd;
+    size_t ring_capacity;
+    ring_clock_t clock;
+    pthread_t thread;
+    atomic_bool stop;
+    atomic_bool failed;         /* A write to `fd` failed; data since is lost */
+
+    pthread_mutex_t lock;       /* Registration only */
+    atomic_size_t num_formats;
+    atomic_size_t num_writers;
+    ring_log_format_t formats[RING_LOG_MAX_FORMATS];
+    ring_log_writer_t *writers[RING_LOG_MAX_WRITERS];
+
+    size_t formats_written;     /* Drain thread only */
+};
+
+/* ============ Format Strings ============ */
+
+typedef struct {
+    ring_log_arg_t type;
+    char conv;
+    size_t prefix;              /* "%", flags, width and precision */
+    size_t len;                 /* The whole conversion */
+} ring_log_spec_t;
+
+/* Parse the conversion starting at the '%' in `p`; false if unsupported */
+static bool ring_log_parse_spec(const char *p, ring_log_spec_t *spec) {
+    const char *q = p + 1;
+
+    if (*q == '%') {
+        spec->type = RING_LOG_ARG_NONE;
+        spec->conv = '%';
+        spec->prefix = spec->len = 2;
+        return true;
+    }
+
+    while (*q != '\0' && strchr("-+ #0", *q) != NULL) q++;
+    while (*q >= '0' && *q <= '9') q++;
+    if (*q == '.') {
+        q++;
+        while (*q >= '0' && *q <= '9') q++;
+    }
+    spec->prefix = (size_t)(q - p);
+
+    ring_log_arg_t wide = RING_LOG_ARG_INT;
+    if (q[0] == 'h') {
+        q += q[1] == 'h' ? 2 : 1;
+    } else if (q[0] == 'l' && q[1] == 'l') {
+        wide = RING_LOG_ARG_LLONG;
+        q += 2;
+    } else if (q[0] == 'l') {
+        wide = RING_LOG_ARG_LONG;
+        q++;
+    } else if (q[0] == 'z') {
+        wide = RING_LOG_ARG_SIZE;
+        q++;
+    } else if (q[0] == 'j') {
+        wide = RING_LOG_ARG_INTMAX;
+        q++;
+    } else if (q[0] == 't') {
+        wide = RING_LOG_ARG_PTRDIFF;
+        q++;
+    }
+    bool modified = (size_t)(q - p) != spec->prefix;
+
+    char c = *q;
+    if (c == '\0') return false;
+    if (strchr("diouxX", c) != NULL) {
+        spec->type = wide;
+    } else if (strchr("feEgGaA", c) != NULL && (!modified || wide == RING_LOG_ARG_LONG)) {
+        spec->type = RING_LOG_ARG_DOUBLE;
+    } else if (c == 'c' && !modified) {
+        spec->type = RING_LOG_ARG_INT;
+    } else if (c == 's' && !modified) {
+        spec->type = RING_LOG_ARG_STR;
+    } else if (c == 'p' && !modified) {
+        spec->type = RING_LOG_ARG_PTR;
+    } else {
+        return false;   /* %n, `*` widths, %Lf, %ls, ... */
+    }
+    spec->conv = c;
+    spec->len = (size_t)(q + 1 - p);
+    return true;
+}
+
+/* Encoded size of a fixed-width argument (strings: their length prefix) */
+static size_t ring_log_arg_size(ring_log_arg_t type) {
+    switch (type) {
+    case RING_LOG_ARG_NONE: return 0;
+    case RING_LOG_ARG_INT: return 4;
+    case RING_LOG_ARG_STR: return 2;
+    default: return 8;
+    }
+}
+
+static bool ring_log_parse_format(const char *fmt, ring_log_format_t *f) {
+    f->fmt = fmt;
+    f->fixed = RING_LOG_RECORD_HEADER;
+    f->num_args = 0;
+
+    for (const char *p = fmt; *p != '\0'; p++) {
+        if (*p != '%') continue;
+        ring_log_spec_t spec;
+        if (!ring_log_parse_spec(p, &spec)) return false;
+        p += spec.len - 1;
+        if (spec.type == RING_LOG_ARG_NONE) continue;
+
+        if (f->num_args == RING_LOG_MAX_ARGS) return false;
+        f->args[f->num_args++] = (uint8_t)spec.type;
+        f->fixed += ring_log_arg_size(spec.type);
+    }
+    return strlen(fmt) <= UINT32_MAX;
+}
+
+/* ============ Logger ============ */
+
+/* Write all of `iov`, retrying short writes; false on an I/O error */
+static bool ring_log_writev_all(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+/* Drain thread: write definitions registered since the last pass */
+static bool ring_log_write_formats(ring_log_t *lg) {
+    size_t num = atomic_load_explicit(&lg->num_formats, memory_order_acquire);
+
+    while (lg->formats_written < num) {
+        ring_log_block_t blocks[64];
+        struct iovec iov[128];
+        int count = 0;
+
+        for (size_t k = 0; k < 64 && lg->formats_written < num; k++, lg->formats_written++) {
+            const char *fmt = lg->formats[lg->formats_written].fmt;
+            blocks[k] = (ring_log_block_t){ RING_LOG_DEFINE, (uint32_t)strlen(fmt),
+                                            (uint32_t)lg->formats_written };
+            iov[count++] = (struct iovec){ &blocks[k], sizeof(blocks[k]) };
+            iov[count++] = (struct iovec){ (void *)fmt, blocks[k].len };
+        }
+        if (!ring_log_writev_all(lg->fd, iov, count)) return false;
+    }
+    return true;
+}
+
+/*
+ * Drain thread: one pass over every writer. The records go out in one
+ * writev() straight from the rings and are released once written.
+ * Returns the number of record bytes drained.
+ */
+static size_t ring_log_pass(ring_log_t *lg) {
+    ring_log_block_t blocks[2 * RING_LOG_MAX_WRITERS];
+    uint64_t dropped[RING_LOG_MAX_WRITERS];
+    uint64_t drop_total[RING_LOG_MAX_WRITERS];
+    size_t taken[RING_LOG_MAX_WRITERS];
+    struct iovec iov[4 * RING_LOG_MAX_WRITERS];     /* Well under IOV_MAX */
+    int count = 0;
+    size_t bytes = 0;
+
+    size_t num = atomic_load_explicit(&lg->num_writers, memory_order_acquire);
+    for (size_t i = 0; i < num; i++) {
+        ring_log_writer_t *w = lg->writers[i];
+
+        drop_total[i] = atomic_load_explicit(&w->dropped, memory_order_relaxed);
+        if (drop_total[i] != w->reported) {
+            dropped[i] = drop_total[i] - w->reported;
+            blocks[2 * i] = (ring_log_block_t){ RING_LOG_DROPPED, sizeof(dropped[i]), w->id };
+            iov[count++] = (struct iovec){ &blocks[2 * i], sizeof(blocks[2 * i]) };
+            iov[count++] = (struct iovec){ &dropped[i], sizeof(dropped[i]) };
+        }
+
+        ring_span_t span;
+        taken[i] = ring_used(&w->ring);
+        if (taken[i] == 0 || !ring_peek(&w->ring, taken[i], &span)) {
+            taken[i] = 0;
+            continue;
+        }
+        blocks[2 * i + 1] = (ring_log_block_t){ RING_LOG_RECORDS, (uint32_t)taken[i], w->id };
+        iov[count++] = (struct iovec){ &blocks[2 * i + 1], sizeof(blocks[2 * i + 1]) };
+        iov[count++] = (struct iovec){ span.first, span.first_len };
+        if (span.second_len > 0) iov[count++] = (struct iovec){ span.second, span.second_len };
+        bytes += taken[i];
+    }
+    if (count == 0) return 0;
+
+    /*
+     * A record's format was registered before the record was pushed, and
+     * the rings were read above, so this sees every format they use.
+     */
+    bool ok = ring_log_write_formats(lg) && ring_log_writev_all(lg->fd, iov, count);
+    if (!ok) atomic_store_explicit(&lg->failed, true, memory_order_relaxed);
+
+    for (size_t i = 0; i < num; i++) {
+        ring_log_writer_t *w = lg->writers[i];
+        if (taken[i] > 0) ring_release(&w->ring, taken[i]);
+        w->reported = drop_total[i];
+    }
+    return bytes;
+}
+
+static void *ring_log_drain_main(void *arg) {
+    ring_log_t *lg = (ring_log_t *)arg;
+
+    for (;;) {
+        bool stopping = atomic_load_explicit(&lg->stop, memory_order_acquire);
+        if (ring_log_pass(lg) > 0) continue;
+        if (stopping) break;
+        usleep(RING_LOG_IDLE_US);
+    }
+    return NULL;
+}
+
+/*
+ * Start a logger writing to `fd` (a file, pipe or socket the caller opened
+ * and closes after ring_log_close()). Each writer gets a ring of
+ * `ring_capacity` bytes, a power of two from RING_LOG_MAX_RECORD up to
+ * RING_LOG_MAX_RING. Returns false on bad arguments, if the file header
+ * can't be written, or if the drain thread won't start.
+ */
+bool ring_log_open(ring_log_t *lg, int fd, size_t ring_capacity) {
+    if (ring_capacity < RING_LOG_MAX_RECORD || ring_capacity > RING_LOG_MAX_RING ||
+        (ring_capacity & (ring_capacity - 1)) != 0) {
+        return false;
+    }
+
+    memset(lg, 0, sizeof(*lg));
+    lg->fd = fd;
+    lg->ring_capacity = ring_capacity;
+    ring_clock_init(&lg->clock, RING_CLOCK_AUTO);
+    atomic_init(&lg->stop, false);
+    atomic_init(&lg->failed, false);
+    atomic_init(&lg->num_formats, 0);
+    atomic_init(&lg->num_writers, 0);
+
+    ring_log_file_header_t hdr = {
+        .magic = RING_LOG_MAGIC,
+        .version = RING_LOG_VERSION,
+        .start = ring_clock_now(&lg->clock),
+        .ns_per_tick = lg->clock.ns_per_tick
+    };
+    struct iovec iov = { &hdr, sizeof(hdr) };
+    if (!ring_log_writev_all(fd, &iov, 1)) return false;
+
+    if (pthread_mutex_init(&lg->lock, NULL) != 0) return false;
+    if (pthread_create(&lg->thread, NULL, ring_log_drain_main, lg) != 0) {
+        pthread_mutex_destroy(&lg->lock);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Stop the drain thread after it has written everything logged so far and
+ * free the writers. Logging threads must have stopped. Returns false if
+ * any write to the file failed.
+ */
+bool ring_log_close(ring_log_t *lg) {
+    atomic_store_explicit(&lg->stop, true, memory_order_release);
+    pthread_join(lg->thread, NULL);
+
+    size_t num = atomic_load_explicit(&lg->num_writers, memory_order_acquire);
+    for (size_t i = 0; i < num; i++) {
+        ring_destroy(&lg->writers[i]->ring);
+        free(lg->writers[i]);
+    }
+    pthread_mutex_destroy(&lg->lock);
+    return !atomic_load_explicit(&lg->failed, memory_order_relaxed);
+}
+
+/*
+ * Register a format string, which must stay valid (e.g. a literal) until
+ * ring_log_close(). Returns its id for ring_log(), or -1 if it uses an
+ * unsupported conversion, has more than RING_LOG_MAX_ARGS arguments, or
+ * the table is full. Any thread, but not on the hot path.
+ */
+int ring_log_format(ring_log_t *lg, const char *fmt) {
+    ring_log_format_t f;
+    if (!ring_log_parse_format(fmt, &f)) return -1;
+
+    pthread_mutex_lock(&lg->lock);
+    size_t id = atomic_load_explicit(&lg->num_formats, memory_order_relaxed);
+    if (id == RING_LOG_MAX_FORMATS) {
+        pthread_mutex_unlock(&lg->lock);
+        return -1;
+    }
+    lg->formats[id] = f;
+    atomic_store_explicit(&lg->num_formats, id + 1, memory_order_release);
+    pthread_mutex_unlock(&lg->lock);
+    return (int)id;
+}
+
+/*
+ * Create the calling thread's writer; keep it (e.g. in a _Thread_local) and
+ * log only from that thread. Returns NULL once RING_LOG_MAX_WRITERS exist
+ * or on allocation failure. Writers live until ring_log_close().
+ */
+ring_log_writer_t *ring_log_writer(ring_log_t *lg) {
+    size_t alloc = (sizeof(ring_log_writer_t) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+    ring_log_writer_t *w = aligned_alloc(CACHE_LINE, alloc);
+    if (w == NULL) return NULL;
+    if (!ring_init(&w->ring, lg->ring_capacity, NULL)) {
+        free(w);
+        return NULL;
+    }
+    w->lg = lg;
+    atomic_init(&w->dropped, 0);
+    w->reported = 0;
+
+    pthread_mutex_lock(&lg->lock);
+    size_t id = atomic_load_explicit(&lg->num_writers, memory_order_relaxed);
+    if (id == RING_LOG_MAX_WRITERS) {
+        pthread_mutex_unlock(&lg->lock);
+        ring_destroy(&w->ring);
+        free(w);
+        return NULL;
+    }
+    w->id = (uint32_t)id;
+    lg->writers[id] = w;
+    atomic_store_explicit(&lg->num_writers, id + 1, memory_order_release);
+    pthread_mutex_unlock(&lg->lock);
+    return w;
+}
+
+/*
+ * Hot path: log one record with format `id` and the matching arguments.
+ * Returns false, counting a drop, if the writer's ring is full, and
+ * without counting one if `id` isn't a registered format (e.g. the -1 of a
+ * failed ring_log_format()).
+ */
+bool ring_log(ring_log_writer_t *w, int id, ...) {
+    if ((unsigned)id >= atomic_load_explicit(&w->lg->num_formats, memory_order_acquire)) {
+        return false;
+    }
+    const ring_log_format_t *f = &w->lg->formats[id];
+    uint8_t rec[RING_LOG_MAX_RECORD];
+    uint8_t *p = rec + RING_LOG_RECORD_HEADER;
+    size_t budget = RING_LOG_MAX_RECORD - f->fixed;     /* For string bytes */
+    uint64_t now = ring_clock_now(&w->lg->clock);
+
+    va_list ap;
+    va_start(ap, id);
+    for (size_t i = 0; i < f->num_args; i++) {
+        uint64_t v;
+        switch ((ring_log_arg_t)f->args[i]) {
+        case RING_LOG_ARG_INT: {
+            int n = va_arg(ap, int);
+            memcpy(p, &n, sizeof(n));
+            p += sizeof(n);
+            continue;
+        }
+        case RING_LOG_ARG_LONG: v = (uint64_t)va_arg(ap, long); break;
+        case RING_LOG_ARG_LLONG: v = (uint64_t)va_arg(ap, long long); break;
+        case RING_LOG_ARG_SIZE: v = (uint64_t)va_arg(ap, size_t); break;
+        case RING_LOG_ARG_INTMAX: v = (uint64_t)va_arg(ap, intmax_t); break;
+        case RING_LOG_ARG_PTRDIFF: v = (uint64_t)va_arg(ap, ptrdiff_t); break;
+        case RING_LOG_ARG_PTR: v = (uint64_t)(uintptr_t)va_arg(ap, void *); break;
+        case RING_LOG_ARG_DOUBLE: {
+            double d = va_arg(ap, double);
+            memcpy(&v, &d, sizeof(v));
+            break;
+        }
+        case RING_LOG_ARG_STR: {
+            const char *s = va_arg(ap, const char *);
+            if (s == NULL) s = "(null)";
+            uint16_t n = (uint16_t)strnlen(s, budget);
+            budget -= n;
+            memcpy(p, &n, sizeof(n));
+            memcpy(p + sizeof(n), s, n);
+            p += sizeof(n) + n;
+            continue;
+        }
+        default:
+            continue;
+        }
+        memcpy(p, &v, sizeof(v));
+        p += sizeof(v);
+    }
+    va_end(ap);
+
+    uint16_t len = (uint16_t)(p - rec);
+    uint16_t fmt_id = (uint16_t)id;
+    memcpy(rec, &len, sizeof(len));
+    memcpy(rec + 2, &fmt_id, sizeof(fmt_id));
+    memcpy(rec + 4, &now, sizeof(now));
+
+    if (!ring_push(&w->ring, rec, len)) {
+        atomic_store_explicit(&w->dropped,
+                              atomic_load_explicit(&w->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Wait until everything logged before the call is in the file (or lost to
+ * a write error). Any thread.
+ */
+void ring_log_flush(ring_log_t *lg) {
+    size_t num = atomic_load_explicit(&lg->num_writers, memory_order_acquire);
+    for (size_t i = 0; i < num; i++) {
+        while (ring_used(&lg->writers[i]->ring) > 0) usleep(RING_LOG_IDLE_US / 10);
+    }
+}
+
+/* Records dropped on full rings so far, across all writers */
+uint64_t ring_log_dropped(ring_log_t *lg) {
+    uint64_t total = 0;
+    size_t num = atomic_load_explicit(&lg->num_writers, memory_order_acquire);
+    for (size_t i = 0; i < num; i++) {
+        total += atomic_load_explicit(&lg->writers[i]->dropped, memory_order_relaxed);
+    }
+    return total;
+}
+
+/* ============ Offline Decoder ============ */
+
+typedef struct {
+    char **fmts;
+    size_t num_fmts;
+    uint64_t start;
+    double ns_per_tick;
+} ring_log_decoder_t;
+
+/* printf one argument from `*p` (`end` bounds the record) per `spec` */
+static bool ring_log_render_arg(FILE *out, const char *spec_text, const ring_log_spec_t *spec,
+                                const uint8_t **p, const uint8_t *end) {
+    char spec_buf[64];
+    size_t size = ring_log_arg_size(spec->type);
+    if (spec->len + 3 > sizeof(spec_buf) || (size_t)(end - *p) < size) return false;
+
+    /*
+     * int-sized conversions are used as written (h/hh still truncate);
+     * otherwise keep flags, width and precision and match the modifier to
+     * the 8-byte encoding
+     */
+    if (spec->type == RING_LOG_ARG_INT) {
+        memcpy(spec_buf, spec_text, spec->len);
+        spec_buf[spec->len] = '\0';
+    } else {
+        memcpy(spec_buf, spec_text, spec->prefix);
+        char *m = spec_buf + spec->prefix;
+        if (spec->type != RING_LOG_ARG_DOUBLE && spec->type != RING_LOG_ARG_PTR &&
+            spec->type != RING_LOG_ARG_STR) {
+            *m++ = 'l';
+            *m++ = 'l';
+        }
+        *m++ = spec->conv;
+        *m = '\0';
+    }
+
+    bool is_unsigned = strchr("ouxX", spec->conv) != NULL;
+    switch (spec->type) {
+    case RING_LOG_ARG_INT: {
+        int32_t v;
+        memcpy(&v, *p, sizeof(v));
+        if (is_unsigned) {
+            fprintf(out, spec_buf, (unsigned)v);
+        } else {
+            fprintf(out, spec_buf, (int)v);
+        }
+        break;
+    }
+    case RING_LOG_ARG_DOUBLE: {
+        double v;
+        memcpy(&v, *p, sizeof(v));
+        fprintf(out, spec_buf, v);
+        break;
+    }
+    case RING_LOG_ARG_PTR: {
+        uint64_t v;
+        memcpy(&v, *p, sizeof(v));
+        fprintf(out, spec_buf, (void *)(uintptr_t)v);
+        break;
+    }
+    case RING_LOG_ARG_STR: {
+        uint16_t n;
+        char s[RING_LOG_MAX_RECORD + 1];
+        memcpy(&n, *p, sizeof(n));
+        if ((size_t)(end - *p) < sizeof(n) + n || n > RING_LOG_MAX_RECORD) return false;
+        memcpy(s, *p + sizeof(n), n);
+        s[n] = '\0';
+        fprintf(out, spec_buf, s);
+        *p += n;
+        break;
+    }
+    default: {
+        uint64_t v;
+        memcpy(&v, *p, sizeof(v));
+        if (is_unsigned) {
+            fprintf(out, spec_buf, (unsigned long long)v);
+        } else {
+            fprintf(out, spec_buf, (long long)v);
+        }
+        break;
+    }
+    }
+    *p += size;
+    return true;
+}
+
+/* One line per record: "[seconds since open] w<writer> <message>" */
+static bool ring_log_render(FILE *out, const ring_log_decoder_t *d, uint32_t writer,
+                            const uint8_t *rec, size_t len) {
+    uint16_t fmt_id;
+    uint64_t ticks;
+    memcpy(&fmt_id, rec + 2, sizeof(fmt_id));
+    memcpy(&ticks, rec + 4, sizeof(ticks));
+    if (fmt_id >= d->num_fmts || d->fmts[fmt_id] == NULL) return false;
+
+    double secs = (double)(int64_t)(ticks - d->start) * d->ns_per_tick / 1e9;
+    fprintf(out, "[%.9f] w%u ", secs, writer);
+
+    const uint8_t *p = rec + RING_LOG_RECORD_HEADER;
+    const uint8_t *end = rec + len;
+    for (const char *f = d->fmts[fmt_id]; *f != '\0'; f++) {
+        if (*f != '%') {
+            fputc(*f, out);
+            continue;
+        }
+        ring_log_spec_t spec;
+        if (!ring_log_parse_spec(f, &spec)) return false;
+        if (spec.type == RING_LOG_ARG_NONE) {
+            fputc('%', out);
+        } else if (!ring_log_render_arg(out, f, &spec, &p, end)) {
+            return false;
+        }
+        f += spec.len - 1;
+    }
+    fputc('\n', out);
+    return true;
+}
+
+static bool ring_log_decode_block(FILE *out, ring_log_decoder_t *d, const ring_log_block_t *b,
+                                  uint8_t *payload) {
+    switch (b->type) {
+    case RING_LOG_DEFINE: {
+        if (b->id >= RING_LOG_MAX_FORMATS) return false;
+        if (b->id >= d->num_fmts) {
+            size_t n = b->id + 1;
+            char **fmts = realloc(d->fmts, n * sizeof(*fmts));
+            if (fmts == NULL) return false;
+            memset(fmts + d->num_fmts, 0, (n - d->num_fmts) * sizeof(*fmts));
+            d->fmts = fmts;
+            d->num_fmts = n;
+        }
+        free(d->fmts[b->id]);
+        d->fmts[b->id] = malloc(b->len + 1);
+        if (d->fmts[b->id] == NULL) return false;
+        memcpy(d->fmts[b->id], payload, b->len);
+        d->fmts[b->id][b->len] = '\0';
+        return true;
+    }
+    case RING_LOG_DROPPED: {
+        uint64_t n;
+        if (b->len != sizeof(n)) return false;
+        memcpy(&n, payload, sizeof(n));
+        fprintf(out, "[dropped] w%u %llu records\n", b->id, (unsigned long long)n);
+        return true;
+    }
+    case RING_LOG_RECORDS:
+        for (size_t off = 0; off < b->len;) {
+            uint16_t len;
+            if (b->len - off < RING_LOG_RECORD_HEADER) return false;
+            memcpy(&len, payload + off, sizeof(len));
+            if (len < RING_LOG_RECORD_HEADER || len > b->len - off) return false;
+            if (!ring_log_render(out, d, b->id, payload + off, len)) return false;
+            off += len;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Offline: decode a log file from `in` to text on `out`, one line per
+ * record. Returns false if the file is malformed or truncated (a crash
+ * can cut the last block short); everything before that is still output.
+ */
+bool ring_log_decode(FILE *in, FILE *out) {
+    ring_log_file_header_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, in) != 1) return false;
+    if (hdr.magic != RING_LOG_MAGIC || hdr.version != RING_LOG_VERSION) return false;
+
+    ring_log_decoder_t d = { NULL, 0, hdr.start, hdr.ns_per_tick };
+    uint8_t *payload = NULL;
+    size_t payload_cap = 0;
+    bool ok = true;
+
+    ring_log_block_t b;
+    size_t got;
+    while ((got = fread(&b, 1, sizeof(b), in)) == sizeof(b)) {
+        /* No writer produces more than one ring's worth; anything larger is corrupt */
+        if (b.len > RING_LOG_MAX_RING) {
+            ok = false;
+            break;
+        }
+        if (b.len > payload_cap) {
+            uint8_t *grown = realloc(payload, b.len);
+            if (grown == NULL) {
+                ok = false;
+                break;
+            }
+            payload = grown;
+            payload_cap = b.len;
+        }
+        if (fread(payload, 1, b.len, in) != b.len || !ring_log_decode_block(out, &d, &b, payload)) {
+            ok = false;
+            break;
+        }
+    }
+    if (ok && (got != 0 || !feof(in))) ok = false;   /* Cut off mid-header, or a read error */
+
+    for (size_t i = 0; i < d.num_fmts; i++) free(d.fmts[i]);
+    free(d.fmts);
+    free(payload);
+    return ok;
+}
+
+#endif /* RING_LOG_C */
@@ -0,0 +1,38 @@
+/*
+ * Offline decoder for ring_log.c files: one text line per record
+ *
+ *   ./ring_log_decode app.rlog > app.txt
+ *
+ * Reads stdin when no file (or "-") is given. Exits 1 if the file is
+ * malformed or was cut short, after printing everything before that point.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_log.c"
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [file]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = stdin;
+    if (argc == 2 && strcmp(argv[1], "-") != 0) {
+        in = fopen(argv[1], "rb");
+        if (in == NULL) {
+            perror(argv[1]);
+            return 2;
+        }
+    }
+
+    bool ok = ring_log_decode(in, stdout);
+    if (in != stdin) fclose(in);
+    if (!ok) {
+        fprintf(stderr, "%s: malformed or truncated log\n", argc == 2 ? argv[1] : "stdin");
+        return 1;
+    }
+    return 0;
+}
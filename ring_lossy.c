@@ -0,0 +1,213 @@
+#ifndef RING_LOSSY_C
+#define RING_LOSSY_C
+
+#include "ring_buffer.c"
+
+/*
+ * Overwrite-oldest SPSC ring for telemetry and flight recording: the
+ * producer never fails or waits for the consumer, it just writes over the
+ * oldest bytes. It never even reads the consumer's tail, so the hot path
+ * touches only its own cache lines.
+ *
+ * A consumer that falls more than `capacity` bytes behind is told how many
+ * bytes it lost and skips to the live edge, which is always on a push
+ * boundary. As in the lossy broadcast ring, each copy is validated
+ * seqlock-style against the producer's claim cursor (the end of the region
+ * it may be overwriting), so data overwritten mid-copy is reported as lost
+ * rather than returned torn. No locks on either side.
+ *
+ * The framed calls carry variable-length records (a 4-byte length header,
+ * written in the same push as the payload), so a lapped consumer always
+ * resumes on a record boundary. Don't mix framed and raw calls on one ring.
+ *
+ * Under RING_STATS only the consumer side is counted (a skip counts as a
+ * failed op); the producer has no view of occupancy.
+ */
+#define RING_LOSSY_HEADER 4
+
+typedef struct {
+    /* ring.head is the producer position, ring.tail the consumer's (only
+     * published for monitoring); ring.cached_tail is unused */
+    ring_buffer_t ring;
+
+    /* End of the region the producer may be overwriting */
+    alignas(CACHE_LINE) atomic_size_t claim;
+
+    /* Consumer: total bytes skipped after being lapped */
+    alignas(CACHE_LINE) atomic_size_t lost;
+} ring_lossy_t;
+
+/* `capacity` and `buffer` are as for ring_init() */
+bool ring_lossy_init(ring_lossy_t *l, size_t capacity, void *buffer) {
+    if (!ring_init(&l->ring, capacity, buffer)) return false;
+    atomic_init(&l->claim, 0);
+    atomic_init(&l->lost, 0);
+    return true;
+}
+
+void ring_lossy_destroy(ring_lossy_t *l) {
+    ring_destroy(&l->ring);
+}
+
+/* Announce that [head, end) is about to be overwritten, before touching it */
+static inline void ring_lossy_claim(ring_lossy_t *l, size_t end) {
+    atomic_store_explicit(&l->claim, end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/*
+ * Reader side of the seqlock: true if nothing at or after `tail` was
+ * overwritten while it was being copied
+ */
+static inline bool ring_lossy_intact(ring_lossy_t *l, size_t tail) {
+    atomic_thread_fence(memory_order_acquire);
+    size_t claim = atomic_load_explicit(&l->claim, memory_order_relaxed);
+    return claim - tail <= l->ring.capacity;
+}
+
+/* Consumer was lapped: skip to the live edge and account for the gap */
+static void ring_lossy_skip(ring_lossy_t *l, size_t tail, size_t *lost) {
+    ring_buffer_t *rb = &l->ring;
+    rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    size_t skipped = rb->cached_head - tail;
+
+    if (lost != NULL) *lost = skipped;
+    atomic_store_explicit(&l->lost,
+                          atomic_load_explicit(&l->lost, memory_order_relaxed) + skipped,
+                          memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, rb->cached_head, memory_order_release);
+    RING_STATS_FAIL(rb, consumer);
+}
+
+/*
+ * Consumer bookkeeping before a read of `len` bytes: false if fewer are
+ * published, or if the consumer was lapped (after skipping ahead)
+ */
+static bool ring_lossy_readable(ring_lossy_t *l, size_t tail, size_t len, size_t *lost) {
+    ring_buffer_t *rb = &l->ring;
+
+    if (len <= rb->cached_head - tail) return true;
+
+    rb->cached_head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    if (rb->cached_head - tail > rb->capacity) {
+        ring_lossy_skip(l, tail, lost);
+        return false;
+    }
+    if (len > rb->cached_head - tail) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Producer: always succeeds for `len` up to the capacity (returns false
+ * only beyond that), overwriting the oldest bytes if the consumer is behind
+ */
+bool ring_lossy_push(ring_lossy_t *l, uint8_t *src, size_t len) {
+    ring_buffer_t *rb = &l->ring;
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+
+    if (len > rb->capacity) return false;
+
+    ring_lossy_claim(l, head + len);
+    ring_copy_in(rb, head & rb->mask, src, len);
+
+    atomic_store_explicit(&rb->head, head + len, memory_order_release);
+    return true;
+}
+
+/*
+ * Consumer: copy the next `len` bytes into `dst`. Returns false if fewer
+ * than `len` bytes are available, or if the producer lapped the consumer;
+ * `*lost` (if non-NULL) is then set to the bytes skipped to reach the live
+ * edge, and is 0 otherwise. `len` should match the producer's push sizes,
+ * or a skip can land mid-message.
+ */
+bool ring_lossy_pop(ring_lossy_t *l, uint8_t *dst, size_t len, size_t *lost) {
+    ring_buffer_t *rb = &l->ring;
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (lost != NULL) *lost = 0;
+    if (!ring_lossy_readable(l, tail, len, lost)) return false;
+
+    ring_copy_out_speculative(rb, tail & rb->mask, dst, len);
+
+    if (!ring_lossy_intact(l, tail)) {
+        ring_lossy_skip(l, tail, lost);
+        return false;
+    }
+
+    atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+    RING_STATS_OK(rb, consumer, len, rb->cached_head - (tail + len));
+    return true;
+}
+
+/* Producer: push one record of `len` bytes; false only if it can never fit */
+bool ring_lossy_push_msg(ring_lossy_t *l, const void *src, size_t len) {
+    ring_buffer_t *rb = &l->ring;
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t total = RING_LOSSY_HEADER + len;
+
+    /* Two checks, since capacity may be below the header size */
+    if (len > rb->capacity || total > rb->capacity) return false;
+
+    uint32_t header = (uint32_t)len;
+    ring_lossy_claim(l, head + total);
+    ring_copy_in(rb, head & rb->mask, (const uint8_t *)&header, RING_LOSSY_HEADER);
+    ring_copy_in(rb, (head + RING_LOSSY_HEADER) & rb->mask, src, len);
+
+    atomic_store_explicit(&rb->head, head + total, memory_order_release);
+    return true;
+}
+
+/*
+ * Consumer: pop one record into `dst` (room for `cap` bytes) and set `*len`
+ * to its size. Returns false if there is no record, if it is larger than
+ * `cap` (left in place, `*len` set), or if the consumer was lapped (`*lost`
+ * set as for ring_lossy_pop(); the next record is the first one pushed
+ * after the skip).
+ */
+bool ring_lossy_pop_msg(ring_lossy_t *l, void *dst, size_t cap, size_t *len, size_t *lost) {
+    ring_buffer_t *rb = &l->ring;
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (lost != NULL) *lost = 0;
+    if (!ring_lossy_readable(l, tail, RING_LOSSY_HEADER, lost)) return false;
+
+    /* The header is only trustworthy once validated */
+    uint32_t header;
+    ring_copy_out_speculative(rb, tail & rb->mask, (uint8_t *)&header, RING_LOSSY_HEADER);
+    if (!ring_lossy_intact(l, tail)) {
+        ring_lossy_skip(l, tail, lost);
+        return false;
+    }
+
+    /* Published in one piece with its header */
+    *len = header;
+    if (header > cap) return false;
+
+    ring_copy_out_speculative(rb, (tail + RING_LOSSY_HEADER) & rb->mask, dst, header);
+    if (!ring_lossy_intact(l, tail)) {
+        ring_lossy_skip(l, tail, lost);
+        return false;
+    }
+
+    size_t total = RING_LOSSY_HEADER + header;
+    atomic_store_explicit(&rb->tail, tail + total, memory_order_release);
+    RING_STATS_OK(rb, consumer, total, rb->cached_head - (tail + total));
+    return true;
+}
+
+/* Bytes published but not yet read (may exceed the capacity once lapped) */
+size_t ring_lossy_lag(ring_lossy_t *l) {
+    size_t head = atomic_load_explicit(&l->ring.head, memory_order_acquire);
+    return head - atomic_load_explicit(&l->ring.tail, memory_order_acquire);
+}
+
+/* Total bytes the consumer has lost to overwrites; safe from any thread */
+size_t ring_lossy_lost(ring_lossy_t *l) {
+    return atomic_load_explicit(&l->lost, memory_order_relaxed);
+}
+
+#endif /* RING_LOSSY_C */
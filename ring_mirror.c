@@ -0,0 +1,78 @@
+#ifndef RING_MIRROR_C
+#define RING_MIRROR_C
+
+#include "ring_buffer.c"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Virtual-memory mirrored ("magic") ring: the data region is mapped twice,
+ * back to back, so data[capacity + i] aliases data[i]. Any span of up to
+ * `capacity` bytes starting anywhere in the ring is then contiguous in
+ * memory, and ring_push/ring_pop/ring_peek need no wrap handling: copies
+ * are a single memcpy() and spans always have one segment.
+ */
+
+static void ring_release_mirror(ring_buffer_t *rb) {
+    munmap(rb->data, 2 * rb->capacity);
+}
+
+/* An fd for `size` bytes of anonymous shared memory, or -1 */
+static int ring_mirror_fd(size_t size) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    int fd = (int)syscall(SYS_memfd_create, "ring_mirror", 1U /* MFD_CLOEXEC */);
+#else
+    char name[64];
+    snprintf(name, sizeof(name), "/ring_mirror_%ld_%p", (long)getpid(), (void *)&name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) shm_unlink(name);
+#endif
+    if (fd < 0) return -1;
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Initialize `rb` with a mirrored data region of `capacity` bytes.
+ * `capacity` must be a power of two and a multiple of the page size.
+ * Returns false on invalid arguments or if the mappings can't be set up.
+ */
+bool ring_init_mirrored(ring_buffer_t *rb, size_t capacity) {
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    if (capacity % (size_t)page != 0) return false;
+
+    int fd = ring_mirror_fd(capacity);
+    if (fd < 0) return false;
+
+    /* Reserve 2x address space, then map the same pages into both halves */
+    uint8_t *base = mmap(NULL, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    bool ok = base != MAP_FAILED &&
+              mmap(base, capacity, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+              mmap(base + capacity, capacity, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+    close(fd);
+
+    if (!ok) {
+        if (base != MAP_FAILED) munmap(base, 2 * capacity);
+        return false;
+    }
+
+    ring_setup(rb, base, capacity);
+    rb->mirrored = true;
+    rb->release = ring_release_mirror;
+    return true;
+}
+
+#endif /* RING_MIRROR_C */
@@ -0,0 +1,140 @@
+#ifndef RING_MPMC_C
+#define RING_MPMC_C
+
+#include "ring_buffer.c"
+
+/*
+ * Multi-producer, multi-consumer bounded queue of fixed-size slots.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded MPMC queue). A slot
+ * at position `pos` is free for the producer that claims `pos` when its
+ * sequence equals `pos`, and full for the consumer that claims `pos` when it
+ * equals `pos + 1`. Producers and consumers claim positions by CAS on their
+ * own cursor, each on its own cache line like the SPSC head/tail, and then
+ * only touch their slot.
+ */
+typedef struct {
+    /* Read-only after ring_mpmc_init() */
+    uint8_t *slots;
+    size_t slot_count;
+    size_t mask;
+    size_t slot_size;
+    size_t stride;
+    bool owns_slots;
+
+    alignas(CACHE_LINE) atomic_size_t enqueue_pos;
+    alignas(CACHE_LINE) atomic_size_t dequeue_pos;
+} ring_mpmc_t;
+
+/* Bytes per slot: sequence number plus payload, padded to keep `seq` aligned */
+static inline size_t ring_mpmc_stride(size_t slot_size) {
+    size_t align = alignof(atomic_size_t);
+    return (sizeof(atomic_size_t) + slot_size + align - 1) & ~(align - 1);
+}
+
+/* Size of the backing region ring_mpmc_init() needs for the given geometry */
+size_t ring_mpmc_storage_size(size_t slot_count, size_t slot_size) {
+    return slot_count * ring_mpmc_stride(slot_size);
+}
+
+static inline atomic_size_t *ring_mpmc_seq(const ring_mpmc_t *q, size_t pos) {
+    return (atomic_size_t *)(void *)(q->slots + (pos & q->mask) * q->stride);
+}
+
+static inline uint8_t *ring_mpmc_payload(const ring_mpmc_t *q, size_t pos) {
+    return q->slots + (pos & q->mask) * q->stride + sizeof(atomic_size_t);
+}
+
+/*
+ * Initialize a queue of `slot_count` slots of `slot_size` bytes each.
+ * `slot_count` must be a power of two (at least 2). If `buffer` is NULL the
+ * slots are allocated; otherwise `buffer` must be CACHE_LINE aligned and at
+ * least ring_mpmc_storage_size() bytes.
+ */
+bool ring_mpmc_init(ring_mpmc_t *q, size_t slot_count, size_t slot_size, void *buffer) {
+    if (slot_count < 2 || (slot_count & (slot_count - 1)) != 0) return false;
+    if (slot_size == 0) return false;
+    if (buffer != NULL && ((uintptr_t)buffer & (CACHE_LINE - 1)) != 0) return false;
+
+    memset(q, 0, sizeof(*q));
+    size_t bytes = ring_mpmc_storage_size(slot_count, slot_size);
+
+    if (buffer == NULL) {
+        size_t alloc = (bytes + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+        buffer = aligned_alloc(CACHE_LINE, alloc);
+        if (buffer == NULL) return false;
+        q->owns_slots = true;
+    }
+
+    q->slots = buffer;
+    q->slot_count = slot_count;
+    q->mask = slot_count - 1;
+    q->slot_size = slot_size;
+    q->stride = ring_mpmc_stride(slot_size);
+
+    for (size_t i = 0; i < slot_count; i++) {
+        atomic_init(ring_mpmc_seq(q, i), i);
+    }
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+    return true;
+}
+
+void ring_mpmc_destroy(ring_mpmc_t *q) {
+    if (q->owns_slots) free(q->slots);
+    memset(q, 0, sizeof(*q));
+}
+
+/* Copy one slot_size message from `src`. Returns false if the queue is full. */
+bool ring_mpmc_push(ring_mpmc_t *q, const uint8_t *src) {
+    size_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+
+    for (;;) {
+        size_t seq = atomic_load_explicit(ring_mpmc_seq(q, pos), memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   /* Slot still holds the previous lap's message */
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(ring_mpmc_payload(q, pos), src, q->slot_size);
+    atomic_store_explicit(ring_mpmc_seq(q, pos), pos + 1, memory_order_release);
+    return true;
+}
+
+/* Copy one slot_size message into `dst`. Returns false if the queue is empty. */
+bool ring_mpmc_pop(ring_mpmc_t *q, uint8_t *dst) {
+    size_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+
+    for (;;) {
+        size_t seq = atomic_load_explicit(ring_mpmc_seq(q, pos), memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   /* Slot not yet written for this lap */
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(dst, ring_mpmc_payload(q, pos), q->slot_size);
+    atomic_store_explicit(ring_mpmc_seq(q, pos), pos + q->mask + 1, memory_order_release);
+    return true;
+}
+
+#endif /* RING_MPMC_C */
@@ -0,0 +1,78 @@
+#ifndef RING_MPSC_C
+#define RING_MPSC_C
+
+#include "ring_buffer.c"
+
+/*
+ * Multi-producer, single-consumer byte ring.
+ *
+ * Producers claim space by CAS on a reservation cursor, copy their payload
+ * outside of any critical section, and then publish in reservation order by
+ * advancing the ring's head (the commit cursor) from their start to their
+ * end. The consumer side is the plain SPSC ring_pop(), since it only ever
+ * sees committed bytes.
+ *
+ * The cursors are free-running like the ring's own counters, so a stale
+ * `start` can never CAS successfully after the cursor has lapped the ring.
+ *
+ * Each reservation is all-or-nothing, so messages from different producers
+ * never interleave. A producer that is descheduled between reserve and
+ * commit delays the commits of producers that reserved after it.
+ */
+typedef struct {
+    ring_buffer_t ring;
+
+    alignas(CACHE_LINE) atomic_size_t reserve;
+} ring_mpsc_t;
+
+bool ring_mpsc_init(ring_mpsc_t *q, size_t capacity, void *buffer) {
+    if (!ring_init(&q->ring, capacity, buffer)) return false;
+    atomic_init(&q->reserve, 0);
+    return true;
+}
+
+void ring_mpsc_destroy(ring_mpsc_t *q) {
+    ring_destroy(&q->ring);
+}
+
+/* Safe to call from any number of producer threads concurrently */
+bool ring_mpsc_push(ring_mpsc_t *q, uint8_t *src, size_t len) {
+    ring_buffer_t *rb = &q->ring;
+    /*
+     * Acquire on `reserve` (and release on claiming it) passes along the tail
+     * each reserving producer checked against. Relaxed, a producer could see
+     * another's newer cursor with a tail more than a lap older, and the
+     * masked space check would count unread bytes as free and overwrite them.
+     */
+    size_t start = atomic_load_explicit(&q->reserve, memory_order_acquire);
+    size_t end;
+
+    do {
+        /* Producers share the tail, so there is no private cached copy here */
+        size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+        if (len > rb->capacity - (start - tail)) return false;
+        end = start + len;
+    } while (!atomic_compare_exchange_weak_explicit(&q->reserve, &start, end,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire));
+
+    ring_copy_in(rb, start & rb->mask, src, len);
+
+    /*
+     * Wait for earlier reservations to commit. The acquire makes their
+     * payloads happen-before our release, so the consumer's acquire of
+     * head sees every byte up to `end`.
+     */
+    while (atomic_load_explicit(&rb->head, memory_order_acquire) != start) {
+        ring_cpu_relax();
+    }
+    atomic_store_explicit(&rb->head, end, memory_order_release);
+    return true;
+}
+
+/* Single consumer only */
+bool ring_mpsc_pop(ring_mpsc_t *q, uint8_t *dst, size_t len) {
+    return ring_pop(&q->ring, dst, len);
+}
+
+#endif /* RING_MPSC_C */
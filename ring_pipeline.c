@@ -0,0 +1,128 @@
+#ifndef RING_PIPELINE_C
+#define RING_PIPELINE_C
+
+#include "ring_buffer.c"
+
+/*
+ * Multi-stage pipeline over one shared buffer, in the spirit of the LMAX
+ * Disruptor: a message is written once and every stage processes it in
+ * place, instead of each hop popping it out of one ring and pushing it into
+ * the next.
+ *
+ * Stage i has its own free-running cursor and may only read up to the
+ * cursor of stage i - 1 (stage 0: the producer's head). The last stage's
+ * cursor is the embedded ring's tail, so the producer is gated by the last
+ * stage and uses the ordinary producer calls on `p->ring` unchanged:
+ * ring_push, ring_reserve/ring_commit, ring_push_batch, ring_push_staged.
+ *
+ * A stage may modify the bytes it holds; releasing them publishes the
+ * changes to the next stage (release store of its cursor, acquire load by
+ * the next). Each stage keeps a private cached copy of its upstream cursor
+ * on its own cache line, as the core ring does for the remote index.
+ *
+ * The ring is a byte stream, so stages must agree on message boundaries:
+ * fixed-size messages, or self-delimiting records walked with
+ * ring_stage_drain().
+ */
+#define RING_PIPELINE_MAX_STAGES 8
+
+typedef struct {
+    alignas(CACHE_LINE) atomic_size_t cursor;  /* Unused by the last stage (ring.tail) */
+    size_t cached_upstream;
+} ring_stage_t;
+
+typedef struct {
+    /* ring.head is the producer, ring.tail the last stage's cursor */
+    ring_buffer_t ring;
+    size_t num_stages;
+    ring_stage_t stages[RING_PIPELINE_MAX_STAGES];
+} ring_pipeline_t;
+
+/*
+ * Initialize a pipeline of `num_stages` stages, numbered 0 .. num_stages - 1
+ * in processing order. `capacity` and `buffer` are as for ring_init().
+ */
+bool ring_pipeline_init(ring_pipeline_t *p, size_t capacity, void *buffer, size_t num_stages) {
+    if (num_stages == 0 || num_stages > RING_PIPELINE_MAX_STAGES) return false;
+    if (!ring_init(&p->ring, capacity, buffer)) return false;
+
+    p->num_stages = num_stages;
+    for (size_t i = 0; i < RING_PIPELINE_MAX_STAGES; i++) {
+        atomic_init(&p->stages[i].cursor, 0);
+        p->stages[i].cached_upstream = 0;
+    }
+    return true;
+}
+
+void ring_pipeline_destroy(ring_pipeline_t *p) {
+    ring_destroy(&p->ring);
+}
+
+static inline atomic_size_t *ring_stage_cursor(ring_pipeline_t *p, size_t stage) {
+    return stage == p->num_stages - 1 ? &p->ring.tail : &p->stages[stage].cursor;
+}
+
+static inline atomic_size_t *ring_stage_upstream(ring_pipeline_t *p, size_t stage) {
+    return stage == 0 ? &p->ring.head : ring_stage_cursor(p, stage - 1);
+}
+
+/* Bytes ready for `stage` at `pos`; re-reads upstream only if fewer than `len` are cached */
+static inline size_t ring_stage_readable(ring_pipeline_t *p, size_t stage, size_t pos, size_t len) {
+    ring_stage_t *s = &p->stages[stage];
+    size_t available = s->cached_upstream - pos;
+    if (len > available) {
+        s->cached_upstream = atomic_load_explicit(ring_stage_upstream(p, stage), memory_order_acquire);
+        available = s->cached_upstream - pos;
+    }
+    return available;
+}
+
+/*
+ * Stage `stage`: expose the next `len` bytes the previous stage (or the
+ * producer) has finished with, as one or two segments, to read or modify in
+ * place. Returns false if fewer than `len` are ready.
+ */
+bool ring_stage_peek(ring_pipeline_t *p, size_t stage, size_t len, ring_span_t *span) {
+    size_t pos = atomic_load_explicit(ring_stage_cursor(p, stage), memory_order_relaxed);
+    if (len > ring_stage_readable(p, stage, pos, len)) return false;
+
+    ring_span_at(&p->ring, pos & p->ring.mask, len, span);
+    return true;
+}
+
+/* Stage `stage`: hand `len` peeked bytes (and any changes to them) downstream */
+void ring_stage_release(ring_pipeline_t *p, size_t stage, size_t len) {
+    atomic_size_t *cursor = ring_stage_cursor(p, stage);
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+    atomic_store_explicit(cursor, pos + len, memory_order_release);
+}
+
+/*
+ * Stage `stage`: pass everything ready, up to `max` bytes, to `fn` as in
+ * ring_drain(), then release what it consumed with one cursor publish.
+ * Returns that byte count; 0 (without calling `fn`) if nothing is ready.
+ */
+size_t ring_stage_drain(ring_pipeline_t *p, size_t stage, size_t max, ring_drain_fn_t fn, void *ctx) {
+    atomic_size_t *cursor = ring_stage_cursor(p, stage);
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+
+    size_t n = ring_stage_readable(p, stage, pos, max);
+    if (n > max) n = max;
+    if (n == 0) return 0;
+
+    ring_span_t span;
+    ring_span_at(&p->ring, pos & p->ring.mask, n, &span);
+    size_t consumed = fn(&span, ctx);
+    if (consumed > n) consumed = n;
+
+    if (consumed > 0) atomic_store_explicit(cursor, pos + consumed, memory_order_release);
+    return consumed;
+}
+
+/* Bytes ready for `stage` but not yet released by it; a snapshot from any thread */
+size_t ring_stage_lag(ring_pipeline_t *p, size_t stage) {
+    size_t upstream = atomic_load_explicit(ring_stage_upstream(p, stage), memory_order_acquire);
+    return upstream - atomic_load_explicit(ring_stage_cursor(p, stage), memory_order_acquire);
+}
+
+#endif /* RING_PIPELINE_C */
@@ -0,0 +1,222 @@
+#ifndef RING_SHM_C
+#define RING_SHM_C
+
+#include "ring_buffer.c"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Inter-process SPSC ring in a named POSIX shared memory segment.
+ *
+ * The segment starts with a versioned header (magic, layout version,
+ * capacity) followed by the producer and consumer index lines, then the
+ * data region. Processes map it at different addresses, so nothing inside
+ * the segment is a pointer; each process keeps a local ring_shm_t handle.
+ *
+ * Crash safety: a push only becomes visible when head is published after
+ * the whole payload has been written, so a producer that dies mid-write
+ * leaves no half-written frame behind. The replacement producer claims the
+ * role with ring_shm_claim(), which takes over from a dead owner, and
+ * simply overwrites the unpublished bytes. The consumer role works the same.
+ */
+#define RING_SHM_MAGIC 0x314d4853474e4952ULL    /* "RINGSHM1" in memory on little-endian hosts */
+#define RING_SHM_VERSION 2    /* 2: head/tail are free-running 64-bit counters */
+
+typedef struct {
+    _Atomic uint64_t magic;     /* Stored last on create, so attach never sees a partial header */
+    uint32_t version;
+    uint32_t header_size;       /* Offset of the data region */
+    uint64_t capacity;
+    atomic_int producer_pid;    /* 0 when the role is free */
+    atomic_int consumer_pid;
+
+    /* Free-running byte counters, fixed width so 32- and 64-bit processes agree */
+    alignas(CACHE_LINE) _Atomic uint64_t head;
+    uint64_t cached_tail;
+
+    alignas(CACHE_LINE) _Atomic uint64_t tail;
+    uint64_t cached_head;
+} ring_shm_header_t;
+
+typedef enum {
+    RING_SHM_PRODUCER,
+    RING_SHM_CONSUMER
+} ring_shm_role_t;
+
+/* Process-local handle on a mapped segment */
+typedef struct {
+    ring_shm_header_t *hdr;
+    uint8_t *data;
+    size_t capacity;
+    size_t mask;
+    size_t map_size;
+    ring_copy_fn_t copy;    /* Picked per process: the two ends may be on different CPUs */
+} ring_shm_t;
+
+static size_t ring_shm_header_size(void) {
+    return (sizeof(ring_shm_header_t) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+}
+
+/* Map `map_size` bytes of `fd` shared; always closes `fd` */
+static bool ring_shm_map(ring_shm_t *s, int fd, size_t map_size) {
+    void *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    s->hdr = p;
+    s->map_size = map_size;
+    return true;
+}
+
+/*
+ * Create and initialize the segment `name` (e.g. "/feed0") with a
+ * power-of-two `capacity`. Fails if the segment already exists.
+ */
+bool ring_shm_create(ring_shm_t *s, const char *name, size_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+
+    size_t header_size = ring_shm_header_size();
+    size_t map_size = header_size + capacity;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return false;
+    if (ftruncate(fd, (off_t)map_size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    if (!ring_shm_map(s, fd, map_size)) {
+        shm_unlink(name);
+        return false;
+    }
+
+    ring_shm_header_t *hdr = s->hdr;
+    hdr->version = RING_SHM_VERSION;
+    hdr->header_size = (uint32_t)header_size;
+    hdr->capacity = capacity;
+    atomic_init(&hdr->producer_pid, 0);
+    atomic_init(&hdr->consumer_pid, 0);
+    atomic_init(&hdr->head, 0);
+    atomic_init(&hdr->tail, 0);
+    hdr->cached_tail = 0;
+    hdr->cached_head = 0;
+    atomic_store_explicit(&hdr->magic, RING_SHM_MAGIC, memory_order_release);
+
+    s->data = (uint8_t *)hdr + header_size;
+    s->capacity = capacity;
+    s->mask = capacity - 1;
+    s->copy = ring_copy_kernel_best()->copy;
+    return true;
+}
+
+/*
+ * Map an existing segment created by another (or this) process. Fails if
+ * the segment is missing, not initialized yet, or has an unknown layout.
+ */
+bool ring_shm_attach(ring_shm_t *s, const char *name) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < ring_shm_header_size()) {
+        close(fd);
+        return false;
+    }
+    if (!ring_shm_map(s, fd, (size_t)st.st_size)) return false;
+
+    ring_shm_header_t *hdr = s->hdr;
+    bool valid = atomic_load_explicit(&hdr->magic, memory_order_acquire) == RING_SHM_MAGIC &&
+                 hdr->version == RING_SHM_VERSION &&
+                 hdr->header_size == ring_shm_header_size() &&
+                 hdr->capacity != 0 && (hdr->capacity & (hdr->capacity - 1)) == 0 &&
+                 hdr->header_size + hdr->capacity <= s->map_size;
+    if (!valid) {
+        munmap(s->hdr, s->map_size);
+        s->hdr = NULL;
+        return false;
+    }
+
+    s->data = (uint8_t *)hdr + hdr->header_size;
+    s->capacity = (size_t)hdr->capacity;
+    s->mask = s->capacity - 1;
+    s->copy = ring_copy_kernel_best()->copy;
+    return true;
+}
+
+static bool ring_shm_pid_alive(int pid) {
+    return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/*
+ * Claim the producer or consumer role for this process. Succeeds if the role
+ * is free or held by a process that no longer exists; fails if a live
+ * process holds it. (A recycled PID looks alive, which errs on the safe side.)
+ */
+bool ring_shm_claim(ring_shm_t *s, ring_shm_role_t role) {
+    atomic_int *slot = role == RING_SHM_PRODUCER ? &s->hdr->producer_pid
+                                                 : &s->hdr->consumer_pid;
+    int self = (int)getpid();
+    int owner = atomic_load(slot);
+
+    for (;;) {
+        if (owner == self) break;
+        if (owner != 0 && ring_shm_pid_alive(owner)) return false;
+        if (atomic_compare_exchange_strong(slot, &owner, self)) break;
+    }
+    return true;
+}
+
+/* Release any role this process holds and unmap. The segment persists. */
+void ring_shm_detach(ring_shm_t *s) {
+    if (s->hdr != NULL) {
+        int self = (int)getpid();
+        atomic_compare_exchange_strong(&s->hdr->producer_pid, &self, 0);
+        self = (int)getpid();
+        atomic_compare_exchange_strong(&s->hdr->consumer_pid, &self, 0);
+        munmap(s->hdr, s->map_size);
+    }
+    memset(s, 0, sizeof(*s));
+}
+
+bool ring_shm_unlink(const char *name) {
+    return shm_unlink(name) == 0;
+}
+
+/* Same semantics as ring_push(); only the producer process may call it */
+bool ring_shm_push(ring_shm_t *s, uint8_t *src, size_t len) {
+    ring_shm_header_t *hdr = s->hdr;
+    uint64_t head = atomic_load_explicit(&hdr->head, memory_order_relaxed);
+
+    if (len > s->capacity - (head - hdr->cached_tail)) {
+        hdr->cached_tail = atomic_load_explicit(&hdr->tail, memory_order_acquire);
+        if (len > s->capacity - (head - hdr->cached_tail)) return false;
+    }
+
+    ring_region_copy_in(s->copy, s->data, s->capacity, (size_t)(head & s->mask), src, len);
+
+    atomic_store_explicit(&hdr->head, head + len, memory_order_release);
+    return true;
+}
+
+/* Same semantics as ring_pop(); only the consumer process may call it */
+bool ring_shm_pop(ring_shm_t *s, uint8_t *dst, size_t len) {
+    ring_shm_header_t *hdr = s->hdr;
+    uint64_t tail = atomic_load_explicit(&hdr->tail, memory_order_relaxed);
+
+    if (len > hdr->cached_head - tail) {
+        hdr->cached_head = atomic_load_explicit(&hdr->head, memory_order_acquire);
+        if (len > hdr->cached_head - tail) return false;
+    }
+
+    ring_region_copy_out(s->copy, s->data, s->capacity, (size_t)(tail & s->mask), dst, len);
+
+    atomic_store_explicit(&hdr->tail, tail + len, memory_order_release);
+    return true;
+}
+
+#endif /* RING_SHM_C */
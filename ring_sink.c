@@ -0,0 +1,294 @@
+#ifndef RING_SINK_C
+#define RING_SINK_C
+
+#include "ring_buffer.c"
+
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+/*
+ * Drain a ring straight to a file descriptor, with the ring memory itself
+ * as the I/O buffer: the readable region goes to the kernel as an iovec of
+ * its (at most two) wrap segments, and the tail only moves past bytes the
+ * kernel has actually written. The producer can't reuse that space until
+ * then, so nothing is copied into a staging buffer first.
+ *
+ * ring_writev() is the synchronous form: one writev() per call. ring_sink_t
+ * adds an io_uring mode (raw syscalls, no liburing) that keeps one write in
+ * flight per ring: ring_sink_submit() queues everything readable,
+ * ring_sink_complete() consumes it when the completion arrives, and the
+ * consumer thread is free in between. Short writes consume what was
+ * written; the rest goes out with the next submission.
+ *
+ * The sink is the ring's consumer: nothing else may pop from it.
+ */
+typedef enum {
+    RING_SINK_WRITEV,       /* writev() from ring_sink_submit() */
+    RING_SINK_IO_URING      /* IORING_OP_WRITEV, tail advanced on completion */
+} ring_sink_mode_t;
+
+typedef struct {
+    ring_buffer_t *rb;
+    int fd;
+    ring_sink_mode_t mode;
+    int error;              /* errno of the first failed write; 0 if none */
+    size_t in_flight;       /* io_uring: bytes submitted but not completed */
+    struct iovec iov[2];    /* The in-flight write; the kernel may read it late */
+
+#ifdef __linux__
+    int uring_fd;
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;           /* == sq_map with IORING_FEAT_SINGLE_MMAP */
+    size_t cq_map_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    _Atomic unsigned *sq_tail;
+    unsigned sq_mask;
+    unsigned *sq_array;
+    _Atomic unsigned *cq_head;
+    _Atomic unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+#endif
+} ring_sink_t;
+
+/* ============ writev ============ */
+
+typedef struct {
+    int fd;
+    ssize_t result;
+} ring_writev_ctx_t;
+
+static size_t ring_writev_span(const ring_span_t *span, void *ctx) {
+    ring_writev_ctx_t *c = (ring_writev_ctx_t *)ctx;
+    struct iovec iov[2] = {
+        { span->first, span->first_len },
+        { span->second, span->second_len }
+    };
+
+    do {
+        c->result = writev(c->fd, iov, span->second_len > 0 ? 2 : 1);
+    } while (c->result < 0 && errno == EINTR);
+    return c->result < 0 ? 0 : (size_t)c->result;
+}
+
+/*
+ * Consumer: write up to `max` readable bytes to `fd` with one writev() of
+ * the ring's own segments, then consume what the kernel took. Returns the
+ * bytes written, 0 if the ring is empty, or -1 with errno set (EAGAIN on a
+ * full non-blocking socket, say), in which case nothing is consumed.
+ */
+ssize_t ring_writev(ring_buffer_t *rb, int fd, size_t max) {
+    ring_writev_ctx_t ctx = { fd, 0 };
+    ring_drain(rb, max, ring_writev_span, &ctx);
+    return ctx.result;
+}
+
+/* ============ Sink ============ */
+
+#ifdef __linux__
+static void ring_sink_unmap(ring_sink_t *s) {
+    if (s->sqes != NULL) munmap(s->sqes, s->sqes_size);
+    if (s->cq_map != NULL && s->cq_map != s->sq_map) munmap(s->cq_map, s->cq_map_size);
+    if (s->sq_map != NULL) munmap(s->sq_map, s->sq_map_size);
+    if (s->uring_fd >= 0) close(s->uring_fd);
+    s->sqes = NULL;
+    s->cq_map = s->sq_map = NULL;
+    s->uring_fd = -1;
+}
+
+static void *ring_sink_mmap(int fd, size_t size, off_t offset) {
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+/* Set up a two-entry io_uring; the sink only ever has one write in flight */
+static bool ring_sink_setup_uring(ring_sink_t *s) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    int fd = (int)syscall(__NR_io_uring_setup, 2, &p);
+    if (fd < 0) return false;
+    s->uring_fd = fd;
+
+    /* Writes at the file position need offset -1 (kernel 5.6+) */
+    if (!(p.features & IORING_FEAT_RW_CUR_POS)) goto fail;
+
+    s->sq_map_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    s->cq_map_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (s->cq_map_size > s->sq_map_size) s->sq_map_size = s->cq_map_size;
+        s->cq_map_size = s->sq_map_size;
+    }
+
+    s->sq_map = ring_sink_mmap(fd, s->sq_map_size, IORING_OFF_SQ_RING);
+    if (s->sq_map == NULL) goto fail;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        s->cq_map = s->sq_map;
+    } else {
+        s->cq_map = ring_sink_mmap(fd, s->cq_map_size, IORING_OFF_CQ_RING);
+        if (s->cq_map == NULL) goto fail;
+    }
+    s->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    s->sqes = ring_sink_mmap(fd, s->sqes_size, IORING_OFF_SQES);
+    if (s->sqes == NULL) goto fail;
+
+    uint8_t *sq = s->sq_map;
+    uint8_t *cq = s->cq_map;
+    s->sq_tail = (_Atomic unsigned *)(void *)(sq + p.sq_off.tail);
+    s->sq_mask = *(unsigned *)(void *)(sq + p.sq_off.ring_mask);
+    s->sq_array = (unsigned *)(void *)(sq + p.sq_off.array);
+    s->cq_head = (_Atomic unsigned *)(void *)(cq + p.cq_off.head);
+    s->cq_tail = (_Atomic unsigned *)(void *)(cq + p.cq_off.tail);
+    s->cq_mask = *(unsigned *)(void *)(cq + p.cq_off.ring_mask);
+    s->cqes = (struct io_uring_cqe *)(void *)(cq + p.cq_off.cqes);
+    return true;
+
+fail:
+    ring_sink_unmap(s);
+    return false;
+}
+#endif
+
+/*
+ * Attach a sink to `rb` (whose consumer it becomes) writing to `fd`.
+ * RING_SINK_IO_URING returns false if io_uring is unavailable (not Linux,
+ * kernel too old, or blocked by seccomp); fall back to RING_SINK_WRITEV.
+ */
+bool ring_sink_init(ring_sink_t *s, ring_buffer_t *rb, int fd, ring_sink_mode_t mode) {
+    memset(s, 0, sizeof(*s));
+    s->rb = rb;
+    s->fd = fd;
+    s->mode = mode;
+#ifdef __linux__
+    s->uring_fd = -1;
+    if (mode == RING_SINK_IO_URING) return ring_sink_setup_uring(s);
+    return true;
+#else
+    return mode == RING_SINK_WRITEV;
+#endif
+}
+
+/*
+ * Write everything readable. With writev this happens now and the bytes
+ * are consumed on return; with io_uring it is queued, unless a write is
+ * already in flight, and consumed by ring_sink_complete(). Returns false
+ * once a write has failed (`error` holds the errno).
+ */
+bool ring_sink_submit(ring_sink_t *s) {
+    if (s->error != 0) return false;
+
+    if (s->mode == RING_SINK_WRITEV) {
+        if (ring_writev(s->rb, s->fd, SIZE_MAX) < 0 && errno != EAGAIN) s->error = errno;
+        return s->error == 0;
+    }
+
+#ifdef __linux__
+    if (s->in_flight > 0) return true;
+
+    ring_buffer_t *rb = s->rb;
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t n = ring_readable(rb, tail, rb->capacity);
+    if (n == 0) return true;
+
+    ring_span_t span;
+    ring_span_at(rb, tail & rb->mask, n, &span);
+    s->iov[0] = (struct iovec){ span.first, span.first_len };
+    s->iov[1] = (struct iovec){ span.second, span.second_len };
+
+    unsigned sq_tail = atomic_load_explicit(s->sq_tail, memory_order_relaxed);
+    unsigned idx = sq_tail & s->sq_mask;
+    struct io_uring_sqe *sqe = &s->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = s->fd;
+    sqe->addr = (uint64_t)(uintptr_t)s->iov;
+    sqe->len = span.second_len > 0 ? 2 : 1;
+    sqe->off = (uint64_t)-1;        /* Current file position; ignored for sockets and pipes */
+    s->sq_array[idx] = idx;
+    atomic_store_explicit(s->sq_tail, sq_tail + 1, memory_order_release);
+
+    while (syscall(__NR_io_uring_enter, s->uring_fd, 1, 0, 0, NULL, 0) < 0) {
+        if (errno != EINTR) {
+            s->error = errno;
+            return false;
+        }
+    }
+    s->in_flight = n;
+#endif
+    return true;
+}
+
+/*
+ * io_uring: consume the bytes of a finished write, first waiting for it if
+ * `wait`. A no-op with nothing in flight or in writev mode. Returns false
+ * once a write has failed.
+ */
+bool ring_sink_complete(ring_sink_t *s, bool wait) {
+#ifdef __linux__
+    if (s->mode == RING_SINK_IO_URING && s->in_flight > 0) {
+        unsigned head = atomic_load_explicit(s->cq_head, memory_order_relaxed);
+        while (head == atomic_load_explicit(s->cq_tail, memory_order_acquire)) {
+            if (!wait) return s->error == 0;
+            if (syscall(__NR_io_uring_enter, s->uring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+                errno != EINTR) {
+                s->error = errno;
+                return false;
+            }
+        }
+
+        int res = s->cqes[head & s->cq_mask].res;
+        atomic_store_explicit(s->cq_head, head + 1, memory_order_release);
+        s->in_flight = 0;
+
+        if (res >= 0) {
+            ring_release(s->rb, (size_t)res);
+        } else if (res != -EAGAIN && res != -EINTR) {
+            s->error = -res;
+        }
+    }
+#else
+    (void)wait;
+#endif
+    return s->error == 0;
+}
+
+/* Non-blocking step for a consumer loop: reap a finished write, queue more */
+bool ring_sink_poll(ring_sink_t *s) {
+    return ring_sink_complete(s, false) && ring_sink_submit(s);
+}
+
+/*
+ * Block until everything readable at the time of the call, and anything
+ * published meanwhile, is written. Returns false on a write error.
+ */
+bool ring_sink_flush(ring_sink_t *s) {
+    for (;;) {
+        if (!ring_sink_submit(s)) return false;
+        if (s->in_flight == 0 && ring_used(s->rb) == 0) return true;
+        if (!ring_sink_complete(s, true)) return false;
+    }
+}
+
+/* Bytes handed to the kernel whose write hasn't completed yet */
+size_t ring_sink_in_flight(const ring_sink_t *s) {
+    return s->in_flight;
+}
+
+/* Wait for an in-flight write (the kernel may still be reading the ring), then release */
+void ring_sink_destroy(ring_sink_t *s) {
+    ring_sink_complete(s, true);
+#ifdef __linux__
+    ring_sink_unmap(s);
+#endif
+}
+
+#endif /* RING_SINK_C */
@@ -0,0 +1,62 @@
+#ifndef RING_TYPED_C
+#define RING_TYPED_C
+
+#include "ring_buffer.c"
+
+/*
+ * Compile-time typed SPSC rings for fixed-size messages.
+ *
+ *   RING_DEFINE(order_ring, order_event_t, 1024)
+ *
+ * emits `order_ring_t` with slot-indexed storage for 1024 `order_event_t`s
+ * and `order_ring_init/push/pop`. Capacity and element size are constants,
+ * so there is no length check and each copy is a struct assignment the
+ * compiler can unroll and vectorize. head and tail are free-running slot
+ * counters with the same cached-remote-counter scheme as ring_buffer_t, so a
+ * ring holds all `capacity` elements.
+ *
+ * The storage is inline: declare rings static or allocate them with
+ * aligned_alloc(CACHE_LINE, ...) rather than on a thread's stack.
+ */
+#define RING_DEFINE(name, type, capacity)                                          \
+    _Static_assert((capacity) >= 2 && ((capacity) & ((capacity) - 1)) == 0,        \
+                   #name ": capacity must be a power of two >= 2");                \
+                                                                                   \
+    typedef struct name {                                                          \
+        alignas(CACHE_LINE) atomic_size_t head;                                    \
+        size_t cached_tail;                                                        \
+        alignas(CACHE_LINE) atomic_size_t tail;                                    \
+        size_t cached_head;                                                        \
+        alignas(CACHE_LINE) type slots[capacity];                                  \
+    } name##_t;                                                                    \
+                                                                                   \
+    static inline void name##_init(name##_t *r) {                                  \
+        atomic_init(&r->head, 0);                                                  \
+        atomic_init(&r->tail, 0);                                                  \
+        r->cached_tail = 0;                                                        \
+        r->cached_head = 0;                                                        \
+    }                                                                              \
+                                                                                   \
+    static inline bool name##_push(name##_t *r, const type *src) {                 \
+        size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);        \
+        if (head - r->cached_tail == (capacity)) {                                 \
+            r->cached_tail = atomic_load_explicit(&r->tail, memory_order_acquire); \
+            if (head - r->cached_tail == (capacity)) return false;                 \
+        }                                                                          \
+        r->slots[head & ((capacity) - 1)] = *src;                                  \
+        atomic_store_explicit(&r->head, head + 1, memory_order_release);           \
+        return true;                                                               \
+    }                                                                              \
+                                                                                   \
+    static inline bool name##_pop(name##_t *r, type *dst) {                        \
+        size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);        \
+        if (tail == r->cached_head) {                                              \
+            r->cached_head = atomic_load_explicit(&r->head, memory_order_acquire); \
+            if (tail == r->cached_head) return false;                              \
+        }                                                                          \
+        *dst = r->slots[tail & ((capacity) - 1)];                                  \
+        atomic_store_explicit(&r->tail, tail + 1, memory_order_release);           \
+        return true;                                                               \
+    }
+
+#endif /* RING_TYPED_C */
@@ -0,0 +1,153 @@
+#ifndef RING_WAIT_C
+#define RING_WAIT_C
+
+#include "ring_buffer.c"
+
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Blocking push/pop on top of an SPSC ring with pluggable wait strategies.
+ *
+ * Every strategy first polls the ring `spins` times. After that:
+ *   RING_WAIT_SPIN   keeps polling (lowest latency, burns a core)
+ *   RING_WAIT_PAUSE  polls with a CPU relax hint between attempts
+ *   RING_WAIT_YIELD  calls sched_yield() between attempts
+ *   RING_WAIT_FUTEX  sleeps on a futex until the other side makes progress
+ *
+ * For RING_WAIT_FUTEX a side that is about to sleep raises its `sleeping`
+ * flag and re-checks the ring; the other side only makes the wake syscall
+ * when it sees that flag after publishing, so the fast path has no
+ * syscalls. The flag store and the publish are each followed by a seq_cst
+ * fence (Dekker-style), so at least one side sees the other and a wakeup
+ * can't be lost. Non-Linux builds fall back to sched_yield() for the sleep.
+ */
+typedef enum {
+    RING_WAIT_SPIN,
+    RING_WAIT_PAUSE,
+    RING_WAIT_YIELD,
+    RING_WAIT_FUTEX
+} ring_wait_strategy_t;
+
+typedef struct {
+    atomic_uint seq;        /* Futex word, bumped on every wake */
+    atomic_uint sleeping;   /* Set while this side is (about to be) asleep */
+} ring_sleeper_t;
+
+typedef struct {
+    ring_wait_strategy_t strategy;
+    unsigned spins;
+
+    /* Written by the side that sleeps, read by the side that wakes it */
+    alignas(CACHE_LINE) ring_sleeper_t producer;
+    alignas(CACHE_LINE) ring_sleeper_t consumer;
+} ring_wait_t;
+
+#define RING_WAIT_DEFAULT_SPINS 256
+
+void ring_wait_init(ring_wait_t *w, ring_wait_strategy_t strategy, unsigned spins) {
+    memset(w, 0, sizeof(*w));
+    w->strategy = strategy;
+    w->spins = spins;
+    atomic_init(&w->producer.seq, 0);
+    atomic_init(&w->producer.sleeping, 0);
+    atomic_init(&w->consumer.seq, 0);
+    atomic_init(&w->consumer.sleeping, 0);
+}
+
+static void ring_futex_wait(atomic_uint *word, unsigned expected) {
+#ifdef __linux__
+    syscall(SYS_futex, (unsigned *)word, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#else
+    (void)word;
+    (void)expected;
+    sched_yield();
+#endif
+}
+
+static void ring_futex_wake(atomic_uint *word) {
+#ifdef __linux__
+    syscall(SYS_futex, (unsigned *)word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+/* Wake the other side if it went to sleep; called after every publish */
+static inline void ring_wait_notify(ring_wait_t *w, ring_sleeper_t *s) {
+    if (w->strategy != RING_WAIT_FUTEX) return;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&s->sleeping, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&s->seq, 1, memory_order_relaxed);
+        ring_futex_wake(&s->seq);
+    }
+}
+
+/* One back-off step after the initial spins for a side that can't proceed */
+static void ring_wait_idle(ring_wait_t *w, ring_sleeper_t *self, bool (*ready)(ring_buffer_t *, size_t),
+                           ring_buffer_t *rb, size_t len) {
+    switch (w->strategy) {
+    case RING_WAIT_SPIN:
+        break;
+    case RING_WAIT_PAUSE:
+        ring_cpu_relax();
+        break;
+    case RING_WAIT_YIELD:
+        sched_yield();
+        break;
+    case RING_WAIT_FUTEX: {
+        unsigned seq = atomic_load_explicit(&self->seq, memory_order_relaxed);
+        atomic_store_explicit(&self->sleeping, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!ready(rb, len)) ring_futex_wait(&self->seq, seq);
+        atomic_store_explicit(&self->sleeping, 0, memory_order_relaxed);
+        break;
+    }
+    }
+}
+
+static bool ring_wait_can_push(ring_buffer_t *rb, size_t len) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    return len <= ring_writable(rb, head, len);
+}
+
+static bool ring_wait_can_pop(ring_buffer_t *rb, size_t len) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    return len <= ring_readable(rb, tail, len);
+}
+
+/*
+ * Producer: push `len` bytes, waiting for space according to the strategy.
+ * Returns false only if `len` can never fit (more than capacity).
+ */
+bool ring_push_wait(ring_buffer_t *rb, ring_wait_t *w, uint8_t *src, size_t len) {
+    if (len > rb->capacity) return false;
+
+    for (unsigned i = 0; !ring_push(rb, src, len); i++) {
+        if (i >= w->spins) ring_wait_idle(w, &w->producer, ring_wait_can_push, rb, len);
+    }
+    ring_wait_notify(w, &w->consumer);
+    return true;
+}
+
+/*
+ * Consumer: pop `len` bytes, waiting for data according to the strategy.
+ * Returns false only if `len` can never be available.
+ */
+bool ring_pop_wait(ring_buffer_t *rb, ring_wait_t *w, uint8_t *dst, size_t len) {
+    if (len > rb->capacity) return false;
+
+    for (unsigned i = 0; !ring_pop(rb, dst, len); i++) {
+        if (i >= w->spins) ring_wait_idle(w, &w->consumer, ring_wait_can_pop, rb, len);
+    }
+    ring_wait_notify(w, &w->producer);
+    return true;
+}
+
+#endif /* RING_WAIT_C */
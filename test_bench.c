@@ -1,8 +1,19 @@
 /*
  * Performance benchmarks for ring buffer
  * Measures throughput and latency in SPSC scenarios
+ *
+ * Without arguments runs the full suite as text. See usage() for the
+ * harness options (sizes, counts, capacity, CPU pinning, repetitions,
+ * JSON/CSV output).
  */
 
+#define _GNU_SOURCE     /* pthread_attr_setaffinity_np, CPU_SET */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,13 +23,103 @@
 #include <unistd.h>
 
 #include "ring_buffer.c"
+#include "ring_mpsc.c"
+#include "ring_mpmc.c"
+#include "ring_broadcast.c"
+#include "ring_wait.c"
+#include "ring_mirror.c"
+#include "ring_alloc.c"
+#include "ring_typed.c"
+#include "ring_hist.c"
+#include "ring_clock.c"
+#include "ring_lossy.c"
+#include "ring_log.c"
+#include "ring_sink.c"
+#include "ring_pipeline.c"
 
 /* ============ Helper ============ */
 
-static void init_buffer(ring_buffer_t *rb) {
-    memset(rb, 0, sizeof(*rb));
-    atomic_store(&rb->head, 0);
-    atomic_store(&rb->tail, 0);
+/* Large enough that a 512-byte burst does not fill the ring */
+#define BENCH_CAPACITY (64 * 1024)
+#define MAX_BENCH_THREADS 8
+#define MAX_BENCH_SIZES 16
+
+typedef enum {
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_JSON,
+    BENCH_FORMAT_CSV
+} bench_format_t;
+
+/* Command-line settings; zero / -1 fields mean "use the benchmark's default" */
+typedef struct {
+    size_t sizes[MAX_BENCH_SIZES];
+    size_t num_sizes;
+    size_t count;
+    size_t capacity;
+    int producer_cpu;
+    int consumer_cpu;
+    size_t depth;
+    size_t pairs;
+    int topology;       /* bench_topology_t */
+    unsigned hints;     /* RING_HINT_* set on every benchmark ring */
+    const char *kernel; /* Copy kernel for every benchmark ring; NULL = best */
+    size_t warmup;
+    size_t reps;
+    bench_format_t format;
+    const char *benches;
+} bench_config_t;
+
+static bench_config_t bench_cfg = {
+    .sizes = { 8, 64, 256 },
+    .num_sizes = 3,
+    .producer_cpu = -1,
+    .consumer_cpu = -1,
+    .depth = 1,
+    .pairs = 4,
+    .warmup = 1,
+    .reps = 5,
+    .format = BENCH_FORMAT_TEXT
+};
+
+static size_t bench_capacity(size_t fallback) {
+    return bench_cfg.capacity != 0 ? bench_cfg.capacity : fallback;
+}
+
+/* pthread_create(), pinned to `cpu` unless it is negative */
+static void bench_spawn(pthread_t *thread, void *(*fn)(void *), void *arg, int cpu) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+    int err = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        fprintf(stderr, "pthread_create failed (cpu %d): %s\n", cpu, strerror(err));
+        exit(1);
+    }
+}
+
+static void spawn_producer(pthread_t *thread, void *(*fn)(void *), void *arg) {
+    bench_spawn(thread, fn, arg, bench_cfg.producer_cpu);
+}
+
+static void spawn_consumer(pthread_t *thread, void *(*fn)(void *), void *arg) {
+    bench_spawn(thread, fn, arg, bench_cfg.consumer_cpu);
+}
+
+static void init_buffer(ring_buffer_t *rb, size_t capacity) {
+    if (!ring_init(rb, capacity, NULL)) {
+        fprintf(stderr, "ring_init(%zu) failed\n", capacity);
+        exit(1);
+    }
+    /* Pre-fault the data region so the first lap doesn't pay page faults */
+    memset(rb->data, 0, capacity);
+    ring_set_hints(rb, bench_cfg.hints);
+    if (bench_cfg.kernel != NULL) ring_set_copy_kernel(rb, bench_cfg.kernel);
 }
 
 /* ============ Timing Utilities ============ */
@@ -29,12 +130,80 @@ static inline uint64_t get_nanos(void) {
     return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 }
 
+/* Per-message timestamps; calibrated once in main() */
+static ring_clock_t bench_clock;
+
+/* Cost of taking one timestamp, for each way of taking it */
+static void bench_clock_overhead(void) {
+    const size_t calls = 10000000;
+    volatile uint64_t sink = 0;
+
+    uint64_t start = get_nanos();
+    for (size_t i = 0; i < calls; i++) sink = get_nanos();
+    double gettime_ns = (double)(get_nanos() - start) / (double)calls;
+
+    start = get_nanos();
+    for (size_t i = 0; i < calls; i++) sink = ring_clock_now(&bench_clock);
+    double now_ns = (double)(get_nanos() - start) / (double)calls;
+
+    start = get_nanos();
+    for (size_t i = 0; i < calls; i++) sink = ring_clock_now_ordered(&bench_clock);
+    double ordered_ns = (double)(get_nanos() - start) / (double)calls;
+    (void)sink;
+
+    printf("  source: %s (%.4f ns/tick)\n", ring_clock_name(&bench_clock), bench_clock.ns_per_tick);
+    printf("  clock_gettime: %5.1f ns  ring_clock_now: %5.1f ns  ring_clock_now_ordered: %5.1f ns\n",
+           gettime_ns, now_ns, ordered_ns);
+}
+
+/* ============ Statistics ============ */
+
+typedef struct {
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+} bench_summary_t;
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts `v` in place; stddev is the sample standard deviation */
+static bench_summary_t summarize(double *v, size_t n) {
+    qsort(v, n, sizeof(*v), compare_doubles);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += v[i];
+    double mean = sum / (double)n;
+
+    double sq = 0.0;
+    for (size_t i = 0; i < n; i++) sq += (v[i] - mean) * (v[i] - mean);
+
+    bench_summary_t s = {
+        .median = n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0,
+        .mean = mean,
+        .stddev = n > 1 ? sqrt(sq / (double)(n - 1)) : 0.0,
+        .min = v[0],
+        .max = v[n - 1]
+    };
+    return s;
+}
+
 /* ============ Throughput Benchmark ============ */
 
+typedef bool (*push_fn_t)(ring_buffer_t *rb, uint8_t *src, size_t len);
+typedef bool (*pop_fn_t)(ring_buffer_t *rb, uint8_t *dst, size_t len);
+
 typedef struct {
     ring_buffer_t *rb;
     size_t num_messages;
     size_t message_size;
+    push_fn_t push;
+    pop_fn_t pop;
     atomic_bool *done;
 } bench_args_t;
 
@@ -43,10 +212,11 @@ static void *throughput_producer(void *arg) {
     uint8_t *data = calloc(1, args->message_size);
 
     for (size_t i = 0; i < args->num_messages; i++) {
-        while (!ring_push(args->rb, data, args->message_size)) {
+        while (!args->push(args->rb, data, args->message_size)) {
             /* Spin */
         }
     }
+    ring_flush(args->rb);   /* For staged_push; a no-op otherwise */
 
     free(data);
     return NULL;
@@ -57,7 +227,7 @@ static void *throughput_consumer(void *arg) {
     uint8_t *data = calloc(1, args->message_size);
 
     for (size_t i = 0; i < args->num_messages; i++) {
-        while (!ring_pop(args->rb, data, args->message_size)) {
+        while (!args->pop(args->rb, data, args->message_size)) {
             /* Spin */
         }
     }
@@ -67,16 +237,17 @@ static void *throughput_consumer(void *arg) {
     return NULL;
 }
 
-static void bench_throughput(size_t message_size, size_t num_messages) {
-    ring_buffer_t rb;
-    init_buffer(&rb);
-
+/* Run one producer/consumer pair over an initialized ring; returns elapsed ns */
+static uint64_t run_throughput_on(ring_buffer_t *rb, push_fn_t push, pop_fn_t pop,
+                                  size_t message_size, size_t num_messages) {
     atomic_bool done = false;
 
     bench_args_t args = {
-        .rb = &rb,
+        .rb = rb,
         .num_messages = num_messages,
         .message_size = message_size,
+        .push = push,
+        .pop = pop,
         .done = &done
     };
 
@@ -84,271 +255,2053 @@ static void bench_throughput(size_t message_size, size_t num_messages) {
 
     uint64_t start = get_nanos();
 
-    pthread_create(&producer, NULL, throughput_producer, &args);
-    pthread_create(&consumer, NULL, throughput_consumer, &args);
+    spawn_producer(&producer, throughput_producer, &args);
+    spawn_consumer(&consumer, throughput_consumer, &args);
 
     pthread_join(producer, NULL);
     pthread_join(consumer, NULL);
 
     uint64_t end = get_nanos();
-    uint64_t elapsed_ns = end - start;
+    return end - start;
+}
+
+/*
+ * Run one producer/consumer pair and return the elapsed time in ns. With
+ * `mirrored` the ring uses a double-mapped data region (no wrap handling).
+ */
+static uint64_t run_throughput(push_fn_t push, pop_fn_t pop, bool mirrored,
+                               size_t message_size, size_t num_messages) {
+    ring_buffer_t rb;
+    size_t capacity = bench_capacity(BENCH_CAPACITY);
+    if (mirrored) {
+        if (!ring_init_mirrored(&rb, capacity)) {
+            fprintf(stderr, "ring_init_mirrored(%zu) failed\n", capacity);
+            exit(1);
+        }
+        memset(rb.data, 0, capacity);
+    } else {
+        init_buffer(&rb, capacity);
+    }
+
+    uint64_t elapsed = run_throughput_on(&rb, push, pop, message_size, num_messages);
+    ring_destroy(&rb);
+    return elapsed;
+}
+
+static double mb_per_sec(size_t message_size, size_t num_messages, uint64_t elapsed_ns) {
+    double bytes = (double)message_size * (double)num_messages;
+    return bytes / ((double)elapsed_ns / 1e9) / (1024.0 * 1024.0);
+}
 
+static void print_throughput(size_t message_size, size_t num_messages, uint64_t elapsed_ns) {
     double elapsed_sec = (double)elapsed_ns / 1e9;
     double msgs_per_sec = (double)num_messages / elapsed_sec;
-    double bytes_per_sec = msgs_per_sec * (double)message_size;
     double ns_per_msg = (double)elapsed_ns / (double)num_messages;
 
     printf("  %3zu bytes x %8zu msgs: %10.2f msg/s  %7.2f MB/s  %6.1f ns/msg\n",
            message_size, num_messages, msgs_per_sec,
-           bytes_per_sec / (1024.0 * 1024.0), ns_per_msg);
+           mb_per_sec(message_size, num_messages, elapsed_ns), ns_per_msg);
 }
 
-/* ============ Latency Benchmark ============ */
+static void bench_throughput(size_t message_size, size_t num_messages) {
+    print_throughput(message_size, num_messages,
+                     run_throughput(ring_push, ring_pop, false, message_size, num_messages));
+}
+
+/* ============ Staged (Write-Combined) Throughput ============ */
+
+#define STAGED_FLUSH_BYTES 4096
+#define STAGED_FLUSH_MSGS 64
+
+static bool staged_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    return ring_push_staged(rb, src, len);
+}
+
+/* Like run_throughput(), with pushes published every 4 KiB or 64 messages */
+static uint64_t run_throughput_staged(size_t message_size, size_t num_messages) {
+    ring_buffer_t rb;
+    init_buffer(&rb, bench_capacity(BENCH_CAPACITY));
+    ring_set_coalesce(&rb, STAGED_FLUSH_BYTES, STAGED_FLUSH_MSGS);
+
+    uint64_t elapsed = run_throughput_on(&rb, staged_push, ring_pop, message_size, num_messages);
+    ring_destroy(&rb);
+    return elapsed;
+}
+
+static void bench_throughput_staged(size_t message_size, size_t num_messages) {
+    print_throughput(message_size, num_messages,
+                     run_throughput_staged(message_size, num_messages));
+}
+
+/* ============ Typed-Slot Throughput ============ */
 
 typedef struct {
-    ring_buffer_t *rb;
-    size_t num_samples;
-    size_t message_size;
-    uint64_t *send_times;
-    atomic_bool *ready;
-} latency_prod_args_t;
+    void *ring;
+    size_t num_messages;
+} typed_bench_args_t;
+
+/*
+ * One RING_DEFINE ring per message size, with the same byte capacity as the
+ * byte ring so the two sweeps are directly comparable.
+ */
+#define BENCH_TYPED_RING(size)                                                     \
+    typedef struct { uint8_t bytes[size]; } bench_msg##size##_t;                   \
+    RING_DEFINE(bench_ring##size, bench_msg##size##_t, BENCH_CAPACITY / (size))    \
+                                                                                   \
+    static void *typed_producer##size(void *arg) {                                 \
+        typed_bench_args_t *args = (typed_bench_args_t *)arg;                      \
+        bench_ring##size##_t *r = args->ring;                                      \
+        bench_msg##size##_t msg = {{0}};                                           \
+        for (size_t i = 0; i < args->num_messages; i++) {                          \
+            while (!bench_ring##size##_push(r, &msg)) {                            \
+                /* Spin */                                                         \
+            }                                                                      \
+        }                                                                          \
+        return NULL;                                                               \
+    }                                                                              \
+                                                                                   \
+    static void *typed_consumer##size(void *arg) {                                 \
+        typed_bench_args_t *args = (typed_bench_args_t *)arg;                      \
+        bench_ring##size##_t *r = args->ring;                                      \
+        bench_msg##size##_t msg;                                                   \
+        for (size_t i = 0; i < args->num_messages; i++) {                          \
+            while (!bench_ring##size##_pop(r, &msg)) {                             \
+                /* Spin */                                                         \
+            }                                                                      \
+        }                                                                          \
+        return NULL;                                                               \
+    }                                                                              \
+                                                                                   \
+    static void bench_throughput_typed##size(size_t num_messages) {                \
+        bench_ring##size##_t *r = aligned_alloc(CACHE_LINE, sizeof(*r));           \
+        if (r == NULL) {                                                           \
+            fprintf(stderr, "typed ring allocation failed\n");                     \
+            exit(1);                                                               \
+        }                                                                          \
+        memset(r, 0, sizeof(*r));                                                  \
+        bench_ring##size##_init(r);                                                \
+                                                                                   \
+        typed_bench_args_t args = { .ring = r, .num_messages = num_messages };     \
+        pthread_t producer, consumer;                                              \
+                                                                                   \
+        uint64_t start = get_nanos();                                              \
+        spawn_producer(&producer, typed_producer##size, &args);                    \
+        spawn_consumer(&consumer, typed_consumer##size, &args);                    \
+        pthread_join(producer, NULL);                                              \
+        pthread_join(consumer, NULL);                                              \
+        uint64_t end = get_nanos();                                                \
+                                                                                   \
+        print_throughput(size, num_messages, end - start);                         \
+        free(r);                                                                   \
+    }
+
+BENCH_TYPED_RING(8)
+BENCH_TYPED_RING(64)
+BENCH_TYPED_RING(256)
+
+/* ============ Batched Throughput ============ */
 
 typedef struct {
     ring_buffer_t *rb;
-    size_t num_samples;
+    size_t num_messages;
     size_t message_size;
-    uint64_t *recv_times;
-    atomic_bool *ready;
-} latency_cons_args_t;
+    size_t batch;
+} batch_args_t;
 
-static void *latency_producer(void *arg) {
-    latency_prod_args_t *args = (latency_prod_args_t *)arg;
-    uint8_t *data = calloc(1, args->message_size);
+static void *batch_producer(void *arg) {
+    batch_args_t *args = (batch_args_t *)arg;
+    uint8_t *data = calloc(args->batch, args->message_size);
+    ring_iovec_t *iov = malloc(args->batch * sizeof(*iov));
 
-    while (!atomic_load(args->ready)) {
-        sched_yield();
+    for (size_t k = 0; k < args->batch; k++) {
+        iov[k].base = data + k * args->message_size;
+        iov[k].len = args->message_size;
     }
 
-    for (size_t i = 0; i < args->num_samples; i++) {
-        args->send_times[i] = get_nanos();
-        memcpy(data, &i, sizeof(i));
-
-        while (!ring_push(args->rb, data, args->message_size)) {
-            /* Spin */
+    size_t remaining = args->num_messages;
+    while (remaining > 0) {
+        size_t n = remaining < args->batch ? remaining : args->batch;
+        size_t done = 0;
+        while (done < n) {
+            done += ring_push_batch(args->rb, iov + done, n - done);
         }
-
-        /* Small delay to avoid overwhelming */
-        for (volatile int j = 0; j < 100; j++);
+        remaining -= n;
     }
 
+    free(iov);
     free(data);
     return NULL;
 }
 
-static void *latency_consumer(void *arg) {
-    latency_cons_args_t *args = (latency_cons_args_t *)arg;
-    uint8_t *data = calloc(1, args->message_size);
+static void *batch_consumer(void *arg) {
+    batch_args_t *args = (batch_args_t *)arg;
+    uint8_t *data = calloc(args->batch, args->message_size);
+    ring_iovec_t *iov = malloc(args->batch * sizeof(*iov));
 
-    atomic_store(args->ready, true);
+    for (size_t k = 0; k < args->batch; k++) {
+        iov[k].base = data + k * args->message_size;
+        iov[k].len = args->message_size;
+    }
 
-    for (size_t i = 0; i < args->num_samples; i++) {
-        while (!ring_pop(args->rb, data, args->message_size)) {
-            /* Spin */
-        }
-        args->recv_times[i] = get_nanos();
+    size_t remaining = args->num_messages;
+    while (remaining > 0) {
+        size_t n = remaining < args->batch ? remaining : args->batch;
+        remaining -= ring_pop_batch(args->rb, iov, n);
     }
 
+    free(iov);
     free(data);
     return NULL;
 }
 
-static int compare_uint64(const void *a, const void *b) {
-    uint64_t ua = *(const uint64_t *)a;
-    uint64_t ub = *(const uint64_t *)b;
-    return (ua > ub) - (ua < ub);
-}
-
-static void bench_latency(size_t message_size, size_t num_samples) {
+/* Elapsed ns for num_messages moved in batches of `batch` */
+static uint64_t run_throughput_batch(size_t message_size, size_t num_messages, size_t batch) {
     ring_buffer_t rb;
-    init_buffer(&rb);
-
-    uint64_t *send_times = malloc(num_samples * sizeof(uint64_t));
-    uint64_t *recv_times = malloc(num_samples * sizeof(uint64_t));
-    uint64_t *latencies = malloc(num_samples * sizeof(uint64_t));
-    atomic_bool ready = false;
+    init_buffer(&rb, bench_capacity(BENCH_CAPACITY));
 
-    latency_prod_args_t prod_args = {
+    batch_args_t args = {
         .rb = &rb,
-        .num_samples = num_samples,
+        .num_messages = num_messages,
         .message_size = message_size,
-        .send_times = send_times,
-        .ready = &ready
+        .batch = batch
     };
 
-    latency_cons_args_t cons_args = {
+    pthread_t producer, consumer;
+
+    uint64_t start = get_nanos();
+
+    spawn_producer(&producer, batch_producer, &args);
+    spawn_consumer(&consumer, batch_consumer, &args);
+
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    uint64_t elapsed_ns = get_nanos() - start;
+    ring_destroy(&rb);
+    return elapsed_ns;
+}
+
+static void bench_throughput_batch(size_t message_size, size_t num_messages, size_t batch) {
+    uint64_t elapsed_ns = run_throughput_batch(message_size, num_messages, batch);
+
+    double msgs_per_sec = (double)num_messages / ((double)elapsed_ns / 1e9);
+    double ns_per_msg = (double)elapsed_ns / (double)num_messages;
+
+    printf("  %3zu bytes x %8zu msgs (batch %3zu): %10.2f msg/s  %7.2f MB/s  %6.1f ns/msg\n",
+           message_size, num_messages, batch, msgs_per_sec,
+           mb_per_sec(message_size, num_messages, elapsed_ns), ns_per_msg);
+}
+
+/* ============ Drained Throughput ============ */
+
+/* Consumer takes everything readable per pass: one tail publish per drain */
+static void *drain_consumer(void *arg) {
+    bench_args_t *args = (bench_args_t *)arg;
+    size_t chunk = args->rb->capacity;
+    uint8_t *data = malloc(chunk);
+    size_t remaining = args->num_messages * args->message_size;
+
+    while (remaining > 0) {
+        remaining -= ring_pop_available(args->rb, data, remaining < chunk ? remaining : chunk);
+    }
+
+    free(data);
+    atomic_store(args->done, true);
+    return NULL;
+}
+
+/* Like run_throughput(), with the consumer draining the backlog per pass */
+static uint64_t run_throughput_drain(size_t message_size, size_t num_messages) {
+    ring_buffer_t rb;
+    init_buffer(&rb, bench_capacity(BENCH_CAPACITY));
+
+    atomic_bool done = false;
+    bench_args_t args = {
         .rb = &rb,
-        .num_samples = num_samples,
+        .num_messages = num_messages,
         .message_size = message_size,
-        .recv_times = recv_times,
-        .ready = &ready
+        .push = ring_push,
+        .done = &done
     };
 
     pthread_t producer, consumer;
 
-    pthread_create(&consumer, NULL, latency_consumer, &cons_args);
-    pthread_create(&producer, NULL, latency_producer, &prod_args);
+    uint64_t start = get_nanos();
+
+    spawn_producer(&producer, throughput_producer, &args);
+    spawn_consumer(&consumer, drain_consumer, &args);
 
     pthread_join(producer, NULL);
     pthread_join(consumer, NULL);
 
-    for (size_t i = 0; i < num_samples; i++) {
-        latencies[i] = recv_times[i] - send_times[i];
+    uint64_t elapsed_ns = get_nanos() - start;
+    ring_destroy(&rb);
+    return elapsed_ns;
+}
+
+static void bench_throughput_drain(size_t message_size, size_t num_messages) {
+    print_throughput(message_size, num_messages, run_throughput_drain(message_size, num_messages));
+}
+
+/* ============ MPSC Throughput ============ */
+
+typedef struct {
+    ring_mpsc_t *q;
+    size_t num_messages;
+    size_t message_size;
+} mpsc_bench_args_t;
+
+static void *mpsc_bench_producer(void *arg) {
+    mpsc_bench_args_t *args = (mpsc_bench_args_t *)arg;
+    uint8_t *data = calloc(1, args->message_size);
+
+    for (size_t i = 0; i < args->num_messages; i++) {
+        while (!ring_mpsc_push(args->q, data, args->message_size)) {
+            /* Spin */
+        }
+    }
+
+    free(data);
+    return NULL;
+}
+
+static void bench_throughput_mpsc(size_t message_size, size_t num_messages, size_t producers) {
+    ring_mpsc_t q;
+    if (!ring_mpsc_init(&q, BENCH_CAPACITY, NULL)) {
+        fprintf(stderr, "ring_mpsc_init failed\n");
+        exit(1);
     }
+    memset(q.ring.data, 0, BENCH_CAPACITY);
 
-    qsort(latencies, num_samples, sizeof(uint64_t), compare_uint64);
+    size_t per_producer = num_messages / producers;
+    size_t total = per_producer * producers;
+    mpsc_bench_args_t args = { &q, per_producer, message_size };
+    pthread_t threads[MAX_BENCH_THREADS];
+    uint8_t *data = calloc(1, message_size);
 
-    uint64_t min = latencies[0];
-    uint64_t p50 = latencies[num_samples / 2];
-    uint64_t p90 = latencies[(num_samples * 90) / 100];
-    uint64_t p99 = latencies[(num_samples * 99) / 100];
-    uint64_t p999 = latencies[(num_samples * 999) / 1000];
-    uint64_t max = latencies[num_samples - 1];
+    uint64_t start = get_nanos();
 
-    uint64_t sum = 0;
-    for (size_t i = 0; i < num_samples; i++) {
-        sum += latencies[i];
+    for (size_t p = 0; p < producers; p++) {
+        pthread_create(&threads[p], NULL, mpsc_bench_producer, &args);
+    }
+    for (size_t i = 0; i < total; i++) {
+        while (!ring_mpsc_pop(&q, data, message_size)) {
+            /* Spin */
+        }
+    }
+    for (size_t p = 0; p < producers; p++) {
+        pthread_join(threads[p], NULL);
     }
-    double mean = (double)sum / (double)num_samples;
 
-    printf("  %3zu bytes (%zu samples):\n", message_size, num_samples);
-    printf("    min: %5lu ns  p50: %5lu ns  p90: %5lu ns  p99: %5lu ns  p99.9: %5lu ns  max: %6lu ns  mean: %.1f ns\n",
-           min, p50, p90, p99, p999, max, mean);
+    uint64_t elapsed_ns = get_nanos() - start;
+
+    double msgs_per_sec = (double)total / ((double)elapsed_ns / 1e9);
+    printf("  %zu producer%s, %3zu bytes x %8zu msgs: %10.2f msg/s  %7.2f MB/s  %6.1f ns/msg\n",
+           producers, producers == 1 ? " " : "s", message_size, total, msgs_per_sec,
+           mb_per_sec(message_size, total, elapsed_ns), (double)elapsed_ns / (double)total);
 
-    free(send_times);
-    free(recv_times);
-    free(latencies);
+    free(data);
+    ring_mpsc_destroy(&q);
 }
 
-/* ============ Contention Benchmark ============ */
+/* ============ MPMC vs Independent SPSC Rings ============ */
+
+#define MPMC_BENCH_SLOT 64
 
 typedef struct {
-    ring_buffer_t *rb;
-    size_t num_ops;
-    size_t msg_size;
-    atomic_size_t *fails;
-} contention_args_t;
+    ring_mpmc_t *q;
+    size_t num_messages;
+} mpmc_bench_args_t;
 
-static void *contention_producer(void *arg) {
-    contention_args_t *a = (contention_args_t *)arg;
-    uint8_t data[8] = {0};
-    for (size_t i = 0; i < a->num_ops; i++) {
-        while (!ring_push(a->rb, data, a->msg_size)) {
-            atomic_fetch_add(a->fails, 1);
+static void *mpmc_bench_producer(void *arg) {
+    mpmc_bench_args_t *a = (mpmc_bench_args_t *)arg;
+    uint8_t msg[MPMC_BENCH_SLOT] = {0};
+    for (size_t i = 0; i < a->num_messages; i++) {
+        while (!ring_mpmc_push(a->q, msg)) {
+            /* Spin */
         }
     }
     return NULL;
 }
 
-static void *contention_consumer(void *arg) {
-    contention_args_t *a = (contention_args_t *)arg;
-    uint8_t data[8];
-    for (size_t i = 0; i < a->num_ops; i++) {
-        while (!ring_pop(a->rb, data, a->msg_size)) {
-            atomic_fetch_add(a->fails, 1);
+static void *mpmc_bench_consumer(void *arg) {
+    mpmc_bench_args_t *a = (mpmc_bench_args_t *)arg;
+    uint8_t msg[MPMC_BENCH_SLOT];
+    for (size_t i = 0; i < a->num_messages; i++) {
+        while (!ring_mpmc_pop(a->q, msg)) {
+            /* Spin */
         }
     }
     return NULL;
 }
 
-static void bench_contention(void) {
-    ring_buffer_t rb;
-    init_buffer(&rb);
+/*
+ * `pairs` producers and `pairs` consumers, either all sharing one MPMC queue
+ * or each pair on its own SPSC ring of the same byte capacity.
+ */
+static void bench_mpmc_vs_spsc(size_t pairs, size_t msgs_per_pair) {
+    pthread_t producers[MAX_BENCH_THREADS], consumers[MAX_BENCH_THREADS];
+
+    /* Shared MPMC queue */
+    ring_mpmc_t q;
+    if (!ring_mpmc_init(&q, BENCH_CAPACITY / MPMC_BENCH_SLOT, MPMC_BENCH_SLOT, NULL)) {
+        fprintf(stderr, "ring_mpmc_init failed\n");
+        exit(1);
+    }
+    mpmc_bench_args_t margs = { &q, msgs_per_pair };
 
-    const size_t num_ops = 10000000;
-    const size_t msg_size = 8;
+    uint64_t start = get_nanos();
+    for (size_t i = 0; i < pairs; i++) {
+        pthread_create(&consumers[i], NULL, mpmc_bench_consumer, &margs);
+        pthread_create(&producers[i], NULL, mpmc_bench_producer, &margs);
+    }
+    for (size_t i = 0; i < pairs; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    uint64_t mpmc_ns = get_nanos() - start;
+    ring_mpmc_destroy(&q);
 
-    atomic_size_t push_fails = 0;
-    atomic_size_t pop_fails = 0;
+    /* Independent SPSC rings */
+    ring_buffer_t rings[MAX_BENCH_THREADS];
+    bench_args_t sargs[MAX_BENCH_THREADS];
+    atomic_bool done = false;
 
-    contention_args_t prod_args = { &rb, num_ops, msg_size, &push_fails };
-    contention_args_t cons_args = { &rb, num_ops, msg_size, &pop_fails };
+    for (size_t i = 0; i < pairs; i++) {
+        init_buffer(&rings[i], BENCH_CAPACITY);
+        sargs[i] = (bench_args_t){ &rings[i], msgs_per_pair, MPMC_BENCH_SLOT,
+                                   ring_push, ring_pop, &done };
+    }
 
-    pthread_t producer, consumer;
+    start = get_nanos();
+    for (size_t i = 0; i < pairs; i++) {
+        pthread_create(&consumers[i], NULL, throughput_consumer, &sargs[i]);
+        pthread_create(&producers[i], NULL, throughput_producer, &sargs[i]);
+    }
+    for (size_t i = 0; i < pairs; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    uint64_t spsc_ns = get_nanos() - start;
 
-    uint64_t start = get_nanos();
+    for (size_t i = 0; i < pairs; i++) {
+        ring_destroy(&rings[i]);
+    }
 
-    pthread_create(&producer, NULL, contention_producer, &prod_args);
-    pthread_create(&consumer, NULL, contention_consumer, &cons_args);
+    double total = (double)(pairs * msgs_per_pair);
+    printf("  %zu x %zu threads: MPMC %10.2f msg/s   %zu x SPSC %10.2f msg/s\n",
+           pairs, pairs, total / ((double)mpmc_ns / 1e9),
+           pairs, total / ((double)spsc_ns / 1e9));
+}
 
-    pthread_join(producer, NULL);
-    pthread_join(consumer, NULL);
+/* ============ Scaling: Many Independent Pairs ============ */
 
-    uint64_t end = get_nanos();
+/*
+ * K producer/consumer pairs, each on its own ring, all running at once. One
+ * pair measures the ring; many pairs measure the machine (memory bandwidth,
+ * L3 capacity, SMT and interconnect sharing). Placement comes from sysfs
+ * topology so the same command line means the same thing on any box.
+ */
+#define MAX_SCALE_PAIRS 64
 
-    printf("  %zu ops, %zu byte messages:\n", num_ops, msg_size);
-    printf("    Total time: %.3f ms\n", (double)(end - start) / 1e6);
-    printf("    Push retries: %zu (%.4f%%)\n",
-           atomic_load(&push_fails),
-           100.0 * (double)atomic_load(&push_fails) / (double)num_ops);
-    printf("    Pop retries: %zu (%.4f%%)\n",
-           atomic_load(&pop_fails),
-           100.0 * (double)atomic_load(&pop_fails) / (double)num_ops);
-}
+typedef enum {
+    BENCH_TOPO_NONE,        /* Unpinned; the scheduler places threads */
+    BENCH_TOPO_SMT,         /* Producer and consumer on SMT siblings of one core */
+    BENCH_TOPO_SOCKET,      /* Different cores of one socket */
+    BENCH_TOPO_CROSS        /* Producer and consumer on different sockets */
+} bench_topology_t;
 
-/* ============ Single-threaded Baseline ============ */
+static const char *topology_names[] = { "none", "smt", "socket", "cross" };
 
-static void bench_single_threaded(void) {
-    ring_buffer_t rb;
-    init_buffer(&rb);
+typedef struct {
+    int cpu;
+    int core;
+    int package;
+    bool used;
+} bench_cpu_t;
+
+static int read_topology_id(int cpu, const char *name) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return -1;
+    int id = -1;
+    if (fscanf(f, "%d", &id) != 1) id = -1;
+    fclose(f);
+    return id;
+}
 
-    const size_t num_ops = 10000000;
-    uint8_t data[8] = {0};
-    uint8_t out[8];
+/* CPUs this process may run on, with their core and socket ids */
+static size_t list_cpus(bench_cpu_t *cpus, size_t max) {
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return 0;
+
+    size_t n = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && n < max; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        cpus[n++] = (bench_cpu_t){
+            .cpu = cpu,
+            .core = read_topology_id(cpu, "core_id"),
+            .package = read_topology_id(cpu, "physical_package_id")
+        };
+    }
+    return n;
+}
 
-    uint64_t start = get_nanos();
+static bool topology_match(bench_topology_t topo, const bench_cpu_t *a, const bench_cpu_t *b) {
+    bool same_core = a->package == b->package && a->core == b->core;
+    switch (topo) {
+    case BENCH_TOPO_SMT:    return same_core;
+    case BENCH_TOPO_SOCKET: return a->package == b->package && !same_core;
+    default:                return a->package != b->package;
+    }
+}
 
-    for (size_t i = 0; i < num_ops; i++) {
-        ring_push(&rb, data, 8);
-        ring_pop(&rb, out, 8);
+/* Reserve every CPU on `c`'s core, so other pairs don't land on its siblings */
+static void claim_core(bench_cpu_t *cpus, size_t n, const bench_cpu_t *c) {
+    int core = c->core;
+    int package = c->package;
+    for (size_t i = 0; i < n; i++) {
+        if (cpus[i].core == core && cpus[i].package == package) cpus[i].used = true;
     }
+}
 
-    uint64_t end = get_nanos();
+/*
+ * Pick CPUs for `pairs` pairs under `topo` (-1 everywhere for
+ * BENCH_TOPO_NONE). Returns the number of pairs that could be placed.
+ */
+static size_t place_pairs(bench_topology_t topo, size_t pairs, int *producer_cpus, int *consumer_cpus) {
+    static bench_cpu_t cpus[CPU_SETSIZE];
 
-    double ns_per_pair = (double)(end - start) / (double)num_ops;
-    double ops_per_sec = 1e9 / ns_per_pair * 2;
+    if (topo == BENCH_TOPO_NONE) {
+        for (size_t i = 0; i < pairs; i++) producer_cpus[i] = consumer_cpus[i] = -1;
+        return pairs;
+    }
 
-    printf("  %zu push+pop pairs:\n", num_ops);
-    printf("    Total time: %.3f ms\n", (double)(end - start) / 1e6);
-    printf("    %.1f ns per push+pop pair\n", ns_per_pair);
-    printf("    %.2f M ops/sec\n", ops_per_sec / 1e6);
+    size_t n = list_cpus(cpus, CPU_SETSIZE);
+    size_t placed = 0;
+    while (placed < pairs) {
+        bench_cpu_t *p = NULL, *c = NULL;
+        for (size_t i = 0; i < n && c == NULL; i++) {
+            if (cpus[i].used) continue;
+            for (size_t j = 0; j < n; j++) {
+                if (j != i && !cpus[j].used && topology_match(topo, &cpus[i], &cpus[j])) {
+                    p = &cpus[i];
+                    c = &cpus[j];
+                    break;
+                }
+            }
+        }
+        if (c == NULL) break;
+
+        producer_cpus[placed] = p->cpu;
+        consumer_cpus[placed] = c->cpu;
+        placed++;
+        claim_core(cpus, n, p);
+        claim_core(cpus, n, c);
+    }
+    return placed;
 }
 
-/* ============ Main ============ */
+typedef struct {
+    bench_args_t args;
+    atomic_bool *go;
+    uint64_t end_ns;
+} scale_pair_t;
+
+static void *scale_producer(void *arg) {
+    scale_pair_t *pair = (scale_pair_t *)arg;
+    while (!atomic_load(pair->go)) {
+        sched_yield();
+    }
+    return throughput_producer(&pair->args);
+}
 
-int main(void) {
+static void *scale_consumer(void *arg) {
+    scale_pair_t *pair = (scale_pair_t *)arg;
+    while (!atomic_load(pair->go)) {
+        sched_yield();
+    }
+    throughput_consumer(&pair->args);
+    pair->end_ns = get_nanos();
+    return NULL;
+}
+
+/*
+ * Run `pairs` pairs of num_messages each, all released together. Fills
+ * pair_mbps[] and returns the ns until the last pair finished. The
+ * topology must fit (checked with place_pairs() beforehand).
+ */
+static uint64_t run_scaling(size_t message_size, size_t num_messages, size_t pairs,
+                            bench_topology_t topo, double *pair_mbps) {
+    int producer_cpus[MAX_SCALE_PAIRS], consumer_cpus[MAX_SCALE_PAIRS];
+    if (place_pairs(topo, pairs, producer_cpus, consumer_cpus) < pairs) {
+        fprintf(stderr, "topology %s: can't place %zu pairs\n", topology_names[topo], pairs);
+        exit(1);
+    }
+
+    ring_buffer_t *rings = calloc(pairs, sizeof(*rings));
+    scale_pair_t *pair = calloc(pairs, sizeof(*pair));
+    pthread_t *threads = calloc(2 * pairs, sizeof(*threads));
+    if (rings == NULL || pair == NULL || threads == NULL) {
+        fprintf(stderr, "scaling allocation failed\n");
+        exit(1);
+    }
+
+    atomic_bool go = false;
+    atomic_bool done = false;
+    size_t capacity = bench_capacity(BENCH_CAPACITY);
+
+    for (size_t i = 0; i < pairs; i++) {
+        init_buffer(&rings[i], capacity);
+        pair[i].args = (bench_args_t){ &rings[i], num_messages, message_size,
+                                       ring_push, ring_pop, &done };
+        pair[i].go = &go;
+        bench_spawn(&threads[2 * i], scale_consumer, &pair[i], consumer_cpus[i]);
+        bench_spawn(&threads[2 * i + 1], scale_producer, &pair[i], producer_cpus[i]);
+    }
+
+    uint64_t start = get_nanos();
+    atomic_store(&go, true);
+    for (size_t i = 0; i < 2 * pairs; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint64_t last = start;
+    for (size_t i = 0; i < pairs; i++) {
+        if (pair[i].end_ns > last) last = pair[i].end_ns;
+        pair_mbps[i] = mb_per_sec(message_size, num_messages, pair[i].end_ns - start);
+        ring_destroy(&rings[i]);
+    }
+
+    free(threads);
+    free(pair);
+    free(rings);
+    return last - start;
+}
+
+static void bench_scaling(size_t message_size, size_t num_messages, size_t pairs,
+                          bench_topology_t topo) {
+    int producer_cpus[MAX_SCALE_PAIRS], consumer_cpus[MAX_SCALE_PAIRS];
+    if (place_pairs(topo, pairs, producer_cpus, consumer_cpus) < pairs) {
+        printf("  %2zu pairs: not enough CPUs for topology %s\n", pairs, topology_names[topo]);
+        return;
+    }
+
+    double pair_mbps[MAX_SCALE_PAIRS];
+    uint64_t elapsed_ns = run_scaling(message_size, num_messages, pairs, topo, pair_mbps);
+    size_t total = pairs * num_messages;
+
+    printf("  %2zu pairs: aggregate %10.2f msg/s  %8.2f MB/s   per pair:",
+           pairs, (double)total / ((double)elapsed_ns / 1e9),
+           mb_per_sec(message_size, total, elapsed_ns));
+    for (size_t i = 0; i < pairs; i++) printf(" %.0f", pair_mbps[i]);
+    bench_summary_t s = summarize(pair_mbps, pairs);
+    printf(" MB/s (min %.0f, median %.0f)\n", s.min, s.median);
+}
+
+/* ============ Copy Strategy Comparison ============ */
+
+/* The original per-byte masked loop, kept only as a baseline */
+static bool bytewise_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+
+    size_t available = (tail - head - 1) & rb->mask;
+    if (len > available) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        rb->data[(head + i) & rb->mask] = src[i];
+    }
+
+    atomic_store_explicit(&rb->head, (head + len) & rb->mask, memory_order_release);
+    return true;
+}
+
+static bool bytewise_pop(ring_buffer_t *rb, uint8_t *dst, size_t len) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+
+    size_t available = (head - tail) & rb->mask;
+    if (len > available) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = rb->data[(tail + i) & rb->mask];
+    }
+
+    atomic_store_explicit(&rb->tail, (tail + len) & rb->mask, memory_order_release);
+    return true;
+}
+
+static void bench_copy_strategy(size_t message_size, size_t num_messages) {
+    uint64_t before = run_throughput(bytewise_push, bytewise_pop, false, message_size, num_messages);
+    uint64_t after = run_throughput(ring_push, ring_pop, false, message_size, num_messages);
+    uint64_t mirror = run_throughput(ring_push, ring_pop, true, message_size, num_messages);
+
+    double mb_before = mb_per_sec(message_size, num_messages, before);
+    double mb_after = mb_per_sec(message_size, num_messages, after);
+    double mb_mirror = mb_per_sec(message_size, num_messages, mirror);
+
+    printf("  %3zu bytes  %9.2f MB/s  %9.2f MB/s  %6.2fx  %9.2f MB/s\n",
+           message_size, mb_before, mb_after, mb_after / mb_before, mb_mirror);
+}
+
+/* ============ Page Size Benchmark ============ */
+
+/* Far larger than L2 so every lap streams through more pages than the TLB holds */
+#define PAGE_BENCH_CAPACITY ((size_t)64 << 20)
+
+static void bench_page_size(const char *name, ring_page_size_t pages,
+                            size_t message_size, size_t num_messages) {
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = { pages, -1, true };
+    if (!ring_init_opts(&rb, PAGE_BENCH_CAPACITY, &opts)) {
+        printf("  %-8s %4zu bytes: unavailable\n", name, message_size);
+        return;
+    }
+
+    uint64_t elapsed = run_throughput_on(&rb, ring_push, ring_pop, message_size, num_messages);
+    printf("  %-8s %4zu bytes: %9.2f MB/s\n", name, message_size,
+           mb_per_sec(message_size, num_messages, elapsed));
+
+    ring_destroy(&rb);
+}
+
+/* ============ Bulk Payload Copy Hints ============ */
+
+/* Larger than a typical L2, so streamed frames really stay out of the producer's cache */
+#define BULK_BENCH_CAPACITY ((size_t)4 << 20)
+
+static bool stream_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    return ring_push_hint(rb, src, len, RING_HINT_STREAM);
+}
+
+static bool prefetch_pop(ring_buffer_t *rb, uint8_t *dst, size_t len) {
+    return ring_pop_hint(rb, dst, len, RING_HINT_PREFETCH);
+}
+
+/* Same frames four ways: plain, streamed push, prefetching pop, both */
+static void bench_copy_hints(size_t message_size, size_t num_messages) {
+    static const struct {
+        push_fn_t push;
+        pop_fn_t pop;
+    } modes[] = {
+        { ring_push, ring_pop },
+        { stream_push, ring_pop },
+        { ring_push, prefetch_pop },
+        { stream_push, prefetch_pop }
+    };
+
+    printf("  %5zu bytes x %7zu:", message_size, num_messages);
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        ring_buffer_t rb;
+        init_buffer(&rb, BULK_BENCH_CAPACITY);
+        ring_set_hints(&rb, 0);
+
+        uint64_t elapsed = run_throughput_on(&rb, modes[m].push, modes[m].pop,
+                                             message_size, num_messages);
+        printf("  %9.2f MB/s", mb_per_sec(message_size, num_messages, elapsed));
+        ring_destroy(&rb);
+    }
+    printf("\n");
+}
+
+/* ============ Latency Benchmark ============ */
+
+/*
+ * The producer stamps each message with its send time and the consumer
+ * records receive - send into a fixed-size histogram as it goes, so the run
+ * length is not bounded by memory and no per-sample stores compete with the
+ * ring for cache. Timestamps are bench_clock ticks; the histogram holds
+ * ticks and only its summary values are converted to ns.
+ */
+typedef struct {
+    ring_buffer_t *rb;
+    size_t num_samples;
+    size_t message_size;
+    ring_hist_t *hist;
+    atomic_bool *ready;
+} latency_args_t;
+
+static void *latency_producer(void *arg) {
+    latency_args_t *args = (latency_args_t *)arg;
+    uint8_t *data = calloc(1, args->message_size);
+
+    while (!atomic_load(args->ready)) {
+        sched_yield();
+    }
+
+    for (size_t i = 0; i < args->num_samples; i++) {
+        uint64_t now = ring_clock_now(&bench_clock);
+        memcpy(data, &now, sizeof(now));
+
+        while (!ring_push(args->rb, data, args->message_size)) {
+            /* Spin */
+        }
+
+        /* Small delay to avoid overwhelming */
+        for (volatile int j = 0; j < 100; j++);
+    }
+
+    free(data);
+    return NULL;
+}
+
+static void *latency_consumer(void *arg) {
+    latency_args_t *args = (latency_args_t *)arg;
+    uint8_t *data = calloc(1, args->message_size);
+
+    atomic_store(args->ready, true);
+
+    for (size_t i = 0; i < args->num_samples; i++) {
+        while (!ring_pop(args->rb, data, args->message_size)) {
+            /* Spin */
+        }
+        uint64_t sent;
+        memcpy(&sent, data, sizeof(sent));
+        ring_hist_record(args->hist, ring_clock_now_ordered(&bench_clock) - sent);
+    }
+
+    free(data);
+    return NULL;
+}
+
+/* Histograms are too big for a thread stack; one is enough for the benchmark */
+static ring_hist_t bench_hist;
+
+static uint64_t hist_ns(double percentile) {
+    return ring_clock_to_ns(&bench_clock, ring_hist_percentile(&bench_hist, percentile));
+}
+
+/* Fill bench_hist with num_samples one-way latencies; returns the size used */
+static size_t run_latency(size_t message_size, size_t num_samples) {
+    ring_buffer_t rb;
+    init_buffer(&rb, bench_capacity(BUFFER_SIZE));
+    ring_hist_init(&bench_hist);
+
+    atomic_bool ready = false;
+
+    /* The send timestamp rides in the payload */
+    if (message_size < sizeof(uint64_t)) message_size = sizeof(uint64_t);
+
+    latency_args_t args = {
+        .rb = &rb,
+        .num_samples = num_samples,
+        .message_size = message_size,
+        .hist = &bench_hist,
+        .ready = &ready
+    };
+
+    pthread_t producer, consumer;
+
+    spawn_consumer(&consumer, latency_consumer, &args);
+    spawn_producer(&producer, latency_producer, &args);
+
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    ring_destroy(&rb);
+    return message_size;
+}
+
+static void bench_latency(size_t message_size, size_t num_samples) {
+    message_size = run_latency(message_size, num_samples);
+
+    printf("  %3zu bytes (%zu samples):\n", message_size, num_samples);
+    printf("    min: %5llu ns  p50: %5llu ns  p90: %5llu ns  p99: %5llu ns  p99.9: %5llu ns  mean: %.1f ns\n",
+           (unsigned long long)ring_clock_to_ns(&bench_clock, ring_hist_min(&bench_hist)),
+           (unsigned long long)hist_ns(50.0), (unsigned long long)hist_ns(90.0),
+           (unsigned long long)hist_ns(99.0), (unsigned long long)hist_ns(99.9),
+           ring_hist_mean(&bench_hist) * bench_clock.ns_per_tick);
+    printf("    p99.99: %6llu ns  p99.999: %6llu ns  max: %7llu ns\n",
+           (unsigned long long)hist_ns(99.99), (unsigned long long)hist_ns(99.999),
+           (unsigned long long)ring_clock_to_ns(&bench_clock, ring_hist_max(&bench_hist)));
+}
+
+/* ============ Ping-Pong Round Trip ============ */
+
+/*
+ * The client sends timestamped requests on one ring and the server echoes
+ * them back on a second ring. Both timestamps come from the client thread,
+ * so RTT needs no cross-core clock agreement. Keeping `depth` requests in
+ * flight shows how much of the per-message cost is the cache-line handoff
+ * (depth 1) versus pipelined transfer.
+ */
+typedef struct {
+    ring_buffer_t *requests;
+    ring_buffer_t *replies;
+    size_t num_round_trips;
+    size_t depth;
+    size_t message_size;
+    ring_hist_t *hist;
+    uint64_t elapsed_ns;
+} pingpong_args_t;
+
+static void *pingpong_client(void *arg) {
+    pingpong_args_t *a = (pingpong_args_t *)arg;
+    uint8_t *data = calloc(1, a->message_size);
+    size_t sent = 0;
+    size_t received = 0;
+
+    uint64_t start = get_nanos();
+
+    while (received < a->num_round_trips) {
+        while (sent < a->num_round_trips && sent - received < a->depth) {
+            uint64_t now = ring_clock_now(&bench_clock);
+            memcpy(data, &now, sizeof(now));
+            while (!ring_push(a->requests, data, a->message_size)) {
+                /* Spin */
+            }
+            sent++;
+        }
+
+        while (!ring_pop(a->replies, data, a->message_size)) {
+            /* Spin */
+        }
+        uint64_t stamp;
+        memcpy(&stamp, data, sizeof(stamp));
+        ring_hist_record(a->hist, ring_clock_now_ordered(&bench_clock) - stamp);
+        received++;
+    }
+
+    a->elapsed_ns = get_nanos() - start;
+    free(data);
+    return NULL;
+}
+
+static void *pingpong_server(void *arg) {
+    pingpong_args_t *a = (pingpong_args_t *)arg;
+    uint8_t *data = calloc(1, a->message_size);
+
+    for (size_t i = 0; i < a->num_round_trips; i++) {
+        while (!ring_pop(a->requests, data, a->message_size)) {
+            /* Spin */
+        }
+        while (!ring_push(a->replies, data, a->message_size)) {
+            /* Spin */
+        }
+    }
+
+    free(data);
+    return NULL;
+}
+
+/*
+ * Fill bench_hist with round-trip times; returns the elapsed ns. The client
+ * runs on the producer CPU and the server on the consumer CPU. Each ring
+ * must hold `depth` messages, or both sides could block on a full ring.
+ */
+static uint64_t run_pingpong(size_t message_size, size_t num_round_trips, size_t depth) {
+    ring_buffer_t requests, replies;
+    size_t capacity = bench_capacity(BENCH_CAPACITY);
+    init_buffer(&requests, capacity);
+    init_buffer(&replies, capacity);
+    ring_hist_init(&bench_hist);
+
+    if (message_size < sizeof(uint64_t)) message_size = sizeof(uint64_t);
+
+    pingpong_args_t args = {
+        .requests = &requests,
+        .replies = &replies,
+        .num_round_trips = num_round_trips,
+        .depth = depth,
+        .message_size = message_size,
+        .hist = &bench_hist
+    };
+
+    pthread_t client, server;
+    spawn_consumer(&server, pingpong_server, &args);
+    spawn_producer(&client, pingpong_client, &args);
+
+    pthread_join(client, NULL);
+    pthread_join(server, NULL);
+
+    ring_destroy(&requests);
+    ring_destroy(&replies);
+    return args.elapsed_ns;
+}
+
+static void bench_pingpong(size_t message_size, size_t num_round_trips, size_t depth) {
+    uint64_t elapsed_ns = run_pingpong(message_size, num_round_trips, depth);
+    double round_trips_per_sec = (double)num_round_trips / ((double)elapsed_ns / 1e9);
+
+    printf("  %3zu bytes, depth %2zu: %10.2f rt/s  p50: %5llu ns  p99: %5llu ns  "
+           "p99.9: %6llu ns  max: %7llu ns\n",
+           message_size, depth, round_trips_per_sec,
+           (unsigned long long)hist_ns(50.0), (unsigned long long)hist_ns(99.0),
+           (unsigned long long)hist_ns(99.9),
+           (unsigned long long)ring_clock_to_ns(&bench_clock, ring_hist_max(&bench_hist)));
+}
+
+/* ============ Wait Strategy Benchmark ============ */
+
+typedef struct {
+    ring_buffer_t *rb;
+    ring_wait_t *w;
+    size_t num_samples;
+    uint64_t interval_ns;
+    ring_hist_t *hist;
+    double consumer_cpu_ns;
+    double consumer_wall_ns;
+} wait_bench_args_t;
+
+static uint64_t thread_cpu_nanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Paced producer: one timestamped message every interval_ns */
+static void *wait_bench_producer(void *arg) {
+    wait_bench_args_t *a = (wait_bench_args_t *)arg;
+    uint64_t next = get_nanos();
+
+    for (size_t i = 0; i < a->num_samples; i++) {
+        next += a->interval_ns;
+        while (get_nanos() < next) {
+            /* Pace */
+        }
+        uint64_t now = ring_clock_now(&bench_clock);
+        ring_push_wait(a->rb, a->w, (uint8_t *)&now, sizeof(now));
+    }
+    return NULL;
+}
+
+static void *wait_bench_consumer(void *arg) {
+    wait_bench_args_t *a = (wait_bench_args_t *)arg;
+    uint64_t wall_start = get_nanos();
+    uint64_t cpu_start = thread_cpu_nanos();
+
+    for (size_t i = 0; i < a->num_samples; i++) {
+        uint64_t sent;
+        ring_pop_wait(a->rb, a->w, (uint8_t *)&sent, sizeof(sent));
+        ring_hist_record(a->hist, ring_clock_now_ordered(&bench_clock) - sent);
+    }
+
+    a->consumer_cpu_ns = (double)(thread_cpu_nanos() - cpu_start);
+    a->consumer_wall_ns = (double)(get_nanos() - wall_start);
+    return NULL;
+}
+
+static void bench_wait_strategy(const char *name, ring_wait_strategy_t strategy,
+                                size_t num_samples, uint64_t interval_ns) {
+    ring_buffer_t rb;
+    ring_wait_t w;
+    init_buffer(&rb, bench_capacity(BUFFER_SIZE));
+    ring_wait_init(&w, strategy, RING_WAIT_DEFAULT_SPINS);
+    ring_hist_init(&bench_hist);
+
+    wait_bench_args_t args = {
+        .rb = &rb,
+        .w = &w,
+        .num_samples = num_samples,
+        .interval_ns = interval_ns,
+        .hist = &bench_hist
+    };
+
+    pthread_t producer, consumer;
+    spawn_consumer(&consumer, wait_bench_consumer, &args);
+    spawn_producer(&producer, wait_bench_producer, &args);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("  %-6s p50: %6llu ns  p99: %7llu ns  p99.9: %8llu ns  max: %8llu ns  consumer CPU: %5.1f%%\n",
+           name, (unsigned long long)hist_ns(50.0), (unsigned long long)hist_ns(99.0),
+           (unsigned long long)hist_ns(99.9),
+           (unsigned long long)ring_clock_to_ns(&bench_clock, ring_hist_max(&bench_hist)),
+           100.0 * args.consumer_cpu_ns / args.consumer_wall_ns);
+
+    ring_destroy(&rb);
+}
+
+/* ============ Contention Benchmark ============ */
+
+/*
+ * Baseline without the cached remote index: every operation does an acquire
+ * load of the other side's index, pulling its cache line across cores.
+ */
+static bool uncached_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+
+    if (len > rb->capacity - (head - tail)) {
+        RING_STATS_FAIL(rb, producer);
+        return false;
+    }
+    ring_copy_in(rb, head & rb->mask, src, len);
+
+    atomic_store_explicit(&rb->head, head + len, memory_order_release);
+    return true;
+}
+
+static bool uncached_pop(ring_buffer_t *rb, uint8_t *dst, size_t len) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+
+    if (len > head - tail) {
+        RING_STATS_FAIL(rb, consumer);
+        return false;
+    }
+    ring_copy_out(rb, tail & rb->mask, dst, len);
+
+    atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+    return true;
+}
+
+typedef struct {
+    ring_buffer_t *rb;
+    size_t num_ops;
+    size_t msg_size;
+    push_fn_t push;
+    pop_fn_t pop;
+    atomic_size_t *fails;
+} contention_args_t;
+
+static void *contention_producer(void *arg) {
+    contention_args_t *a = (contention_args_t *)arg;
+    uint8_t data[8] = {0};
+    for (size_t i = 0; i < a->num_ops; i++) {
+        while (!a->push(a->rb, data, a->msg_size)) {
+#ifndef RING_STATS
+            atomic_fetch_add(a->fails, 1);
+#endif
+        }
+    }
+    return NULL;
+}
+
+static void *contention_consumer(void *arg) {
+    contention_args_t *a = (contention_args_t *)arg;
+    uint8_t data[8];
+    for (size_t i = 0; i < a->num_ops; i++) {
+        while (!a->pop(a->rb, data, a->msg_size)) {
+#ifndef RING_STATS
+            atomic_fetch_add(a->fails, 1);
+#endif
+        }
+    }
+    return NULL;
+}
+
+static void bench_contention(const char *name, push_fn_t push, pop_fn_t pop) {
+    ring_buffer_t rb;
+    init_buffer(&rb, bench_capacity(BUFFER_SIZE));
+
+    const size_t num_ops = 10000000;
+    const size_t msg_size = 8;
+
+    atomic_size_t push_fails = 0;
+    atomic_size_t pop_fails = 0;
+
+    contention_args_t prod_args = { &rb, num_ops, msg_size, push, pop, &push_fails };
+    contention_args_t cons_args = { &rb, num_ops, msg_size, push, pop, &pop_fails };
+
+    pthread_t producer, consumer;
+
+    uint64_t start = get_nanos();
+
+    spawn_producer(&producer, contention_producer, &prod_args);
+    spawn_consumer(&consumer, contention_consumer, &cons_args);
+
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    uint64_t end = get_nanos();
+
+#ifdef RING_STATS
+    /* The ring counted its own failures, without perturbing the spin loops */
+    ring_stats_t st;
+    ring_stats_snapshot(&rb, &st);
+    atomic_store(&push_fails, st.producer.failed);
+    atomic_store(&pop_fails, st.consumer.failed);
+#endif
+
+    printf("  %s, %zu ops, %zu byte messages:\n", name, num_ops, msg_size);
+    printf("    Total time: %.3f ms\n", (double)(end - start) / 1e6);
+    printf("    Push retries: %zu (%.4f%%)\n",
+           atomic_load(&push_fails),
+           100.0 * (double)atomic_load(&push_fails) / (double)num_ops);
+    printf("    Pop retries: %zu (%.4f%%)\n",
+           atomic_load(&pop_fails),
+           100.0 * (double)atomic_load(&pop_fails) / (double)num_ops);
+#ifdef RING_STATS
+    printf("    Producer high-water: %zu of %zu bytes; occupancy by eighths:",
+           st.producer.high_water, rb.capacity);
+    for (size_t i = 0; i < RING_STATS_BUCKETS; i++) {
+        printf(" %zu", st.producer.occupancy[i]);
+    }
+    printf("\n");
+#endif
+
+    ring_destroy(&rb);
+}
+
+/* ============ Copy Kernels ============ */
+
+/*
+ * Single-threaded push+pop through each kernel the CPU supports, so the copy
+ * itself is measured without any cross-core traffic.
+ */
+static void bench_copy_kernels(size_t message_size, size_t num_ops) {
+    uint8_t *data = calloc(1, message_size);
+    uint8_t *out = calloc(1, message_size);
+
+    printf("  %5zu bytes:", message_size);
+    for (size_t k = 0; k < RING_NUM_COPY_KERNELS; k++) {
+        ring_buffer_t rb;
+        init_buffer(&rb, BENCH_CAPACITY);
+        if (!ring_set_copy_kernel(&rb, ring_copy_kernels[k].name)) {
+            ring_destroy(&rb);
+            continue;
+        }
+
+        uint64_t start = get_nanos();
+        for (size_t i = 0; i < num_ops; i++) {
+            ring_push(&rb, data, message_size);
+            ring_pop(&rb, out, message_size);
+        }
+        uint64_t elapsed = get_nanos() - start;
+
+        printf("  %s %6.1f ns", ring_copy_kernels[k].name, (double)elapsed / (double)num_ops);
+        ring_destroy(&rb);
+    }
+    printf("\n");
+
+    free(out);
+    free(data);
+}
+
+/* ============ Lossy Producer ============ */
+
+/*
+ * Producer-only cost of the overwrite-oldest ring with nobody reading, so
+ * every push laps the consumer; a plain ring_push would fail instead.
+ */
+static void bench_lossy_push(size_t message_size, size_t num_ops) {
+    ring_lossy_t l;
+    if (!ring_lossy_init(&l, BENCH_CAPACITY, NULL)) {
+        fprintf(stderr, "ring_lossy_init(%d) failed\n", BENCH_CAPACITY);
+        exit(1);
+    }
+    uint8_t *data = calloc(1, message_size);
+
+    uint64_t start = get_nanos();
+    for (size_t i = 0; i < num_ops; i++) ring_lossy_push(&l, data, message_size);
+    uint64_t raw = get_nanos() - start;
+
+    start = get_nanos();
+    for (size_t i = 0; i < num_ops; i++) ring_lossy_push_msg(&l, data, message_size);
+    uint64_t framed = get_nanos() - start;
+
+    printf("  %3zu bytes: push %6.1f ns   push_msg %6.1f ns\n", message_size,
+           (double)raw / (double)num_ops, (double)framed / (double)num_ops);
+
+    free(data);
+    ring_lossy_destroy(&l);
+}
+
+/* ============ Draining to a File Descriptor ============ */
+
+typedef enum { FD_DRAIN_COPY, FD_DRAIN_WRITEV, FD_DRAIN_URING } fd_drain_t;
+
+/*
+ * Single-threaded fill/drain cycles into /dev/null, so the write itself is
+ * nearly free and what's left is the consumer's cost per byte: ring_pop
+ * into a buffer then write(), ring_writev() straight from the ring, or an
+ * io_uring sink. Returns MB/s, or 0 if the mode isn't available.
+ */
+static double run_fd_drain(fd_drain_t how, size_t message_size, size_t total_bytes) {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) return 0.0;
+
+    ring_buffer_t rb;
+    init_buffer(&rb, BENCH_CAPACITY);
+    ring_sink_t sink;
+    ring_sink_mode_t mode = how == FD_DRAIN_URING ? RING_SINK_IO_URING : RING_SINK_WRITEV;
+    if (!ring_sink_init(&sink, &rb, fd, mode)) {
+        ring_destroy(&rb);
+        close(fd);
+        return 0.0;
+    }
+
+    uint8_t *msg = calloc(1, message_size);
+    uint8_t *buf = malloc(BENCH_CAPACITY);
+    size_t per_fill = BENCH_CAPACITY / message_size;
+    size_t moved = 0;
+
+    uint64_t start = get_nanos();
+    while (moved < total_bytes) {
+        for (size_t i = 0; i < per_fill; i++) ring_push(&rb, msg, message_size);
+        size_t n = ring_used(&rb);
+
+        if (how == FD_DRAIN_COPY) {
+            ring_pop(&rb, buf, n);
+            if (write(fd, buf, n) != (ssize_t)n) break;
+        } else if (!ring_sink_flush(&sink)) {
+            break;
+        }
+        moved += n;
+    }
+    uint64_t elapsed = get_nanos() - start;
+
+    free(buf);
+    free(msg);
+    ring_sink_destroy(&sink);
+    ring_destroy(&rb);
+    close(fd);
+    return mb_per_sec(1, moved, elapsed);
+}
+
+static void bench_fd_drain(size_t message_size, size_t total_bytes) {
+    printf("  %4zu-byte messages:  pop+write %9.1f MB/s  writev %9.1f MB/s  io_uring %9.1f MB/s\n",
+           message_size,
+           run_fd_drain(FD_DRAIN_COPY, message_size, total_bytes),
+           run_fd_drain(FD_DRAIN_WRITEV, message_size, total_bytes),
+           run_fd_drain(FD_DRAIN_URING, message_size, total_bytes));
+}
+
+/* ============ Async Logger ============ */
+
+#define LOG_BENCH_BURST 1000
+#define LOG_BENCH_BURSTS 200
+
+static ring_log_t bench_log;
+
+/*
+ * Caller-side cost of ring_log() into /dev/null. Calls go in bursts that
+ * fit the ring, with a flush in between, so drops and the drain thread's
+ * share of a single-core box stay out of the number.
+ */
+static void bench_log_calls(void) {
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0 || !ring_log_open(&bench_log, fd, 1 << 20)) {
+        fprintf(stderr, "ring_log_open failed\n");
+        exit(1);
+    }
+    ring_log_writer_t *w = ring_log_writer(&bench_log);
+
+    static const char *const fmts[] = {
+        "heartbeat",
+        "order %d qty %u px %.4f",
+        "order %d qty %u px %.4f venue %s id %llx"
+    };
+    for (size_t k = 0; k < sizeof(fmts) / sizeof(fmts[0]); k++) {
+        int id = ring_log_format(&bench_log, fmts[k]);
+        double ns[LOG_BENCH_BURSTS];
+
+        for (size_t b = 0; b < LOG_BENCH_BURSTS; b++) {
+            ring_log_flush(&bench_log);
+            uint64_t start = get_nanos();
+            for (int i = 0; i < LOG_BENCH_BURST; i++) {
+                ring_log(w, id, i, (unsigned)i, 101.25, "XNAS", 0xfeedULL + (unsigned)i);
+            }
+            ns[b] = (double)(get_nanos() - start) / LOG_BENCH_BURST;
+        }
+
+        bench_summary_t s = summarize(ns, LOG_BENCH_BURSTS);
+        printf("  %-42s  median %6.1f ns  min %6.1f ns\n", fmts[k], s.median, s.min);
+    }
+
+    if (ring_log_dropped(&bench_log) != 0) printf("  (%llu records dropped)\n",
+                                                  (unsigned long long)ring_log_dropped(&bench_log));
+    ring_log_close(&bench_log);
+    close(fd);
+}
+
+/* ============ Pipeline Stages ============ */
+
+#define PIPE_STAGES 3
+
+typedef struct {
+    ring_pipeline_t *p;             /* Shared buffer: the stage's cursor */
+    ring_buffer_t *in, *out;        /* Chained rings: pop from `in`, push to `out` unless last */
+    size_t stage;
+    size_t message_size;
+    size_t num_messages;
+} pipe_stage_args_t;
+
+/* Each stage touches its message, in place or in its own copy */
+static void *pipe_shared_stage(void *arg) {
+    pipe_stage_args_t *a = (pipe_stage_args_t *)arg;
+    ring_span_t span;
+
+    for (size_t i = 0; i < a->num_messages; i++) {
+        while (!ring_stage_peek(a->p, a->stage, a->message_size, &span)) {
+            /* Spin */
+        }
+        span.first[0]++;
+        ring_stage_release(a->p, a->stage, a->message_size);
+    }
+    return NULL;
+}
+
+static void *pipe_chained_stage(void *arg) {
+    pipe_stage_args_t *a = (pipe_stage_args_t *)arg;
+    uint8_t *msg = calloc(1, a->message_size);
+
+    for (size_t i = 0; i < a->num_messages; i++) {
+        while (!ring_pop(a->in, msg, a->message_size)) {
+            /* Spin */
+        }
+        msg[0]++;
+        if (a->out == NULL) continue;
+        while (!ring_push(a->out, msg, a->message_size)) {
+            /* Spin */
+        }
+    }
+
+    free(msg);
+    return NULL;
+}
+
+/*
+ * Producer plus PIPE_STAGES stages, either through one shared buffer or
+ * through one ring per hop with a pop and a push at each stage. Returns
+ * elapsed ns. The middle stages are left unpinned.
+ */
+static uint64_t run_pipeline(bool shared, size_t message_size, size_t num_messages) {
+    size_t capacity = bench_capacity(BENCH_CAPACITY);
+    ring_pipeline_t p;
+    ring_buffer_t chain[PIPE_STAGES];
+
+    if (shared) {
+        if (!ring_pipeline_init(&p, capacity, NULL, PIPE_STAGES)) {
+            fprintf(stderr, "ring_pipeline_init(%zu) failed\n", capacity);
+            exit(1);
+        }
+        memset(p.ring.data, 0, capacity);
+    } else {
+        for (size_t i = 0; i < PIPE_STAGES; i++) init_buffer(&chain[i], capacity);
+    }
+
+    atomic_bool done = false;
+    bench_args_t prod = {
+        .rb = shared ? &p.ring : &chain[0],
+        .num_messages = num_messages,
+        .message_size = message_size,
+        .push = ring_push,
+        .done = &done
+    };
+    pipe_stage_args_t stages[PIPE_STAGES];
+    pthread_t producer, threads[PIPE_STAGES];
+
+    uint64_t start = get_nanos();
+
+    spawn_producer(&producer, throughput_producer, &prod);
+    for (size_t i = 0; i < PIPE_STAGES; i++) {
+        stages[i] = (pipe_stage_args_t){
+            .p = &p,
+            .in = &chain[i],
+            .out = i + 1 < PIPE_STAGES ? &chain[i + 1] : NULL,
+            .stage = i,
+            .message_size = message_size,
+            .num_messages = num_messages
+        };
+        void *(*fn)(void *) = shared ? pipe_shared_stage : pipe_chained_stage;
+        if (i + 1 < PIPE_STAGES) {
+            bench_spawn(&threads[i], fn, &stages[i], -1);
+        } else {
+            spawn_consumer(&threads[i], fn, &stages[i]);
+        }
+    }
+
+    pthread_join(producer, NULL);
+    for (size_t i = 0; i < PIPE_STAGES; i++) pthread_join(threads[i], NULL);
+
+    uint64_t elapsed_ns = get_nanos() - start;
+    if (shared) {
+        ring_pipeline_destroy(&p);
+    } else {
+        for (size_t i = 0; i < PIPE_STAGES; i++) ring_destroy(&chain[i]);
+    }
+    return elapsed_ns;
+}
+
+static void bench_pipeline(size_t message_size, size_t num_messages) {
+    uint64_t chained = run_pipeline(false, message_size, num_messages);
+    uint64_t shared = run_pipeline(true, message_size, num_messages);
+
+    printf("  %4zu bytes x %8zu msgs: chained rings %7.1f ns/msg  shared buffer %7.1f ns/msg\n",
+           message_size, num_messages, (double)chained / (double)num_messages,
+           (double)shared / (double)num_messages);
+}
+
+/* ============ Single-threaded Baseline ============ */
+
+static void bench_single_threaded(void) {
+    ring_buffer_t rb;
+    init_buffer(&rb, BUFFER_SIZE);
+
+    const size_t num_ops = 10000000;
+    uint8_t data[8] = {0};
+    uint8_t out[8];
+
+    uint64_t start = get_nanos();
+
+    for (size_t i = 0; i < num_ops; i++) {
+        ring_push(&rb, data, 8);
+        ring_pop(&rb, out, 8);
+    }
+
+    uint64_t end = get_nanos();
+
+    double ns_per_pair = (double)(end - start) / (double)num_ops;
+    double ops_per_sec = 1e9 / ns_per_pair * 2;
+
+    printf("  %zu push+pop pairs:\n", num_ops);
+    printf("    Total time: %.3f ms\n", (double)(end - start) / 1e6);
+    printf("    %.1f ns per push+pop pair\n", ns_per_pair);
+    printf("    %.2f M ops/sec\n", ops_per_sec / 1e6);
+
+    ring_destroy(&rb);
+}
+
+/* ============ Harness (repeated runs, machine-readable output) ============ */
+
+#define MAX_BENCH_METRICS 6
+#define HARNESS_BATCH 64
+
+typedef struct {
+    const char *name;
+    const char *unit;
+} bench_metric_t;
+
+typedef struct {
+    const char *name;
+    size_t default_count;
+    size_t default_capacity;
+    bool uses_depth;        /* Keeps --depth messages in flight per ring */
+    size_t num_metrics;
+    bench_metric_t metrics[MAX_BENCH_METRICS];
+    void (*run)(size_t message_size, size_t count, double *out);   /* One rep */
+} bench_def_t;
+
+static void throughput_metrics(size_t message_size, size_t count, uint64_t elapsed_ns, double *out) {
+    out[0] = mb_per_sec(message_size, count, elapsed_ns);
+    out[1] = (double)count / ((double)elapsed_ns / 1e9) / 1e6;
+    out[2] = (double)elapsed_ns / (double)count;
+}
+
+static void measure_throughput(size_t message_size, size_t count, double *out) {
+    throughput_metrics(message_size, count,
+                       run_throughput(ring_push, ring_pop, false, message_size, count), out);
+}
+
+static void measure_batch(size_t message_size, size_t count, double *out) {
+    throughput_metrics(message_size, count,
+                       run_throughput_batch(message_size, count, HARNESS_BATCH), out);
+}
+
+static void measure_staged(size_t message_size, size_t count, double *out) {
+    throughput_metrics(message_size, count, run_throughput_staged(message_size, count), out);
+}
+
+static void measure_drain(size_t message_size, size_t count, double *out) {
+    throughput_metrics(message_size, count, run_throughput_drain(message_size, count), out);
+}
+
+static void measure_latency(size_t message_size, size_t count, double *out) {
+    run_latency(message_size, count);
+    out[0] = (double)hist_ns(50.0);
+    out[1] = (double)hist_ns(99.0);
+    out[2] = (double)hist_ns(99.9);
+    out[3] = (double)hist_ns(99.99);
+    out[4] = (double)ring_clock_to_ns(&bench_clock, ring_hist_max(&bench_hist));
+    out[5] = ring_hist_mean(&bench_hist) * bench_clock.ns_per_tick;
+}
+
+static void measure_scaling(size_t message_size, size_t count, double *out) {
+    double pair_mbps[MAX_SCALE_PAIRS];
+    size_t pairs = bench_cfg.pairs;
+    uint64_t elapsed_ns = run_scaling(message_size, count, pairs, bench_cfg.topology, pair_mbps);
+    bench_summary_t s = summarize(pair_mbps, pairs);
+    out[0] = mb_per_sec(message_size, pairs * count, elapsed_ns);
+    out[1] = (double)(pairs * count) / ((double)elapsed_ns / 1e9) / 1e6;
+    out[2] = s.min;
+    out[3] = s.median;
+    out[4] = s.max;
+}
+
+static void measure_pingpong(size_t message_size, size_t count, double *out) {
+    uint64_t elapsed_ns = run_pingpong(message_size, count, bench_cfg.depth);
+    out[0] = (double)hist_ns(50.0);
+    out[1] = (double)hist_ns(99.0);
+    out[2] = (double)hist_ns(99.9);
+    out[3] = (double)ring_clock_to_ns(&bench_clock, ring_hist_max(&bench_hist));
+    out[4] = ring_hist_mean(&bench_hist) * bench_clock.ns_per_tick;
+    out[5] = (double)count / ((double)elapsed_ns / 1e9) / 1e6;
+}
+
+#define THROUGHPUT_METRICS { { "bandwidth", "MB/s" }, { "rate", "Mmsg/s" }, { "cost", "ns/msg" } }
+
+static const bench_def_t bench_defs[] = {
+    { "throughput", 2000000, BENCH_CAPACITY, false, 3, THROUGHPUT_METRICS, measure_throughput },
+    { "batch", 2000000, BENCH_CAPACITY, false, 3, THROUGHPUT_METRICS, measure_batch },
+    { "staged", 2000000, BENCH_CAPACITY, false, 3, THROUGHPUT_METRICS, measure_staged },
+    { "drain", 2000000, BENCH_CAPACITY, false, 3, THROUGHPUT_METRICS, measure_drain },
+    { "latency", 1000000, BUFFER_SIZE, false, 6,
+      { { "p50", "ns" }, { "p99", "ns" }, { "p99.9", "ns" },
+        { "p99.99", "ns" }, { "max", "ns" }, { "mean", "ns" } },
+      measure_latency },
+    { "pingpong", 1000000, BENCH_CAPACITY, true, 6,
+      { { "rtt_p50", "ns" }, { "rtt_p99", "ns" }, { "rtt_p99.9", "ns" },
+        { "rtt_max", "ns" }, { "rtt_mean", "ns" }, { "rate", "Mrt/s" } },
+      measure_pingpong },
+    { "scaling", 2000000, BENCH_CAPACITY, false, 5,
+      { { "aggregate", "MB/s" }, { "aggregate_rate", "Mmsg/s" }, { "pair_min", "MB/s" },
+        { "pair_median", "MB/s" }, { "pair_max", "MB/s" } },
+      measure_scaling }
+};
+
+#define NUM_BENCH_DEFS (sizeof(bench_defs) / sizeof(bench_defs[0]))
+
+static const bench_def_t *find_bench(const char *name, size_t len) {
+    for (size_t i = 0; i < NUM_BENCH_DEFS; i++) {
+        if (strlen(bench_defs[i].name) == len && strncmp(bench_defs[i].name, name, len) == 0) {
+            return &bench_defs[i];
+        }
+    }
+    return NULL;
+}
+
+/* What the benchmark rings copy with, for the report header */
+static const char *bench_kernel_name(void) {
+    return bench_cfg.kernel != NULL ? bench_cfg.kernel : ring_copy_kernel_best()->name;
+}
+
+static size_t reported_results;
+
+static void report_begin(void) {
+    const bench_config_t *c = &bench_cfg;
+
+    switch (c->format) {
+    case BENCH_FORMAT_JSON:
+        printf("{\n  \"config\": {\"clock\": \"%s\", \"copy_kernel\": \"%s\", \"producer_cpu\": %d, \"consumer_cpu\": %d, "
+               "\"depth\": %zu, \"pairs\": %zu, \"topology\": \"%s\", \"stream\": %s, \"prefetch\": %s, "
+               "\"warmup\": %zu, \"reps\": %zu},\n  \"results\": [",
+               ring_clock_name(&bench_clock), bench_kernel_name(), c->producer_cpu, c->consumer_cpu,
+               c->depth, c->pairs, topology_names[c->topology],
+               c->hints & RING_HINT_STREAM ? "true" : "false",
+               c->hints & RING_HINT_PREFETCH ? "true" : "false", c->warmup, c->reps);
+        break;
+    case BENCH_FORMAT_CSV:
+        printf("bench,message_size,messages,capacity,producer_cpu,consumer_cpu,depth,"
+               "metric,unit,reps,median,mean,stddev,min,max\n");
+        break;
+    default:
+        printf("Ring Buffer Benchmark Harness\n");
+        printf("  copy kernel %s\n", bench_kernel_name());
+        printf("  clock %s, producer cpu %d, consumer cpu %d, depth %zu, %zu pairs (%s), "
+               "%zu warm-up + %zu reps\n",
+               ring_clock_name(&bench_clock), c->producer_cpu, c->consumer_cpu,
+               c->depth, c->pairs, topology_names[c->topology], c->warmup, c->reps);
+        break;
+    }
+}
+
+static void report_result(const bench_def_t *def, size_t message_size, size_t count,
+                          size_t capacity, const bench_metric_t *m, const bench_summary_t *s) {
+    const bench_config_t *c = &bench_cfg;
+
+    switch (c->format) {
+    case BENCH_FORMAT_JSON:
+        printf("%s\n    {\"bench\": \"%s\", \"message_size\": %zu, \"messages\": %zu, "
+               "\"capacity\": %zu, \"metric\": \"%s\", \"unit\": \"%s\", \"reps\": %zu, "
+               "\"median\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f, \"max\": %.3f}",
+               reported_results ? "," : "", def->name, message_size, count, capacity,
+               m->name, m->unit, c->reps, s->median, s->mean, s->stddev, s->min, s->max);
+        break;
+    case BENCH_FORMAT_CSV:
+        printf("%s,%zu,%zu,%zu,%d,%d,%zu,%s,%s,%zu,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+               def->name, message_size, count, capacity, c->producer_cpu, c->consumer_cpu,
+               def->uses_depth ? c->depth : 1, m->name, m->unit, c->reps, s->median, s->mean, s->stddev, s->min, s->max);
+        break;
+    default:
+        printf("    %-14s %12.2f %-6s  (mean %.2f, stddev %.2f, min %.2f, max %.2f)\n",
+               m->name, s->median, m->unit, s->mean, s->stddev, s->min, s->max);
+        break;
+    }
+    reported_results++;
+}
+
+static void report_end(void) {
+    if (bench_cfg.format == BENCH_FORMAT_JSON) printf("\n  ]\n}\n");
+}
+
+/* Warm up, then run `reps` times and report each metric's distribution */
+static void run_harness_bench(const bench_def_t *def, size_t message_size) {
+    size_t count = bench_cfg.count != 0 ? bench_cfg.count : def->default_count;
+    size_t capacity = bench_capacity(def->default_capacity);
+    size_t reps = bench_cfg.reps;
+
+    double *samples = malloc(def->num_metrics * reps * sizeof(*samples));
+    double out[MAX_BENCH_METRICS];
+    if (samples == NULL) {
+        fprintf(stderr, "sample allocation failed\n");
+        exit(1);
+    }
+
+    for (size_t w = 0; w < bench_cfg.warmup; w++) def->run(message_size, count, out);
+    for (size_t r = 0; r < reps; r++) {
+        def->run(message_size, count, out);
+        for (size_t m = 0; m < def->num_metrics; m++) samples[m * reps + r] = out[m];
+    }
+
+    if (bench_cfg.format == BENCH_FORMAT_TEXT) {
+        printf("\n  %s, %zu bytes x %zu msgs, %zu-byte ring:\n",
+               def->name, message_size, count, capacity);
+    }
+    for (size_t m = 0; m < def->num_metrics; m++) {
+        bench_summary_t s = summarize(&samples[m * reps], reps);
+        report_result(def, message_size, count, capacity, &def->metrics[m], &s);
+    }
+
+    free(samples);
+}
+
+/*
+ * Every message in flight must fit its ring at once; anything larger would
+ * spin the producer forever.
+ */
+static bool check_harness_config(void) {
+    for (const char *p = bench_cfg.benches; *p != '\0';) {
+        size_t len = strcspn(p, ",");
+        const bench_def_t *def = find_bench(p, len);
+        if (def == NULL) {
+            fprintf(stderr, "unknown benchmark '%.*s'\n", (int)len, p);
+            return false;
+        }
+        size_t capacity = bench_capacity(def->default_capacity);
+        size_t in_flight = def->uses_depth ? bench_cfg.depth : 1;
+        for (size_t i = 0; i < bench_cfg.num_sizes; i++) {
+            if (bench_cfg.sizes[i] > capacity / in_flight) {
+                fprintf(stderr, "%s: %zu x %zu-byte messages don't fit a %zu-byte ring\n",
+                        def->name, in_flight, bench_cfg.sizes[i], capacity);
+                return false;
+            }
+        }
+        if (strcmp(def->name, "scaling") == 0) {
+            int producer_cpus[MAX_SCALE_PAIRS], consumer_cpus[MAX_SCALE_PAIRS];
+            size_t placed = place_pairs(bench_cfg.topology, bench_cfg.pairs,
+                                        producer_cpus, consumer_cpus);
+            if (placed < bench_cfg.pairs) {
+                fprintf(stderr, "scaling: topology %s fits %zu of %zu pairs on this machine\n",
+                        topology_names[bench_cfg.topology], placed, bench_cfg.pairs);
+                return false;
+            }
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+    return true;
+}
+
+static void run_harness(void) {
+    report_begin();
+    for (const char *p = bench_cfg.benches; *p != '\0';) {
+        size_t len = strcspn(p, ",");
+        const bench_def_t *def = find_bench(p, len);
+        for (size_t i = 0; i < bench_cfg.num_sizes; i++) {
+            run_harness_bench(def, bench_cfg.sizes[i]);
+        }
+        p += len;
+        if (*p == ',') p++;
+    }
+    report_end();
+}
+
+/* ============ Command Line ============ */
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "\n"
+            "Without --bench, text output runs the full benchmark suite; json and csv\n"
+            "default to --bench throughput,latency.\n"
+            "\n"
+            "  -b, --bench LIST         comma-separated: throughput, batch, staged,\n"
+            "                           drain, latency, pingpong, scaling\n"
+            "  -s, --sizes LIST         message sizes in bytes (default 8,64,256)\n"
+            "  -n, --count N            messages per rep (default: per benchmark)\n"
+            "  -c, --capacity BYTES     ring capacity, a power of two (default: per benchmark)\n"
+            "  -p, --producer-cpu CPU   pin the producer thread\n"
+            "  -C, --consumer-cpu CPU   pin the consumer thread\n"
+            "  -d, --depth N            pingpong requests in flight (default 1)\n"
+            "  -k, --pairs N            scaling: concurrent ring pairs (default 4, max %d)\n"
+            "  -t, --topology TOPO      scaling: none, smt, socket or cross (default none)\n"
+            "  -K, --kernel NAME        copy kernel (default: best this CPU supports)\n"
+            "  -H, --hints LIST         ring copy hints: stream, prefetch (default none)\n"
+            "  -w, --warmup N           discarded runs before measuring (default 1)\n"
+            "  -r, --reps N             measured runs; median/stddev over these (default 5)\n"
+            "  -f, --format FMT         text, json or csv (default text)\n"
+            "  -h, --help               show this help\n",
+            prog, MAX_SCALE_PAIRS);
+}
+
+static bool parse_size(const char *s, size_t *out) {
+    char *end;
+    errno = 0;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (errno != 0 || end == s || *end != '\0' || s[0] == '-') return false;
+    *out = (size_t)v;
+    return true;
+}
+
+static bool parse_cpu(const char *s, int *out) {
+    size_t v;
+    if (!parse_size(s, &v) || v >= CPU_SETSIZE) return false;
+    *out = (int)v;
+    return true;
+}
+
+static bool parse_sizes(char *list) {
+    bench_cfg.num_sizes = 0;
+    for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (bench_cfg.num_sizes == MAX_BENCH_SIZES) return false;
+        size_t v;
+        if (!parse_size(tok, &v) || v == 0) return false;
+        bench_cfg.sizes[bench_cfg.num_sizes++] = v;
+    }
+    return bench_cfg.num_sizes > 0;
+}
+
+static bool parse_hints(char *list) {
+    bench_cfg.hints = 0;
+    for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (strcmp(tok, "stream") == 0) bench_cfg.hints |= RING_HINT_STREAM;
+        else if (strcmp(tok, "prefetch") == 0) bench_cfg.hints |= RING_HINT_PREFETCH;
+        else if (strcmp(tok, "none") != 0) return false;
+    }
+    return true;
+}
+
+/* Returns false (after printing why) on a bad command line */
+static bool parse_args(int argc, char **argv) {
+    static const struct option long_opts[] = {
+        { "bench", required_argument, NULL, 'b' },
+        { "sizes", required_argument, NULL, 's' },
+        { "count", required_argument, NULL, 'n' },
+        { "capacity", required_argument, NULL, 'c' },
+        { "producer-cpu", required_argument, NULL, 'p' },
+        { "consumer-cpu", required_argument, NULL, 'C' },
+        { "depth", required_argument, NULL, 'd' },
+        { "pairs", required_argument, NULL, 'k' },
+        { "topology", required_argument, NULL, 't' },
+        { "hints", required_argument, NULL, 'H' },
+        { "kernel", required_argument, NULL, 'K' },
+        { "warmup", required_argument, NULL, 'w' },
+        { "reps", required_argument, NULL, 'r' },
+        { "format", required_argument, NULL, 'f' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:s:n:c:p:C:d:k:t:H:K:w:r:f:h", long_opts, NULL)) != -1) {
+        bool ok = true;
+        switch (opt) {
+        case 'b': bench_cfg.benches = optarg; break;
+        case 's': ok = parse_sizes(optarg); break;
+        case 'n': ok = parse_size(optarg, &bench_cfg.count) && bench_cfg.count > 0; break;
+        case 'c':
+            ok = parse_size(optarg, &bench_cfg.capacity) && bench_cfg.capacity > 0 &&
+                 (bench_cfg.capacity & (bench_cfg.capacity - 1)) == 0;
+            break;
+        case 'p': ok = parse_cpu(optarg, &bench_cfg.producer_cpu); break;
+        case 'C': ok = parse_cpu(optarg, &bench_cfg.consumer_cpu); break;
+        case 'd': ok = parse_size(optarg, &bench_cfg.depth) && bench_cfg.depth > 0; break;
+        case 'k':
+            ok = parse_size(optarg, &bench_cfg.pairs) && bench_cfg.pairs > 0 &&
+                 bench_cfg.pairs <= MAX_SCALE_PAIRS;
+            break;
+        case 't':
+            ok = false;
+            for (int t = BENCH_TOPO_NONE; t <= BENCH_TOPO_CROSS; t++) {
+                if (strcmp(optarg, topology_names[t]) == 0) {
+                    bench_cfg.topology = t;
+                    ok = true;
+                }
+            }
+            break;
+        case 'H': ok = parse_hints(optarg); break;
+        case 'K':
+            bench_cfg.kernel = optarg;
+            ok = ring_copy_kernel_find(optarg) != NULL;
+            break;
+        case 'w': ok = parse_size(optarg, &bench_cfg.warmup); break;
+        case 'r': ok = parse_size(optarg, &bench_cfg.reps) && bench_cfg.reps > 0; break;
+        case 'f':
+            if (strcmp(optarg, "text") == 0) bench_cfg.format = BENCH_FORMAT_TEXT;
+            else if (strcmp(optarg, "json") == 0) bench_cfg.format = BENCH_FORMAT_JSON;
+            else if (strcmp(optarg, "csv") == 0) bench_cfg.format = BENCH_FORMAT_CSV;
+            else ok = false;
+            break;
+        case 'h':
+            usage(argv[0]);
+            exit(0);
+        default:
+            usage(argv[0]);
+            return false;
+        }
+        if (!ok) {
+            fprintf(stderr, "invalid argument for -%c: '%s'\n", opt, optarg);
+            return false;
+        }
+    }
+    if (optind < argc) {
+        fprintf(stderr, "unexpected argument '%s'\n", argv[optind]);
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+/* ============ Main ============ */
+
+static void run_suite(void) {
     printf("Ring Buffer Performance Benchmarks\n");
     printf("===================================\n\n");
 
+    printf("Copy kernel: %s\n\n", bench_kernel_name());
+
+    printf("Timestamp cost:\n");
+    bench_clock_overhead();
+    printf("\n");
+
     printf("Single-threaded baseline:\n");
     bench_single_threaded();
 
-    printf("\nThroughput (SPSC, spinning):\n");
+    printf("\nCopy kernels (single-threaded push+pop, ns per pair):\n");
+    bench_copy_kernels(64, 2000000);
+    bench_copy_kernels(256, 2000000);
+    bench_copy_kernels(1024, 1000000);
+    bench_copy_kernels(4096, 200000);
+
+    printf("\nThroughput (SPSC, spinning, %d KiB ring):\n", BENCH_CAPACITY / 1024);
     bench_throughput(1, 10000000);
     bench_throughput(8, 10000000);
     bench_throughput(64, 5000000);
     bench_throughput(256, 2000000);
     bench_throughput(512, 1000000);
 
-    printf("\nLatency distribution (SPSC):\n");
-    bench_latency(8, 100000);
-    bench_latency(64, 100000);
-    bench_latency(256, 50000);
+    printf("\nThroughput (SPSC, staged pushes, publish per %d bytes or %d msgs):\n",
+           STAGED_FLUSH_BYTES, STAGED_FLUSH_MSGS);
+    bench_throughput_staged(1, 10000000);
+    bench_throughput_staged(8, 10000000);
+    bench_throughput_staged(64, 5000000);
+
+    printf("\nThroughput (SPSC, RING_DEFINE typed slots, same byte capacity):\n");
+    bench_throughput_typed8(10000000);
+    bench_throughput_typed64(5000000);
+    bench_throughput_typed256(2000000);
+
+    printf("\nThroughput (SPSC, batched, one index publish per batch):\n");
+    bench_throughput_batch(1, 10000000, 64);
+    bench_throughput_batch(8, 10000000, 64);
+
+    printf("\nThroughput (SPSC, consumer drains everything readable per pass):\n");
+    bench_throughput_drain(1, 10000000);
+    bench_throughput_drain(8, 10000000);
+    bench_throughput_drain(64, 5000000);
+
+    printf("\nThroughput (MPSC, CAS-reserved head, 1 consumer):\n");
+    for (size_t producers = 1; producers <= 8; producers *= 2) {
+        bench_throughput_mpsc(64, 4000000, producers);
+    }
+
+    printf("\nMPMC queue vs independent SPSC rings (%d-byte messages):\n", MPMC_BENCH_SLOT);
+    for (size_t pairs = 1; pairs <= 4; pairs *= 2) {
+        bench_mpmc_vs_spsc(pairs, 2000000);
+    }
+
+    printf("\nScaling (independent SPSC pairs running at once, 64-byte messages, topology %s):\n",
+           topology_names[bench_cfg.topology]);
+    for (size_t pairs = 1; pairs <= 16; pairs *= 2) {
+        bench_scaling(64, 2000000, pairs, bench_cfg.topology);
+    }
 
-    printf("\nContention analysis:\n");
-    bench_contention();
+    printf("\nCopy strategy (per-byte loop vs two-segment memcpy vs mirrored ring):\n");
+    printf("  %-9s  %14s  %14s  %7s  %14s\n", "size", "per-byte", "memcpy", "speedup", "mirrored");
+    bench_copy_strategy(8, 5000000);
+    bench_copy_strategy(64, 2000000);
+    bench_copy_strategy(256, 1000000);
+    bench_copy_strategy(512, 500000);
+
+    printf("\nPage size (SPSC, %zu MiB ring):\n", PAGE_BENCH_CAPACITY >> 20);
+    bench_page_size("4K", RING_PAGES_DEFAULT, 512, 1000000);
+    bench_page_size("THP", RING_PAGES_THP, 512, 1000000);
+    bench_page_size("2M", RING_PAGES_HUGE_2M, 512, 1000000);
+    bench_page_size("1G", RING_PAGES_HUGE_1G, 512, 1000000);
+    bench_page_size("4K", RING_PAGES_DEFAULT, 4096, 200000);
+    bench_page_size("THP", RING_PAGES_THP, 4096, 200000);
+
+    printf("\nBulk payloads (SPSC, %zu MiB ring, streaming stores / consumer prefetch):\n",
+           BULK_BENCH_CAPACITY >> 20);
+    printf("  %-22s%14s  %14s  %14s  %14s\n", "size", "memcpy", "stream", "prefetch", "both");
+    bench_copy_hints(4096, 262144);
+    bench_copy_hints(16384, 65536);
+    bench_copy_hints(65536, 16384);
+
+    printf("\nLatency distribution (SPSC):\n");
+    bench_latency(8, 10000000);
+    bench_latency(64, 10000000);
+    bench_latency(256, 5000000);
+
+    printf("\nPing-pong round trip (request ring + reply ring, client-side RTT):\n");
+    bench_pingpong(64, 1000000, 1);
+    bench_pingpong(64, 1000000, 8);
+    bench_pingpong(64, 1000000, 32);
+
+    printf("\nLossy producer (overwrite-oldest, no consumer, ns per push):\n");
+    bench_lossy_push(8, 10000000);
+    bench_lossy_push(64, 10000000);
+    bench_lossy_push(256, 5000000);
+
+    printf("\nDraining to a file descriptor (/dev/null, %d KiB fills, single-threaded):\n",
+           BENCH_CAPACITY / 1024);
+    bench_fd_drain(64, (size_t)2 << 30);
+    bench_fd_drain(1024, (size_t)2 << 30);
+
+    printf("\nAsync logger (caller-side cost per ring_log call):\n");
+    bench_log_calls();
+
+    printf("\nPipeline, producer + %d stages (one ring per hop vs one shared buffer):\n", PIPE_STAGES);
+    bench_pipeline(64, 2000000);
+    bench_pipeline(256, 1000000);
+    bench_pipeline(1024, 500000);
+
+    printf("\nWait strategies (8-byte messages every 20 us):\n");
+    bench_wait_strategy("spin", RING_WAIT_SPIN, 50000, 20000);
+    bench_wait_strategy("pause", RING_WAIT_PAUSE, 50000, 20000);
+    bench_wait_strategy("yield", RING_WAIT_YIELD, 50000, 20000);
+    bench_wait_strategy("futex", RING_WAIT_FUTEX, 50000, 20000);
+
+#ifdef RING_STATS
+    printf("\nContention analysis (remote index re-read on every op vs cached; RING_STATS counters):\n");
+#else
+    printf("\nContention analysis (remote index re-read on every op vs cached):\n");
+#endif
+    bench_contention("uncached", uncached_push, uncached_pop);
+    bench_contention("cached", ring_push, ring_pop);
 
     printf("\n===================================\n");
     printf("Benchmark complete.\n");
+}
+
+int main(int argc, char **argv) {
+    if (!parse_args(argc, argv)) return 2;
+
+    ring_clock_init(&bench_clock, RING_CLOCK_AUTO);
+
+    if (bench_cfg.benches == NULL) {
+        if (bench_cfg.format == BENCH_FORMAT_TEXT) {
+            run_suite();
+            return 0;
+        }
+        bench_cfg.benches = "throughput,latency";
+    }
+    if (!check_harness_config()) return 2;
 
+    run_harness();
     return 0;
 }
@@ -9,8 +9,20 @@
 #include <pthread.h>
 #include <stdatomic.h>
 #include <unistd.h>
+#include <sys/wait.h>
 
 #include "ring_buffer.c"
+#include "ring_mpsc.c"
+#include "ring_mpmc.c"
+#include "ring_broadcast.c"
+#include "ring_wait.c"
+#include "ring_shm.c"
+#include "ring_mirror.c"
+#include "ring_typed.c"
+#include "ring_lossy.c"
+#include "ring_log.c"
+#include "ring_sink.c"
+#include "ring_pipeline.c"
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -30,10 +42,12 @@ static int tests_failed = 0;
 
 /* ============ Helper to initialize buffer ============ */
 
+/* Tests run one at a time, so they share one caller-provided backing region */
+static alignas(CACHE_LINE) uint8_t test_storage[BUFFER_SIZE];
+
 static void init_buffer(ring_buffer_t *rb) {
-    memset(rb, 0, sizeof(*rb));
-    atomic_store(&rb->head, 0);
-    atomic_store(&rb->tail, 0);
+    memset(test_storage, 0, sizeof(test_storage));
+    ring_init(rb, BUFFER_SIZE, test_storage);
 }
 
 /* ============ Test Infrastructure ============ */
@@ -285,6 +299,98 @@ TEST(spsc_variable_size_messages) {
     return 0;
 }
 
+/* ============ Framed Messages ============ */
+
+static void *producer_framed(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    uint8_t data[200];
+
+    for (size_t msg_id = 0; msg_id < args->num_messages; msg_id++) {
+        /* The consumer learns the size from the frame header, not from msg_id */
+        size_t size = (msg_id * 7919) % 197 + 3;
+        data[0] = (uint8_t)(msg_id & 0xFF);
+        data[1] = (uint8_t)((msg_id >> 8) & 0xFF);
+        for (size_t j = 2; j < size; j++) {
+            data[j] = (uint8_t)((msg_id + j) & 0xFF);
+        }
+
+        /* Alternate between wrapped and padded frames */
+        bool pad = (msg_id & 1) != 0;
+        while (!(pad ? ring_push_msg_contiguous(args->rb, data, size)
+                     : ring_push_msg(args->rb, data, size))) {
+            sched_yield();
+        }
+        atomic_fetch_add(args->produced, 1);
+    }
+
+    return NULL;
+}
+
+static void *consumer_framed(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    uint8_t data[200];
+    size_t expected_id = 0;
+
+    while (expected_id < args->num_messages) {
+        size_t len;
+        if (!ring_pop_msg(args->rb, data, sizeof(data), &len)) {
+            sched_yield();
+            continue;
+        }
+
+        size_t got_id = data[0] | ((size_t)data[1] << 8);
+        if (got_id != (expected_id & 0xFFFF)) {
+            fprintf(stderr, "Framed ordering error: expected %zu, got %zu\n",
+                    expected_id, got_id);
+            return (void *)1;
+        }
+        for (size_t j = 2; j < len; j++) {
+            if (data[j] != (uint8_t)((expected_id + j) & 0xFF)) {
+                fprintf(stderr, "Framed corruption at msg %zu, byte %zu (len %zu)\n",
+                        expected_id, j, len);
+                return (void *)1;
+            }
+        }
+
+        atomic_fetch_add(args->consumed, 1);
+        expected_id++;
+    }
+
+    return NULL;
+}
+
+TEST(spsc_framed_variable_size_messages) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    atomic_bool stop = false;
+
+    thread_args_t args = {
+        .rb = &rb,
+        .num_messages = 50000,
+        .message_size = 0,
+        .stop = &stop,
+        .produced = &produced,
+        .consumed = &consumed
+    };
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, producer_framed, &args);
+    pthread_create(&consumer, NULL, consumer_framed, &args);
+
+    void *producer_result, *consumer_result;
+    pthread_join(producer, &producer_result);
+    pthread_join(consumer, &consumer_result);
+
+    if (consumer_result != NULL) return 1;
+    if (atomic_load(&produced) != args.num_messages) return 1;
+    if (atomic_load(&consumed) != args.num_messages) return 1;
+
+    return 0;
+}
+
 /* ============ Burst Test ============ */
 
 typedef struct {
@@ -383,17 +489,1305 @@ TEST(spsc_burst_pattern) {
     return 0;
 }
 
-int main(void) {
-    printf("Running integration tests...\n\n");
+/* Drains whole 8-byte ids; a record may straddle the two segments */
+typedef struct {
+    size_t expected;
+    size_t max_batch;
+    int error;
+} burst_drain_state_t;
+
+static size_t burst_drain_records(const ring_span_t *span, void *ctx) {
+    burst_drain_state_t *st = (burst_drain_state_t *)ctx;
+    size_t total = span->first_len + span->second_len;
+    size_t records = total / 8;
+
+    for (size_t r = 0; r < records; r++) {
+        uint8_t data[8];
+        for (size_t k = 0; k < 8; k++) {
+            size_t off = r * 8 + k;
+            data[k] = off < span->first_len ? span->first[off] : span->second[off - span->first_len];
+        }
+        size_t got;
+        memcpy(&got, data, sizeof(got));
+        if (got != st->expected) {
+            fprintf(stderr, "Drain order error: expected %zu, got %zu\n", st->expected, got);
+            st->error = 1;
+            return 0;
+        }
+        st->expected++;
+    }
+    if (records > st->max_batch) st->max_batch = records;
+    return records * 8;
+}
 
-    printf("SPSC Correctness:\n");
-    RUN_TEST(spsc_small_messages);
-    RUN_TEST(spsc_large_messages);
-    RUN_TEST(spsc_single_byte_messages);
+static void *burst_drain_consumer(void *arg) {
+    burst_cons_args_t *a = (burst_cons_args_t *)arg;
+    burst_drain_state_t st = {0};
 
-    printf("\nStress Tests:\n");
-    RUN_TEST(spsc_variable_size_messages);
-    RUN_TEST(spsc_burst_pattern);
+    while (st.expected < a->total_msgs && !st.error) {
+        if (ring_drain(a->rb, SIZE_MAX, burst_drain_records, &st) == 0) sched_yield();
+        atomic_store(a->consumed, st.expected);
+    }
+    *a->error = st.error;
+    return NULL;
+}
+
+TEST(spsc_burst_pattern_drained) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    const size_t burst_size = 100;
+    const size_t num_bursts = 1000;
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    int error = 0;
+
+    burst_prod_args_t prod_args = { &rb, burst_size, num_bursts, &produced };
+    burst_cons_args_t cons_args = { &rb, burst_size * num_bursts, &consumed, &error };
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, burst_producer, &prod_args);
+    pthread_create(&consumer, NULL, burst_drain_consumer, &cons_args);
+
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    if (error) return 1;
+    if (atomic_load(&consumed) != burst_size * num_bursts) return 1;
+
+    return 0;
+}
+
+/* ============ Zero-Copy API ============ */
+
+static void *producer_reserve_commit(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    ring_span_t span;
+
+    for (size_t i = 0; i < args->num_messages; i++) {
+        while (!ring_reserve(args->rb, args->message_size, &span)) {
+            sched_yield();
+        }
+
+        /* Build the message in place, across the wrap if needed */
+        for (size_t j = 0; j < args->message_size; j++) {
+            uint8_t *p = j < span.first_len ? span.first + j
+                                            : span.second + (j - span.first_len);
+            *p = (uint8_t)((i + j) & 0xFF);
+        }
+
+        ring_commit(args->rb, args->message_size);
+        atomic_fetch_add(args->produced, 1);
+    }
+
+    return NULL;
+}
+
+static void *consumer_peek_release(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    ring_span_t span;
+
+    for (size_t i = 0; i < args->num_messages; i++) {
+        while (!ring_peek(args->rb, args->message_size, &span)) {
+            sched_yield();
+        }
+
+        for (size_t j = 0; j < args->message_size; j++) {
+            uint8_t b = j < span.first_len ? span.first[j]
+                                           : span.second[j - span.first_len];
+            if (b != (uint8_t)((i + j) & 0xFF)) {
+                fprintf(stderr, "Zero-copy corruption at msg %zu, byte %zu\n", i, j);
+                return (void *)1;
+            }
+        }
+
+        ring_release(args->rb, args->message_size);
+        atomic_fetch_add(args->consumed, 1);
+    }
+
+    return NULL;
+}
+
+TEST(spsc_reserve_commit_peek_release) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    atomic_bool stop = false;
+
+    /* 37 does not divide the capacity, so messages regularly straddle the wrap */
+    thread_args_t args = {
+        .rb = &rb,
+        .num_messages = 100000,
+        .message_size = 37,
+        .stop = &stop,
+        .produced = &produced,
+        .consumed = &consumed
+    };
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, producer_reserve_commit, &args);
+    pthread_create(&consumer, NULL, consumer_peek_release, &args);
+
+    void *producer_result, *consumer_result;
+    pthread_join(producer, &producer_result);
+    pthread_join(consumer, &consumer_result);
+
+    if (consumer_result != NULL) return 1;
+    if (atomic_load(&produced) != args.num_messages) return 1;
+    if (atomic_load(&consumed) != args.num_messages) return 1;
+
+    return 0;
+}
+
+/* ============ Batched API ============ */
+
+#define BATCH 32
+
+static void *producer_batch(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    uint8_t data[BATCH][8];
+    ring_iovec_t iov[BATCH];
+    size_t next = 0;
+
+    while (next < args->num_messages) {
+        size_t n = args->num_messages - next < BATCH ? args->num_messages - next : BATCH;
+        for (size_t k = 0; k < n; k++) {
+            size_t id = next + k;
+            memcpy(data[k], &id, sizeof(id));
+            iov[k].base = data[k];
+            iov[k].len = 8;
+        }
+
+        /* Partial batches are resubmitted from the first unsent message */
+        size_t done = 0;
+        while (done < n) {
+            size_t pushed = ring_push_batch(args->rb, iov + done, n - done);
+            if (pushed == 0) sched_yield();
+            done += pushed;
+        }
+        next += n;
+        atomic_fetch_add(args->produced, n);
+    }
+
+    return NULL;
+}
+
+static void *consumer_batch(void *arg) {
+    thread_args_t *args = (thread_args_t *)arg;
+    uint8_t data[BATCH][8];
+    ring_iovec_t iov[BATCH];
+    size_t expected = 0;
+
+    for (size_t k = 0; k < BATCH; k++) {
+        iov[k].base = data[k];
+        iov[k].len = 8;
+    }
+
+    while (expected < args->num_messages) {
+        size_t want = args->num_messages - expected < BATCH ? args->num_messages - expected : BATCH;
+        size_t got = ring_pop_batch(args->rb, iov, want);
+        if (got == 0) {
+            sched_yield();
+            continue;
+        }
+
+        for (size_t k = 0; k < got; k++) {
+            size_t id;
+            memcpy(&id, data[k], sizeof(id));
+            if (id != expected) {
+                fprintf(stderr, "Batch order error: expected %zu, got %zu\n", expected, id);
+                return (void *)1;
+            }
+            expected++;
+        }
+        atomic_fetch_add(args->consumed, got);
+    }
+
+    return NULL;
+}
+
+TEST(spsc_batch_push_pop) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    atomic_bool stop = false;
+
+    thread_args_t args = {
+        .rb = &rb,
+        .num_messages = 200000,
+        .message_size = 8,
+        .stop = &stop,
+        .produced = &produced,
+        .consumed = &consumed
+    };
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, producer_batch, &args);
+    pthread_create(&consumer, NULL, consumer_batch, &args);
+
+    void *producer_result, *consumer_result;
+    pthread_join(producer, &producer_result);
+    pthread_join(consumer, &consumer_result);
+
+    if (consumer_result != NULL) return 1;
+    if (atomic_load(&produced) != args.num_messages) return 1;
+    if (atomic_load(&consumed) != args.num_messages) return 1;
+
+    return 0;
+}
+
+/* ============ MPSC ============ */
+
+#define MPSC_PRODUCERS 4
+
+typedef struct {
+    ring_mpsc_t *q;
+    size_t producer_id;
+    size_t num_messages;
+} mpsc_prod_args_t;
+
+/* Each message: producer id, per-producer sequence, and a check byte */
+static void *mpsc_producer(void *arg) {
+    mpsc_prod_args_t *a = (mpsc_prod_args_t *)arg;
+    uint8_t data[16];
+
+    for (size_t seq = 0; seq < a->num_messages; seq++) {
+        memcpy(data, &a->producer_id, sizeof(size_t));
+        memcpy(data + 8, &seq, sizeof(size_t));
+        memset(data + 8 + sizeof(size_t), 0, sizeof(data) - 8 - sizeof(size_t));
+
+        while (!ring_mpsc_push(a->q, data, sizeof(data))) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+TEST(mpsc_multiple_producers) {
+    ring_mpsc_t q;
+    if (!ring_mpsc_init(&q, BUFFER_SIZE, test_storage)) return 1;
+
+    const size_t per_producer = 20000;
+    mpsc_prod_args_t args[MPSC_PRODUCERS];
+    pthread_t producers[MPSC_PRODUCERS];
+
+    for (size_t p = 0; p < MPSC_PRODUCERS; p++) {
+        args[p] = (mpsc_prod_args_t){ &q, p, per_producer };
+        pthread_create(&producers[p], NULL, mpsc_producer, &args[p]);
+    }
+
+    /*
+     * Consume on this thread, checking per-producer FIFO order. Keep
+     * draining after an error so blocked producers can finish.
+     */
+    size_t next_seq[MPSC_PRODUCERS] = {0};
+    int error = 0;
+    for (size_t n = 0; n < MPSC_PRODUCERS * per_producer; ) {
+        uint8_t data[16];
+        if (!ring_mpsc_pop(&q, data, sizeof(data))) {
+            sched_yield();
+            continue;
+        }
+
+        size_t id, seq;
+        memcpy(&id, data, sizeof(size_t));
+        memcpy(&seq, data + 8, sizeof(size_t));
+        n++;
+        if (id >= MPSC_PRODUCERS || seq != next_seq[id]) {
+            if (!error) fprintf(stderr, "MPSC order error: producer %zu seq %zu\n", id, seq);
+            error = 1;
+            continue;
+        }
+        next_seq[id]++;
+    }
+
+    for (size_t p = 0; p < MPSC_PRODUCERS; p++) {
+        pthread_join(producers[p], NULL);
+    }
+    ring_mpsc_destroy(&q);
+
+    for (size_t p = 0; p < MPSC_PRODUCERS; p++) {
+        if (next_seq[p] != per_producer) return 1;
+    }
+    return error;
+}
+
+/* ============ MPMC ============ */
+
+#define MPMC_PRODUCERS 3
+#define MPMC_CONSUMERS 3
+#define MPMC_PER_PRODUCER 20000
+
+typedef struct {
+    ring_mpmc_t *q;
+    size_t id;
+    atomic_long *remaining;
+    uint8_t *seen;  /* [producer][seq], one flag per message */
+    atomic_int *error;
+} mpmc_args_t;
+
+static void *mpmc_producer(void *arg) {
+    mpmc_args_t *a = (mpmc_args_t *)arg;
+    uint8_t msg[16];
+
+    for (size_t seq = 0; seq < MPMC_PER_PRODUCER; seq++) {
+        memcpy(msg, &a->id, sizeof(size_t));
+        memcpy(msg + 8, &seq, sizeof(size_t));
+        while (!ring_mpmc_push(a->q, msg)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg) {
+    mpmc_args_t *a = (mpmc_args_t *)arg;
+    uint8_t msg[16];
+
+    /* Claim a message before popping so consumers know when to stop */
+    while (atomic_fetch_sub(a->remaining, 1) > 0) {
+        while (!ring_mpmc_pop(a->q, msg)) {
+            sched_yield();
+        }
+        size_t id, seq;
+        memcpy(&id, msg, sizeof(size_t));
+        memcpy(&seq, msg + 8, sizeof(size_t));
+        if (id >= MPMC_PRODUCERS || seq >= MPMC_PER_PRODUCER ||
+            a->seen[id * MPMC_PER_PRODUCER + seq]++ != 0) {
+            atomic_store(a->error, 1);
+        }
+    }
+    return NULL;
+}
+
+TEST(mpmc_multiple_producers_consumers) {
+    ring_mpmc_t q;
+    if (!ring_mpmc_init(&q, 64, 16, NULL)) return 1;
+
+    /* Consumers over-decrement by one each on exit, so the budget is signed */
+    atomic_long remaining = MPMC_PRODUCERS * MPMC_PER_PRODUCER;
+    atomic_int error = 0;
+    uint8_t *seen = calloc(MPMC_PRODUCERS * MPMC_PER_PRODUCER, 1);
+
+    pthread_t producers[MPMC_PRODUCERS], consumers[MPMC_CONSUMERS];
+    mpmc_args_t prod_args[MPMC_PRODUCERS], cons_args[MPMC_CONSUMERS];
+
+    for (size_t i = 0; i < MPMC_CONSUMERS; i++) {
+        cons_args[i] = (mpmc_args_t){ &q, i, &remaining, seen, &error };
+        pthread_create(&consumers[i], NULL, mpmc_consumer, &cons_args[i]);
+    }
+    for (size_t i = 0; i < MPMC_PRODUCERS; i++) {
+        prod_args[i] = (mpmc_args_t){ &q, i, &remaining, seen, &error };
+        pthread_create(&producers[i], NULL, mpmc_producer, &prod_args[i]);
+    }
+
+    for (size_t i = 0; i < MPMC_PRODUCERS; i++) pthread_join(producers[i], NULL);
+    for (size_t i = 0; i < MPMC_CONSUMERS; i++) pthread_join(consumers[i], NULL);
+
+    for (size_t i = 0; i < MPMC_PRODUCERS * MPMC_PER_PRODUCER; i++) {
+        if (seen[i] != 1) atomic_store(&error, 1);
+    }
+
+    free(seen);
+    ring_mpmc_destroy(&q);
+    return atomic_load(&error);
+}
+
+/* ============ Broadcast ============ */
+
+#define BROADCAST_READERS 3
+#define BROADCAST_MSG 16
+
+typedef struct {
+    ring_broadcast_t *b;
+    size_t reader;
+    size_t num_messages;
+    size_t received;
+    size_t lost_bytes;
+    int error;
+} broadcast_args_t;
+
+static void *broadcast_producer(void *arg) {
+    broadcast_args_t *a = (broadcast_args_t *)arg;
+    uint8_t msg[BROADCAST_MSG];
+
+    for (size_t seq = 0; seq < a->num_messages; seq++) {
+        memcpy(msg, &seq, sizeof(seq));
+        memset(msg + sizeof(seq), (int)(seq & 0xFF), BROADCAST_MSG - sizeof(seq));
+        while (!ring_broadcast_push(a->b, msg, BROADCAST_MSG)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Every message a reader gets must be intact and newer than the last one;
+ * received plus lost must account for every byte written.
+ */
+static void *broadcast_reader(void *arg) {
+    broadcast_args_t *a = (broadcast_args_t *)arg;
+    uint8_t msg[BROADCAST_MSG];
+    size_t total = a->num_messages * BROADCAST_MSG;
+    size_t next = 0;
+
+    while (a->received * BROADCAST_MSG + a->lost_bytes < total) {
+        size_t lost;
+        bool ok = ring_broadcast_pop(a->b, a->reader, msg, BROADCAST_MSG, &lost);
+        a->lost_bytes += lost;
+        next += lost / BROADCAST_MSG;
+        if (!ok) {
+            sched_yield();
+            continue;
+        }
+
+        size_t seq;
+        memcpy(&seq, msg, sizeof(seq));
+        if (seq != next) a->error = 1;
+        for (size_t j = sizeof(seq); j < BROADCAST_MSG; j++) {
+            if (msg[j] != (uint8_t)(seq & 0xFF)) a->error = 1;
+        }
+        next = seq + 1;
+        a->received++;
+
+        /* The last reader is deliberately slow */
+        if (a->reader == BROADCAST_READERS - 1 && (seq % 64) == 0) usleep(50);
+    }
+    return NULL;
+}
+
+static int run_broadcast(ring_broadcast_policy_t policy, size_t num_messages) {
+    ring_broadcast_t b;
+    if (!ring_broadcast_init(&b, BUFFER_SIZE, test_storage, BROADCAST_READERS, policy)) return 1;
+
+    broadcast_args_t prod = { &b, 0, num_messages, 0, 0, 0 };
+    broadcast_args_t readers[BROADCAST_READERS];
+    pthread_t producer, threads[BROADCAST_READERS];
+
+    for (size_t r = 0; r < BROADCAST_READERS; r++) {
+        readers[r] = (broadcast_args_t){ &b, r, num_messages, 0, 0, 0 };
+        pthread_create(&threads[r], NULL, broadcast_reader, &readers[r]);
+    }
+    pthread_create(&producer, NULL, broadcast_producer, &prod);
+
+    pthread_join(producer, NULL);
+    int error = 0;
+    for (size_t r = 0; r < BROADCAST_READERS; r++) {
+        pthread_join(threads[r], NULL);
+        if (readers[r].error) error = 1;
+        if (policy == RING_BROADCAST_BLOCKING &&
+            (readers[r].received != num_messages || readers[r].lost_bytes != 0)) {
+            error = 1;
+        }
+    }
+
+    ring_broadcast_destroy(&b);
+    return error;
+}
+
+TEST(broadcast_blocking_readers) {
+    return run_broadcast(RING_BROADCAST_BLOCKING, 50000);
+}
+
+TEST(broadcast_lossy_slow_reader) {
+    return run_broadcast(RING_BROADCAST_LOSSY, 200000);
+}
+
+/* ============ Wait Strategies ============ */
+
+typedef struct {
+    ring_buffer_t *rb;
+    ring_wait_t *w;
+    size_t num_messages;
+    int error;
+} wait_args_t;
+
+static void *wait_producer(void *arg) {
+    wait_args_t *a = (wait_args_t *)arg;
+    for (size_t i = 0; i < a->num_messages; i++) {
+        uint8_t msg[8];
+        memcpy(msg, &i, sizeof(i));
+        ring_push_wait(a->rb, a->w, msg, sizeof(msg));
+
+        /* Pause now and then so the consumer also has to wait for data */
+        if ((i % 1000) == 0) usleep(100);
+    }
+    return NULL;
+}
+
+static void *wait_consumer(void *arg) {
+    wait_args_t *a = (wait_args_t *)arg;
+    for (size_t i = 0; i < a->num_messages; i++) {
+        uint8_t msg[8];
+        size_t got;
+        ring_pop_wait(a->rb, a->w, msg, sizeof(msg));
+        memcpy(&got, msg, sizeof(got));
+        if (got != i) a->error = 1;
+
+        /* ... and the producer has to wait for space */
+        if ((i % 1500) == 0) usleep(100);
+    }
+    return NULL;
+}
+
+static int run_wait_strategy(ring_wait_strategy_t strategy, unsigned spins, size_t num_messages) {
+    ring_buffer_t rb;
+    ring_wait_t w;
+    if (!ring_init(&rb, 64, NULL)) return 1;
+    ring_wait_init(&w, strategy, spins);
+
+    wait_args_t args = { &rb, &w, num_messages, 0 };
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, wait_consumer, &args);
+    pthread_create(&producer, NULL, wait_producer, &args);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    ring_destroy(&rb);
+    return args.error;
+}
+
+TEST(wait_strategy_pause) {
+    /* Fewer messages: pure spinners only hand off on preemption on one core */
+    return run_wait_strategy(RING_WAIT_PAUSE, RING_WAIT_DEFAULT_SPINS, 2000);
+}
+
+TEST(wait_strategy_yield) {
+    return run_wait_strategy(RING_WAIT_YIELD, RING_WAIT_DEFAULT_SPINS, 20000);
+}
+
+TEST(wait_strategy_futex) {
+    return run_wait_strategy(RING_WAIT_FUTEX, RING_WAIT_DEFAULT_SPINS, 20000);
+}
+
+TEST(wait_strategy_futex_no_spin) {
+    /* Sleep on the first miss to stress the sleeper-flag handshake */
+    return run_wait_strategy(RING_WAIT_FUTEX, 0, 20000);
+}
+
+/* ============ Shared Memory (two processes) ============ */
+
+TEST(shm_cross_process) {
+    char name[64];
+    snprintf(name, sizeof(name), "/ring_test_integration_%d", (int)getpid());
+    ring_shm_unlink(name);
+
+    ring_shm_t s;
+    if (!ring_shm_create(&s, name, 4096)) return 1;
+
+    const size_t num_messages = 100000;
+    pid_t child = fork();
+    if (child == 0) {
+        /* Producer process */
+        ring_shm_t p;
+        if (!ring_shm_attach(&p, name) || !ring_shm_claim(&p, RING_SHM_PRODUCER)) _exit(1);
+        for (size_t i = 0; i < num_messages; i++) {
+            uint8_t msg[24];
+            for (size_t j = 0; j < sizeof(msg); j++) msg[j] = (uint8_t)(i + j);
+            while (!ring_shm_push(&p, msg, sizeof(msg))) {
+                sched_yield();
+            }
+        }
+        ring_shm_detach(&p);
+        _exit(0);
+    }
+
+    int error = !ring_shm_claim(&s, RING_SHM_CONSUMER);
+    for (size_t i = 0; i < num_messages && !error; i++) {
+        uint8_t msg[24];
+        while (!ring_shm_pop(&s, msg, sizeof(msg))) {
+            sched_yield();
+        }
+        for (size_t j = 0; j < sizeof(msg); j++) {
+            if (msg[j] != (uint8_t)(i + j)) error = 1;
+        }
+    }
+
+    int status;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) error = 1;
+
+    ring_shm_detach(&s);
+    ring_shm_unlink(name);
+    return error;
+}
+
+/* ============ Mirrored Ring ============ */
+
+TEST(spsc_mirrored_ring) {
+    ring_buffer_t rb;
+    if (!ring_init_mirrored(&rb, (size_t)sysconf(_SC_PAGESIZE))) return 1;
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    atomic_bool stop = false;
+
+    /* 37 does not divide the capacity, so messages regularly cross the seam */
+    thread_args_t args = {
+        .rb = &rb,
+        .num_messages = 100000,
+        .message_size = 37,
+        .stop = &stop,
+        .produced = &produced,
+        .consumed = &consumed
+    };
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, producer_fixed_size, &args);
+    pthread_create(&consumer, NULL, consumer_fixed_size, &args);
+
+    void *producer_result, *consumer_result;
+    pthread_join(producer, &producer_result);
+    pthread_join(consumer, &consumer_result);
+    ring_destroy(&rb);
+
+    if (consumer_result != NULL) return 1;
+    if (atomic_load(&produced) != args.num_messages) return 1;
+    if (atomic_load(&consumed) != args.num_messages) return 1;
+
+    return 0;
+}
+
+/* ============ Typed Ring ============ */
+
+#define TYPED_MESSAGES 200000
+
+typedef struct {
+    uint64_t seq;
+    uint64_t check;
+    uint8_t payload[48];
+} typed_msg_t;
+
+RING_DEFINE(typed_msg_ring, typed_msg_t, 64)
+
+static typed_msg_ring_t typed_ring;
+
+static void *typed_producer(void *arg) {
+    (void)arg;
+    typed_msg_t msg;
+    for (uint64_t i = 0; i < TYPED_MESSAGES; i++) {
+        msg.seq = i;
+        msg.check = i * 0x9E3779B97F4A7C15ULL;
+        memset(msg.payload, (int)(i & 0xFF), sizeof(msg.payload));
+        while (!typed_msg_ring_push(&typed_ring, &msg)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *typed_consumer(void *arg) {
+    (void)arg;
+    typed_msg_t msg;
+    for (uint64_t i = 0; i < TYPED_MESSAGES; i++) {
+        while (!typed_msg_ring_pop(&typed_ring, &msg)) {
+            sched_yield();
+        }
+        if (msg.seq != i || msg.check != i * 0x9E3779B97F4A7C15ULL) return (void *)1;
+        if (msg.payload[0] != (i & 0xFF) || msg.payload[47] != (i & 0xFF)) return (void *)1;
+    }
+    return NULL;
+}
+
+TEST(spsc_typed_ring) {
+    typed_msg_ring_init(&typed_ring);
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, typed_producer, NULL);
+    pthread_create(&consumer, NULL, typed_consumer, NULL);
+
+    void *consumer_result;
+    pthread_join(producer, NULL);
+    pthread_join(consumer, &consumer_result);
+
+    return consumer_result != NULL;
+}
+
+/* ============ Write Combining ============ */
+
+#define STAGED_FIELDS 500000
+
+/* Field i is (i % 8) + 1 bytes of (uint8_t)i, like a logger emitting small fields */
+static size_t staged_field_len(size_t i) {
+    return i % 8 + 1;
+}
+
+static void *staged_producer(void *arg) {
+    ring_buffer_t *rb = (ring_buffer_t *)arg;
+    uint8_t field[8];
+    for (size_t i = 0; i < STAGED_FIELDS; i++) {
+        memset(field, (int)(i & 0xFF), sizeof(field));
+        while (!ring_push_staged(rb, field, staged_field_len(i))) {
+            sched_yield();
+        }
+    }
+    ring_flush(rb);
+    return NULL;
+}
+
+static void *staged_consumer(void *arg) {
+    ring_buffer_t *rb = (ring_buffer_t *)arg;
+    uint8_t field[8];
+    for (size_t i = 0; i < STAGED_FIELDS; i++) {
+        size_t len = staged_field_len(i);
+        while (!ring_pop(rb, field, len)) {
+            sched_yield();
+        }
+        for (size_t k = 0; k < len; k++) {
+            if (field[k] != (uint8_t)i) return (void *)1;
+        }
+    }
+    return NULL;
+}
+
+TEST(spsc_staged_pushes) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    ring_set_coalesce(&rb, 256, 32);
+
+    pthread_t producer, consumer;
+    pthread_create(&producer, NULL, staged_producer, &rb);
+    pthread_create(&consumer, NULL, staged_consumer, &rb);
+
+    void *consumer_result;
+    pthread_join(producer, NULL);
+    pthread_join(consumer, &consumer_result);
+
+    return consumer_result != NULL || ring_used(&rb) != 0;
+}
+
+/* ============ Lossy (Overwrite-Oldest) ============ */
+
+#define LOSSY_RECORDS 200000
+
+/* Record `seq`: its sequence number, then (seq % 33) copies of its low byte */
+static size_t lossy_record_len(size_t seq) {
+    return sizeof(seq) + seq % 33;
+}
+
+typedef struct {
+    ring_lossy_t *l;
+    atomic_bool *done;
+    size_t received;
+    size_t received_bytes;
+    size_t lost_bytes;
+    int error;
+} lossy_args_t;
+
+static void *lossy_producer(void *arg) {
+    lossy_args_t *a = (lossy_args_t *)arg;
+    uint8_t rec[64];
+
+    for (size_t seq = 0; seq < LOSSY_RECORDS; seq++) {
+        size_t len = lossy_record_len(seq);
+        memcpy(rec, &seq, sizeof(seq));
+        memset(rec + sizeof(seq), (int)(seq & 0xFF), len - sizeof(seq));
+        if (!ring_lossy_push_msg(a->l, rec, len)) a->error = 1;    /* Never waits */
+        if ((seq % 16) == 0) sched_yield();     /* Pacing only, so the consumer gets to run */
+    }
+    atomic_store(a->done, true);
+    return NULL;
+}
+
+/*
+ * Slow consumer: records must arrive intact and in order, and received plus
+ * lost bytes must account for everything the producer wrote
+ */
+static void *lossy_consumer(void *arg) {
+    lossy_args_t *a = (lossy_args_t *)arg;
+    uint8_t rec[64];
+    size_t next = 0;
+
+    for (;;) {
+        bool finished = atomic_load(a->done);
+        size_t len, lost;
+        if (!ring_lossy_pop_msg(a->l, rec, sizeof(rec), &len, &lost)) {
+            a->lost_bytes += lost;
+            if (lost == 0 && finished) break;
+            sched_yield();
+            continue;
+        }
+
+        size_t seq;
+        memcpy(&seq, rec, sizeof(seq));
+        if (seq < next || len != lossy_record_len(seq)) {
+            a->error = 1;
+            break;
+        }
+        for (size_t j = sizeof(seq); j < len; j++) {
+            if (rec[j] != (uint8_t)(seq & 0xFF)) a->error = 1;
+        }
+        next = seq + 1;
+        a->received++;
+        a->received_bytes += RING_LOSSY_HEADER + len;
+
+        if ((seq % 256) == 0) usleep(20);
+    }
+    return NULL;
+}
+
+TEST(spsc_lossy_slow_consumer) {
+    ring_lossy_t l;
+    if (!ring_lossy_init(&l, BUFFER_SIZE, test_storage)) return 1;
+
+    atomic_bool done = false;
+    lossy_args_t args = { &l, &done, 0, 0, 0, 0 };
+
+    pthread_t producer, consumer;
+    pthread_create(&consumer, NULL, lossy_consumer, &args);
+    pthread_create(&producer, NULL, lossy_producer, &args);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    size_t total = 0;
+    for (size_t seq = 0; seq < LOSSY_RECORDS; seq++) total += RING_LOSSY_HEADER + lossy_record_len(seq);
+
+    int error = args.error;
+    if (args.received == 0) error = 1;
+    if (args.received_bytes + args.lost_bytes != total) error = 1;
+    if (args.lost_bytes != ring_lossy_lost(&l)) error = 1;
+
+    ring_lossy_destroy(&l);
+    return error;
+}
+
+/* ============ Async Logger ============ */
+
+#define LOG_THREADS 4
+#define LOG_RECORDS 20000
+
+static ring_log_t test_log;
+
+typedef struct {
+    int fmt;
+    unsigned thread;
+    size_t failures;
+} log_args_t;
+
+/* Small rings, so some calls find them full; retries keep every record */
+static void *log_thread(void *arg) {
+    log_args_t *a = (log_args_t *)arg;
+    ring_log_writer_t *w = ring_log_writer(&test_log);
+    if (w == NULL) return NULL;
+
+    for (unsigned seq = 0; seq < LOG_RECORDS; seq++) {
+        while (!ring_log(w, a->fmt, a->thread, seq, "payload")) {
+            a->failures++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Decoded per writer: every record in order from one thread, and the
+ * dropped markers add up to that thread's failed calls
+ */
+TEST(async_logger_threads) {
+    FILE *f = tmpfile();
+    if (f == NULL || !ring_log_open(&test_log, fileno(f), 4096)) return 1;
+
+    int fmt = ring_log_format(&test_log, "thread %u seq %u %s");
+    log_args_t args[LOG_THREADS];
+    pthread_t threads[LOG_THREADS];
+    for (unsigned t = 0; t < LOG_THREADS; t++) {
+        args[t] = (log_args_t){ fmt, t, 0 };
+        pthread_create(&threads[t], NULL, log_thread, &args[t]);
+    }
+    for (unsigned t = 0; t < LOG_THREADS; t++) pthread_join(threads[t], NULL);
+    uint64_t dropped = ring_log_dropped(&test_log);
+    if (!ring_log_close(&test_log)) return 1;
+
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+    rewind(f);
+    int error = !ring_log_decode(f, out);
+    fclose(out);
+    fclose(f);
+
+    int thread_of[LOG_THREADS];
+    unsigned next[LOG_THREADS] = {0};
+    size_t drops[LOG_THREADS] = {0};
+    for (unsigned t = 0; t < LOG_THREADS; t++) thread_of[t] = -1;
+
+    size_t total_failures = 0;
+    for (char *line = text; !error && *line != '\0'; line = strchr(line, '\n') + 1) {
+        unsigned w, thread, seq;
+        unsigned long long n;
+        if (sscanf(line, "[dropped] w%u %llu records", &w, &n) == 2 && w < LOG_THREADS) {
+            drops[w] += n;
+        } else if (sscanf(line, "[%*f] w%u thread %u seq %u payload", &w, &thread, &seq) == 3 &&
+                   w < LOG_THREADS && thread < LOG_THREADS) {
+            if (thread_of[w] == -1) thread_of[w] = (int)thread;
+            if (thread_of[w] != (int)thread || seq != next[w]) error = 1;
+            next[w] = seq + 1;
+        } else {
+            error = 1;
+        }
+    }
+    for (unsigned w = 0; w < LOG_THREADS && !error; w++) {
+        if (thread_of[w] < 0 || next[w] != LOG_RECORDS) error = 1;
+        else if (drops[w] != args[thread_of[w]].failures) error = 1;
+        total_failures += args[w].failures;
+    }
+    if (dropped != total_failures) error = 1;
+
+    free(text);
+    return error;
+}
+
+/* ============ File Descriptor Sink ============ */
+
+#define SINK_BYTES (8u << 20)
+
+typedef struct {
+    ring_buffer_t *rb;
+    ring_sink_t *sink;
+    int fd;
+    atomic_bool *done;
+    int error;
+} sink_args_t;
+
+/* Byte i of the stream is i % 251, so a gap or reordering shows up */
+static void *sink_producer(void *arg) {
+    sink_args_t *a = (sink_args_t *)arg;
+    uint8_t chunk[512];
+    size_t sent = 0;
+
+    while (sent < SINK_BYTES) {
+        size_t len = 1 + (sent * 7) % sizeof(chunk);
+        if (len > SINK_BYTES - sent) len = SINK_BYTES - sent;
+        for (size_t i = 0; i < len; i++) chunk[i] = (uint8_t)((sent + i) % 251);
+        while (!ring_push(a->rb, chunk, len)) sched_yield();
+        sent += len;
+    }
+    atomic_store(a->done, true);
+    return NULL;
+}
+
+static void *sink_consumer(void *arg) {
+    sink_args_t *a = (sink_args_t *)arg;
+
+    while (!atomic_load(a->done) && !a->error) {
+        if (!ring_sink_poll(a->sink) ||
+            (ring_sink_in_flight(a->sink) > 0 && !ring_sink_complete(a->sink, true))) {
+            a->error = 1;
+        } else if (ring_sink_in_flight(a->sink) == 0) {
+            sched_yield();
+        }
+    }
+    if (!a->error && !ring_sink_flush(a->sink)) a->error = 1;
+
+    /* After a failure keep the producer moving so the test can finish */
+    uint8_t scratch[256];
+    while (a->error && !atomic_load(a->done)) ring_pop_available(a->rb, scratch, sizeof(scratch));
+    return NULL;
+}
+
+static void *sink_reader(void *arg) {
+    sink_args_t *a = (sink_args_t *)arg;
+    uint8_t buf[4096];
+    size_t got = 0;
+
+    while (got < SINK_BYTES) {
+        ssize_t n = read(a->fd, buf, sizeof(buf));
+        if (n <= 0) {
+            a->error = 1;
+            return NULL;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (buf[i] != (uint8_t)((got + (size_t)i) % 251)) a->error = 1;
+        }
+        got += (size_t)n;
+    }
+    return NULL;
+}
+
+/* Producer -> ring -> sink -> pipe -> reader; passes if io_uring is unavailable */
+static int run_sink(ring_sink_mode_t mode) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    int fds[2];
+    if (pipe(fds) != 0) return 1;
+
+    ring_sink_t sink;
+    if (!ring_sink_init(&sink, &rb, fds[1], mode)) {
+        close(fds[0]);
+        close(fds[1]);
+        return mode == RING_SINK_IO_URING ? 0 : 1;
+    }
+
+    atomic_bool done = false;
+    sink_args_t args = { &rb, &sink, fds[0], &done, 0 };
+    sink_args_t reader_args = args;
+
+    pthread_t producer, consumer, reader;
+    pthread_create(&reader, NULL, sink_reader, &reader_args);
+    pthread_create(&consumer, NULL, sink_consumer, &args);
+    pthread_create(&producer, NULL, sink_producer, &args);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    if (args.error) close(fds[1]);      /* Let the reader see EOF */
+    pthread_join(reader, NULL);
+
+    ring_sink_destroy(&sink);
+    if (!args.error) close(fds[1]);
+    close(fds[0]);
+    return args.error || reader_args.error;
+}
+
+TEST(sink_writev_to_pipe) {
+    return run_sink(RING_SINK_WRITEV);
+}
+
+TEST(sink_io_uring_to_pipe) {
+    return run_sink(RING_SINK_IO_URING);
+}
+
+/* ============ Pipeline Stages ============ */
+
+#define PIPELINE_MESSAGES 100000
+#define PIPELINE_STAGES 3
+
+typedef struct {
+    uint64_t seq;
+    uint64_t value;
+} pipeline_msg_t;
+
+typedef struct {
+    ring_pipeline_t *p;
+    int error;
+} pipeline_args_t;
+
+/* Messages start as value == seq; each stage transforms them in place */
+static void *pipeline_producer(void *arg) {
+    pipeline_args_t *a = (pipeline_args_t *)arg;
+
+    for (uint64_t i = 0; i < PIPELINE_MESSAGES; i++) {
+        pipeline_msg_t msg = { i, i };
+        while (!ring_push(&a->p->ring, (uint8_t *)&msg, sizeof(msg))) sched_yield();
+    }
+    return NULL;
+}
+
+/* Stage 0, one message at a time: check the producer's value, then value = seq * 3 */
+static void *pipeline_triple(void *arg) {
+    pipeline_args_t *a = (pipeline_args_t *)arg;
+    ring_span_t span;
+
+    for (uint64_t i = 0; i < PIPELINE_MESSAGES; i++) {
+        while (!ring_stage_peek(a->p, 0, sizeof(pipeline_msg_t), &span)) sched_yield();
+        pipeline_msg_t *msg = (pipeline_msg_t *)(void *)span.first;
+        if (msg->seq != i || msg->value != i) a->error = 1;
+        msg->value = msg->seq * 3;
+        ring_stage_release(a->p, 0, sizeof(*msg));
+    }
+    return NULL;
+}
+
+/* Stage 1 callback: value += 1 for every whole message in the backlog */
+static size_t pipeline_add_one(const ring_span_t *span, void *ctx) {
+    uint64_t *seen = ctx;
+    size_t n = span->first_len / sizeof(pipeline_msg_t);
+    pipeline_msg_t *msg = (pipeline_msg_t *)(void *)span->first;
+
+    for (size_t i = 0; i < n; i++) msg[i].value++;
+    *seen += n;
+    return n * sizeof(pipeline_msg_t);
+}
+
+static void *pipeline_increment(void *arg) {
+    pipeline_args_t *a = (pipeline_args_t *)arg;
+    uint64_t seen = 0;
+
+    while (seen < PIPELINE_MESSAGES) {
+        if (ring_stage_drain(a->p, 1, SIZE_MAX, pipeline_add_one, &seen) == 0) sched_yield();
+    }
+    return NULL;
+}
+
+/* Last stage: every message must carry both upstream changes, in order */
+static void *pipeline_verify(void *arg) {
+    pipeline_args_t *a = (pipeline_args_t *)arg;
+    ring_span_t span;
+
+    for (uint64_t i = 0; i < PIPELINE_MESSAGES; i++) {
+        while (!ring_stage_peek(a->p, 2, sizeof(pipeline_msg_t), &span)) sched_yield();
+        pipeline_msg_t *msg = (pipeline_msg_t *)(void *)span.first;
+        if (msg->seq != i || msg->value != i * 3 + 1) a->error = 1;
+        ring_stage_release(a->p, 2, sizeof(*msg));
+    }
+    return NULL;
+}
+
+TEST(pipeline_stages_transform_in_place) {
+    ring_pipeline_t p;
+    if (!ring_pipeline_init(&p, BUFFER_SIZE, test_storage, PIPELINE_STAGES)) return 1;
+
+    /* The producer, then one thread per stage */
+    void *(*fns[PIPELINE_STAGES + 1])(void *) = {
+        pipeline_producer, pipeline_triple, pipeline_increment, pipeline_verify
+    };
+    pipeline_args_t args[PIPELINE_STAGES + 1];
+    pthread_t threads[PIPELINE_STAGES + 1];
+
+    for (size_t i = 0; i <= PIPELINE_STAGES; i++) {
+        args[i] = (pipeline_args_t){ &p, 0 };
+        pthread_create(&threads[i], NULL, fns[i], &args[i]);
+    }
+
+    int result = 0;
+    for (size_t i = 0; i <= PIPELINE_STAGES; i++) {
+        pthread_join(threads[i], NULL);
+        result |= args[i].error;
+    }
+    if (ring_used(&p.ring) != 0) result = 1;
+
+    ring_pipeline_destroy(&p);
+    return result;
+}
+
+/* ============ Instrumentation (make STATS=1) ============ */
+
+#ifdef RING_STATS
+typedef struct {
+    ring_buffer_t *rb;
+    atomic_bool *stop;
+    int result;
+} monitor_args_t;
+
+/* Snapshots must see every counter move forward, never backward */
+static void *stats_monitor(void *arg) {
+    monitor_args_t *m = (monitor_args_t *)arg;
+    ring_stats_t prev = {0}, cur;
+
+    while (!atomic_load(m->stop)) {
+        ring_stats_snapshot(m->rb, &cur);
+        if (cur.producer.ops < prev.producer.ops || cur.consumer.ops < prev.consumer.ops ||
+            cur.producer.bytes < prev.producer.bytes || cur.consumer.bytes < prev.consumer.bytes ||
+            cur.producer.high_water > m->rb->capacity) {
+            m->result = 1;
+            break;
+        }
+        prev = cur;
+        sched_yield();
+    }
+    return NULL;
+}
+
+TEST(stats_snapshot_while_running) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    atomic_size_t produced = 0;
+    atomic_size_t consumed = 0;
+    atomic_bool stop = false;
+    atomic_bool monitor_stop = false;
+
+    thread_args_t args = {
+        .rb = &rb,
+        .num_messages = 50000,
+        .message_size = 24,
+        .stop = &stop,
+        .produced = &produced,
+        .consumed = &consumed
+    };
+    monitor_args_t monitor = { &rb, &monitor_stop, 0 };
+
+    pthread_t producer, consumer, watcher;
+    pthread_create(&watcher, NULL, stats_monitor, &monitor);
+    pthread_create(&producer, NULL, producer_fixed_size, &args);
+    pthread_create(&consumer, NULL, consumer_fixed_size, &args);
+
+    void *consumer_result;
+    pthread_join(producer, NULL);
+    pthread_join(consumer, &consumer_result);
+    atomic_store(&monitor_stop, true);
+    pthread_join(watcher, NULL);
+
+    if (consumer_result != NULL || monitor.result != 0) return 1;
+
+    ring_stats_t st;
+    if (!ring_stats_snapshot(&rb, &st)) return 1;
+    if (st.producer.ops != args.num_messages || st.consumer.ops != args.num_messages) return 1;
+    if (st.producer.bytes != args.num_messages * args.message_size) return 1;
+    if (st.consumer.bytes != st.producer.bytes) return 1;
+
+    return 0;
+}
+#endif
+
+int main(void) {
+    printf("Running integration tests...\n\n");
+
+    printf("SPSC Correctness:\n");
+    RUN_TEST(spsc_small_messages);
+    RUN_TEST(spsc_large_messages);
+    RUN_TEST(spsc_single_byte_messages);
+
+    printf("\nStress Tests:\n");
+    RUN_TEST(spsc_variable_size_messages);
+    RUN_TEST(spsc_framed_variable_size_messages);
+    RUN_TEST(spsc_burst_pattern);
+    RUN_TEST(spsc_burst_pattern_drained);
+
+    printf("\nZero-Copy API:\n");
+    RUN_TEST(spsc_reserve_commit_peek_release);
+
+    printf("\nBatched API:\n");
+    RUN_TEST(spsc_batch_push_pop);
+
+    printf("\nMPSC:\n");
+    RUN_TEST(mpsc_multiple_producers);
+
+    printf("\nMPMC:\n");
+    RUN_TEST(mpmc_multiple_producers_consumers);
+
+    printf("\nBroadcast:\n");
+    RUN_TEST(broadcast_blocking_readers);
+    RUN_TEST(broadcast_lossy_slow_reader);
+
+    printf("\nWait Strategies:\n");
+    RUN_TEST(wait_strategy_pause);
+    RUN_TEST(wait_strategy_yield);
+    RUN_TEST(wait_strategy_futex);
+    RUN_TEST(wait_strategy_futex_no_spin);
+
+    printf("\nShared Memory:\n");
+    RUN_TEST(shm_cross_process);
+
+    printf("\nMirrored Ring:\n");
+    RUN_TEST(spsc_mirrored_ring);
+
+    printf("\nTyped Ring:\n");
+    RUN_TEST(spsc_typed_ring);
+
+    printf("\nWrite Combining:\n");
+    RUN_TEST(spsc_staged_pushes);
+
+    printf("\nLossy (Overwrite-Oldest):\n");
+    RUN_TEST(spsc_lossy_slow_consumer);
+
+    printf("\nAsync Logger:\n");
+    RUN_TEST(async_logger_threads);
+
+    printf("\nFile Descriptor Sink:\n");
+    RUN_TEST(sink_writev_to_pipe);
+    RUN_TEST(sink_io_uring_to_pipe);
+
+    printf("\nPipeline Stages:\n");
+    RUN_TEST(pipeline_stages_transform_in_place);
+
+#ifdef RING_STATS
+    printf("\nInstrumentation:\n");
+    RUN_TEST(stats_snapshot_while_running);
+#endif
 
     printf("\n========================================\n");
     printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
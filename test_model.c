@@ -0,0 +1,1071 @@
+/*
+ * Model-checked tests for the lock-free variants
+ *
+ * test_integration.c runs real threads and sees whatever interleavings the
+ * hardware happens to produce; on x86 that is close to sequential
+ * consistency, so a missing acquire or release rarely shows up. Here every
+ * atomic operation and every copy into or out of the data region is a
+ * scheduling point, and a depth-first search runs the threads (cooperative
+ * ucontext coroutines) through every interleaving with up to
+ * `preemptions` involuntary context switches.
+ *
+ * Atomics are replaced (by macro, before the ring sources are included) with
+ * an operational C11 model: each location keeps its full modification
+ * history, and a relaxed or acquire load may return any value its thread's
+ * view still allows, not just the latest, which is also a choice the search
+ * branches on. Release/acquire pairs and fences carry vector clocks, and
+ * every data byte records which thread last wrote it at which clock, so a
+ * copy that isn't ordered after the write it depends on (or an overwrite
+ * that isn't ordered after the read) fails the test as a data race, exactly
+ * where weaker hardware could return stale bytes. Plain correctness (order,
+ * no loss, no tearing) is then checked on top by each test.
+ *
+ * Seqlock-validated readers (the lossy broadcast and overwrite-oldest
+ * rings) race by design. Their tests run in speculative mode: a racy copy
+ * behaves like a relaxed atomic read instead of an error, and the test
+ * fails only if a copy that raced is returned as valid.
+ *
+ * Not modelled: load buffering (a load never sees a store that comes later
+ * in the schedule), inserting a store anywhere but at the end of its
+ * location's history, and spurious compare-exchange failure. seq_cst
+ * accesses read the latest value. A spinning thread is parked until another
+ * thread writes, and then reads the latest value - the "eventually visible"
+ * guarantee a spin loop relies on. The mutation checks at the end make sure
+ * the search catches a missing release and a missing acquire fence.
+ */
+
+#include <stdalign.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <string.h>
+#include <ucontext.h>
+
+/* ============ Model: State ============ */
+
+#define MODEL_MAX_THREADS 4
+#define MODEL_MAX_LOCS 24
+#define MODEL_MAX_MSGS 64
+#define MODEL_MAX_CHOICES 1024
+#define MODEL_MAX_STEPS 1000
+#define MODEL_MAX_REGION 64
+#define MODEL_STACK (64 * 1024)
+
+/* Happens-before (per-thread clocks) plus the newest store visible per location */
+typedef struct {
+    uint32_t vc[MODEL_MAX_THREADS];
+    uint32_t view[MODEL_MAX_LOCS];
+} model_clock_t;
+
+/* One store to a location; its timestamp is its index in the history */
+typedef struct {
+    size_t value;
+    model_clock_t clock;
+} model_msg_t;
+
+typedef struct {
+    const void *addr;
+    size_t count;
+    model_msg_t msgs[MODEL_MAX_MSGS];
+} model_loc_t;
+
+/* Last write and reads of one byte of the tracked data region */
+typedef struct {
+    int writer;                         /* -1: written during setup */
+    uint32_t epoch;
+    model_clock_t rel;                  /* Writer's release clock, for speculative reads */
+    uint32_t reads[MODEL_MAX_THREADS];
+} model_byte_t;
+
+typedef struct {
+    ucontext_t ctx;                     /* Only to start the coroutine on its stack */
+    jmp_buf jb;                         /* Switches: no signal-mask syscalls */
+    bool started;
+    void (*fn)(void);
+    bool done;
+    bool spinning;
+    size_t own_writes;
+    size_t since;                       /* Others' writes when this spin iteration began */
+    bool stale;                         /* A load this spin iteration skipped newer stores */
+    bool stale_at_spin;
+    bool fresh;                         /* Woken from a spin: loads read the latest */
+    bool tainted;                       /* Speculative mode: copied racing bytes */
+    model_clock_t cur;
+    model_clock_t acq;                  /* Joined by relaxed loads, applied by acquire fences */
+    model_clock_t rel;                  /* Snapshot at the last release fence */
+} model_thread_t;
+
+typedef struct {
+    uint16_t n;
+    uint16_t chosen;
+} model_choice_t;
+
+static struct {
+    /* Search: the choices of the current execution, replayed then extended */
+    model_choice_t trail[MODEL_MAX_CHOICES];
+    size_t trail_len;
+    size_t trail_pos;
+
+    /* Current execution */
+    model_thread_t threads[MODEL_MAX_THREADS];
+    size_t num_threads;
+    int cur;                            /* Running thread; -1 during setup and checks */
+    size_t preemptions;
+    size_t max_preemptions;
+    size_t steps;
+    size_t writes;
+    bool speculative;
+    bool trace;                         /* Replaying a failure: print every operation */
+    bool failed;
+    bool pruned;
+    char failure[256];
+    model_clock_t sc;
+
+    model_loc_t locs[MODEL_MAX_LOCS];
+    size_t num_locs;
+    uint8_t *region;
+    size_t region_len;
+    model_byte_t shadow[MODEL_MAX_REGION];
+
+    ucontext_t sched_ctx;
+    jmp_buf sched_jb;
+} model;
+
+static alignas(16) uint8_t model_stacks[MODEL_MAX_THREADS][MODEL_STACK];
+
+static void clock_join(model_clock_t *a, const model_clock_t *b) {
+    for (size_t i = 0; i < MODEL_MAX_THREADS; i++) {
+        if (b->vc[i] > a->vc[i]) a->vc[i] = b->vc[i];
+    }
+    for (size_t i = 0; i < MODEL_MAX_LOCS; i++) {
+        if (b->view[i] > a->view[i]) a->view[i] = b->view[i];
+    }
+}
+
+/* ============ Model: Search and Scheduling ============ */
+
+/* Pick one of `n` alternatives: replayed from the trail, else the first */
+static size_t model_choose(size_t n) {
+    if (n <= 1) return 0;
+    if (model.trail_pos == model.trail_len) {
+        if (model.trail_len == MODEL_MAX_CHOICES) {
+            model.pruned = true;
+            return 0;
+        }
+        model.trail[model.trail_len++] = (model_choice_t){ (uint16_t)n, 0 };
+    }
+    return model.trail[model.trail_pos++].chosen;
+}
+
+/* Advance the trail to the next unexplored execution; false when done */
+static bool model_backtrack(void) {
+    while (model.trail_len > 0) {
+        model_choice_t *c = &model.trail[model.trail_len - 1];
+        if (c->chosen + 1 < c->n) {
+            c->chosen++;
+            return true;
+        }
+        model.trail_len--;
+    }
+    return false;
+}
+
+static model_thread_t *model_self(void) {
+    return &model.threads[model.cur];
+}
+
+static void model_trace(const char *fmt, ...) {
+    if (!model.trace) return;
+    va_list ap;
+    va_start(ap, fmt);
+    printf("      t%d: ", model.cur);
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+}
+
+/* Hand control back to the scheduler, which may run another thread first */
+static void model_yield(void) {
+    if (_setjmp(model_self()->jb) == 0) _longjmp(model.sched_jb, 1);
+}
+
+/* End the execution as failed; never returns when called from a thread */
+static void model_fail(const char *fmt, ...) {
+    if (!model.failed) {
+        va_list ap;
+        va_start(ap, fmt);
+        vsnprintf(model.failure, sizeof(model.failure), fmt, ap);
+        va_end(ap);
+        model.failed = true;
+    }
+    if (model.cur >= 0) {
+        model_self()->done = true;
+        _longjmp(model.sched_jb, 1);
+    }
+}
+
+#define MODEL_ASSERT(cond) do { \
+    if (!(cond)) model_fail("assertion failed: %s (line %d)", #cond, __LINE__); \
+} while (0)
+
+/* Stores by threads other than `t` so far */
+static size_t model_others_writes(const model_thread_t *t) {
+    return model.writes - t->own_writes;
+}
+
+/*
+ * Spin-wait: park until another thread stores something it may not have
+ * seen (since this iteration began), or retry at once if this iteration
+ * read a stale value; the retry reads the latest
+ */
+static void model_spin(void) {
+    model_thread_t *t = model_self();
+    t->spinning = true;
+    t->stale_at_spin = t->stale;
+    t->stale = false;
+    t->fresh = false;
+    model_trace("spin");
+    model_yield();
+}
+
+static void model_thread_main(void) {
+    model_self()->fn();
+    model_self()->done = true;
+    _longjmp(model.sched_jb, 1);
+}
+
+static void model_schedule(void) {
+    int prev = -1;
+
+    for (;;) {
+        int runnable[MODEL_MAX_THREADS];
+        size_t n = 0;
+        bool prev_runnable = false;
+        bool all_done = true;
+
+        for (size_t i = 0; i < model.num_threads; i++) {
+            model_thread_t *t = &model.threads[i];
+            if (t->done) continue;
+            all_done = false;
+            if (t->spinning && t->since == model_others_writes(t) && !t->stale_at_spin) continue;
+            if ((int)i == prev) prev_runnable = true;
+            runnable[n++] = (int)i;
+        }
+        if (all_done) return;
+        if (n == 0) {
+            model_fail("deadlock: every live thread is spinning and nothing can change");
+            return;
+        }
+        if (++model.steps > MODEL_MAX_STEPS) {
+            model.pruned = true;
+            return;
+        }
+
+        /* Staying on the current thread is free; switching away costs a preemption */
+        int options[MODEL_MAX_THREADS];
+        size_t k = 0;
+        if (prev_runnable) options[k++] = prev;
+        if (!prev_runnable || model.preemptions < model.max_preemptions) {
+            for (size_t i = 0; i < n; i++) {
+                if (runnable[i] != prev || !prev_runnable) options[k++] = runnable[i];
+            }
+        }
+        int next = options[model_choose(k)];
+        if (prev_runnable && next != prev) model.preemptions++;
+
+        model_thread_t *t = &model.threads[next];
+        if (t->spinning) {
+            t->spinning = false;
+            t->fresh = true;
+            t->since = model_others_writes(t);
+        }
+        model.cur = next;
+        if (_setjmp(model.sched_jb) == 0) {
+            if (t->started) _longjmp(t->jb, 1);
+            t->started = true;
+            swapcontext(&model.sched_ctx, &t->ctx);
+        }
+        model.cur = -1;
+        if (model.failed || model.pruned) return;
+        prev = next;
+    }
+}
+
+/* ============ Model: Atomics ============ */
+
+static size_t model_loc_index(const void *addr) {
+    for (size_t i = 0; i < model.num_locs; i++) {
+        if (model.locs[i].addr == addr) return i;
+    }
+    if (model.cur >= 0) model_fail("atomic at %p used before atomic_init", addr);
+    fprintf(stderr, "model: atomic at %p used before atomic_init\n", addr);
+    abort();
+}
+
+static void model_init(const void *addr, size_t value) {
+    size_t i = 0;
+    while (i < model.num_locs && model.locs[i].addr != addr) i++;
+    if (i == model.num_locs) {
+        if (model.num_locs == MODEL_MAX_LOCS) {
+            fprintf(stderr, "model: raise MODEL_MAX_LOCS\n");
+            abort();
+        }
+        model.num_locs++;
+    }
+    model_loc_t *l = &model.locs[i];
+    l->addr = addr;
+    l->count = 1;
+    memset(&l->msgs[0], 0, sizeof(l->msgs[0]));
+    l->msgs[0].value = value;
+    __atomic_store_n((size_t *)addr, value, __ATOMIC_RELAXED);
+}
+
+static bool model_is_acquire(memory_order mo) {
+    return mo == memory_order_acquire || mo == memory_order_consume ||
+           mo == memory_order_acq_rel || mo == memory_order_seq_cst;
+}
+
+static bool model_is_release(memory_order mo) {
+    return mo == memory_order_release || mo == memory_order_acq_rel ||
+           mo == memory_order_seq_cst;
+}
+
+/* Append a store to the history of location `li` by the running thread */
+static void model_append(size_t li, size_t value, memory_order mo, const model_clock_t *rmw) {
+    model_thread_t *t = model_self();
+    model_loc_t *l = &model.locs[li];
+    if (l->count == MODEL_MAX_MSGS) model_fail("raise MODEL_MAX_MSGS");
+
+    uint32_t ts = (uint32_t)l->count;
+    model_msg_t *m = &l->msgs[l->count++];
+    t->cur.view[li] = ts;
+    m->value = value;
+    m->clock = model_is_release(mo) ? t->cur : t->rel;
+    m->clock.view[li] = ts;
+    if (rmw != NULL) clock_join(&m->clock, rmw);     /* Continues a release sequence */
+    if (model_is_release(mo)) t->cur.vc[model.cur]++;
+
+    model.writes++;
+    t->own_writes++;
+    __atomic_store_n((size_t *)l->addr, value, __ATOMIC_RELAXED);
+}
+
+static size_t model_load(const void *addr, memory_order mo) {
+    if (model.cur < 0) return __atomic_load_n((const size_t *)addr, __ATOMIC_RELAXED);
+    model_yield();
+
+    model_thread_t *t = model_self();
+    size_t li = model_loc_index(addr);
+    model_loc_t *l = &model.locs[li];
+
+    /* Anything from the newest store this thread must see onwards */
+    size_t idx = l->count - 1;
+    if (!t->fresh && mo != memory_order_seq_cst) idx -= model_choose(l->count - t->cur.view[li]);
+    if (idx + 1 < l->count) t->stale = true;
+
+    model_msg_t *m = &l->msgs[idx];
+    if (idx > t->cur.view[li]) t->cur.view[li] = (uint32_t)idx;
+    clock_join(model_is_acquire(mo) ? &t->cur : &t->acq, &m->clock);
+    model_trace("load  loc%zu -> %zu%s", li, m->value, idx + 1 < l->count ? " (stale)" : "");
+    return m->value;
+}
+
+static void model_store(const void *addr, size_t value, memory_order mo) {
+    if (model.cur < 0) {
+        model_init(addr, value);
+        return;
+    }
+    model_yield();
+    size_t li = model_loc_index(addr);
+    model_trace("store loc%zu <- %zu%s", li, value, model_is_release(mo) ? " (release)" : "");
+    model_append(li, value, mo, NULL);
+}
+
+/* Read-modify-writes always read the newest store */
+static bool model_cas(const void *addr, size_t *expected, size_t desired,
+                      memory_order success, memory_order failure) {
+    model_yield();
+
+    model_thread_t *t = model_self();
+    size_t li = model_loc_index(addr);
+    model_loc_t *l = &model.locs[li];
+    model_msg_t m = l->msgs[l->count - 1];
+    t->cur.view[li] = (uint32_t)(l->count - 1);
+
+    model_trace("cas   loc%zu %zu -> %zu: %s", li, *expected, desired,
+                m.value == *expected ? "ok" : "failed");
+    if (m.value != *expected) {
+        clock_join(model_is_acquire(failure) ? &t->cur : &t->acq, &m.clock);
+        *expected = m.value;
+        return false;
+    }
+    clock_join(model_is_acquire(success) ? &t->cur : &t->acq, &m.clock);
+    model_append(li, desired, success, &m.clock);
+    return true;
+}
+
+static void model_fence(memory_order mo) {
+    if (model.cur < 0 || mo == memory_order_relaxed) return;
+    model_yield();
+
+    model_thread_t *t = model_self();
+    model_trace("fence %s", mo == memory_order_acquire ? "acquire" :
+                            mo == memory_order_release ? "release" : "acq_rel/seq_cst");
+    if (model_is_acquire(mo)) clock_join(&t->cur, &t->acq);
+    if (mo == memory_order_seq_cst) {
+        clock_join(&t->cur, &model.sc);
+        model.sc = t->cur;
+    }
+    if (model_is_release(mo)) {
+        t->rel = t->cur;
+        t->cur.vc[model.cur]++;
+    }
+}
+
+/* ============ Model: Data Region ============ */
+
+static void model_read_byte(model_thread_t *t, size_t off) {
+    model_byte_t *b = &model.shadow[off];
+    int self = model.cur;
+
+    if (b->writer >= 0 && b->writer != self && b->epoch > t->cur.vc[b->writer]) {
+        if (!model.speculative) {
+            model_fail("data race: thread %d reads byte %zu before thread %d's write to it "
+                       "happens-before", self, off, b->writer);
+        }
+        /* A seqlock copy: acts as a relaxed read, validated later by a fence */
+        t->tainted = true;
+        clock_join(&t->acq, &b->rel);
+    }
+    b->reads[self] = t->cur.vc[self];
+}
+
+static void model_write_byte(model_thread_t *t, size_t off) {
+    model_byte_t *b = &model.shadow[off];
+    int self = model.cur;
+
+    if (b->writer >= 0 && b->writer != self && b->epoch > t->cur.vc[b->writer]) {
+        model_fail("data race: threads %d and %d both write byte %zu", b->writer, self, off);
+    }
+    for (size_t r = 0; r < model.num_threads && !model.speculative; r++) {
+        if ((int)r != self && b->reads[r] > t->cur.vc[r]) {
+            model_fail("data race: thread %d overwrites byte %zu before thread %zu's read of it "
+                       "happens-before", self, off, r);
+        }
+    }
+    b->writer = self;
+    b->epoch = t->cur.vc[self];
+    b->rel = t->rel;
+    memset(b->reads, 0, sizeof(b->reads));
+}
+
+/* Bytes of [p, p + n) inside the tracked region: first offset and count */
+static size_t model_overlap(const void *p, size_t n, size_t *off) {
+    uintptr_t lo = (uintptr_t)p, hi = lo + n;
+    uintptr_t rlo = (uintptr_t)model.region, rhi = rlo + model.region_len;
+    if (model.region == NULL || hi <= rlo || lo >= rhi) return 0;
+    if (lo < rlo) lo = rlo;
+    if (hi > rhi) hi = rhi;
+    *off = lo - rlo;
+    return hi - lo;
+}
+
+static void *model_memcpy(void *dst, const void *src, size_t n) {
+    size_t roff = 0, woff = 0;
+    size_t rn = model_overlap(src, n, &roff);
+    size_t wn = model_overlap(dst, n, &woff);
+
+    if (model.cur >= 0 && (rn > 0 || wn > 0)) {
+        model_yield();
+        model_thread_t *t = model_self();
+        if (rn > 0) model_trace("read  data[%zu..%zu)", roff, roff + rn);
+        if (wn > 0) model_trace("write data[%zu..%zu)", woff, woff + wn);
+        for (size_t i = 0; i < rn; i++) model_read_byte(t, roff + i);
+        for (size_t i = 0; i < wn; i++) model_write_byte(t, woff + i);
+    } else {
+        for (size_t i = 0; i < wn; i++) model.shadow[woff + i].writer = -1;
+    }
+    return (memcpy)(dst, src, n);
+}
+
+/* ============ Ring Sources Under the Model ============ */
+
+#undef atomic_init
+#undef atomic_load_explicit
+#undef atomic_store_explicit
+#undef atomic_compare_exchange_weak_explicit
+#undef atomic_thread_fence
+/* Ring cursors are all atomic_size_t; anything else (the copy kernel cache) stays real */
+#define atomic_init(obj, value) model_init((const void *)(obj), (value))
+#define atomic_load_explicit(obj, mo) _Generic((obj), \
+    atomic_size_t *: model_load((const void *)(obj), (mo)), \
+    const atomic_size_t *: model_load((const void *)(obj), (mo)), \
+    default: __atomic_load_n((obj), (mo)))
+#define atomic_store_explicit(obj, value, mo) _Generic((obj), \
+    atomic_size_t *: model_store((const void *)(obj), (size_t)(value), (mo)), \
+    default: __atomic_store_n((obj), (value), (mo)))
+#define atomic_compare_exchange_weak_explicit(obj, expected, desired, succ, fail) \
+    model_cas((const void *)(obj), (expected), (desired), (succ), (fail))
+#define atomic_thread_fence(mo) model_fence(mo)
+#define memcpy(dst, src, n) model_memcpy((dst), (src), (n))
+
+#include "ring_buffer.c"
+
+#undef ring_cpu_relax
+#define ring_cpu_relax() model_spin()
+
+#include "ring_mpsc.c"
+#include "ring_broadcast.c"
+#include "ring_lossy.c"
+#include "ring_pipeline.c"
+
+/* ============ Harness ============ */
+
+typedef struct {
+    void (*setup)(void);
+    void (*threads[MODEL_MAX_THREADS])(void);
+    size_t num_threads;
+    size_t preemptions;
+    bool speculative;
+} model_test_t;
+
+static size_t model_executions;
+static size_t model_pruned;
+static size_t model_min_preemptions;    /* Command line: deepen every search */
+
+static alignas(CACHE_LINE) uint8_t model_storage[MODEL_MAX_REGION];
+
+/* Only the data region is tracked; the model copies run through memcpy */
+static void model_track(ring_buffer_t *rb) {
+    ring_set_copy_kernel(rb, "memcpy");
+    model.region = rb->data;
+    model.region_len = rb->capacity;
+}
+
+static void model_start(const model_test_t *test) {
+    memset(&model.threads, 0, sizeof(model.threads));
+    model.num_threads = test->num_threads;
+    model.cur = -1;
+    model.trail_pos = 0;
+    model.preemptions = 0;
+    model.max_preemptions = test->preemptions > model_min_preemptions ?
+                            test->preemptions : model_min_preemptions;
+    model.steps = 0;
+    model.writes = 0;
+    model.speculative = test->speculative;
+    model.trace = false;
+    model.failed = false;
+    model.pruned = false;
+    memset(&model.sc, 0, sizeof(model.sc));
+    model.num_locs = 0;
+    model.region = NULL;
+    model.region_len = 0;
+    for (size_t i = 0; i < MODEL_MAX_REGION; i++) {
+        memset(&model.shadow[i], 0, sizeof(model.shadow[i]));
+        model.shadow[i].writer = -1;
+    }
+
+    test->setup();
+
+    for (size_t i = 0; i < test->num_threads; i++) {
+        model_thread_t *t = &model.threads[i];
+        t->fn = test->threads[i];
+        t->cur.vc[i] = 1;
+        getcontext(&t->ctx);
+        t->ctx.uc_stack.ss_sp = model_stacks[i];
+        t->ctx.uc_stack.ss_size = MODEL_STACK;
+        t->ctx.uc_link = NULL;              /* model_thread_main() never returns */
+        makecontext(&t->ctx, model_thread_main, 0);
+    }
+}
+
+/* Re-run the execution the trail describes, printing each operation */
+static void model_replay(const model_test_t *test) {
+    model_start(test);
+    model.trace = true;
+    model_schedule();
+    model.trace = false;
+}
+
+/*
+ * Explore every execution of `test`. Returns false at the first failing
+ * one, with the reason in model.failure.
+ */
+static bool model_check(const model_test_t *test) {
+    model.trail_len = 0;
+    model_executions = 0;
+    model_pruned = 0;
+
+    do {
+        model_start(test);
+        model_schedule();
+        model_executions++;
+        if (model.pruned) model_pruned++;
+        if (model.failed) return false;
+    } while (model_backtrack());
+    return true;
+}
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define RUN_MODEL(name, expect) do { \
+    printf("  %-50s", #name); \
+    fflush(stdout); \
+    bool ok_ = model_check(&model_##name); \
+    if (ok_ == (expect)) { \
+        printf(" PASS (%zu executions", model_executions); \
+        if (model_pruned > 0) printf(", %zu cut at the step limit", model_pruned); \
+        printf(")\n"); \
+        if (!ok_) printf("    found: %s\n", model.failure); \
+        tests_passed++; \
+    } else if (ok_) { \
+        printf(" FAIL\n    expected the search to find a bug\n"); \
+        tests_failed++; \
+    } else { \
+        printf(" FAIL\n    execution %zu: %s\n", model_executions, model.failure); \
+        model_replay(&model_##name); \
+        tests_failed++; \
+    } \
+} while (0)
+
+/* Message `i` of a test stream: every byte tags its message */
+static void fill_msg(uint8_t *msg, size_t len, size_t i) {
+    for (size_t j = 0; j < len; j++) msg[j] = (uint8_t)(i * 16 + j + 1);
+}
+
+static bool msg_matches(const uint8_t *msg, size_t len, size_t i) {
+    for (size_t j = 0; j < len; j++) {
+        if (msg[j] != (uint8_t)(i * 16 + j + 1)) return false;
+    }
+    return true;
+}
+
+/* ============ SPSC ============ */
+
+#define SPSC_MSGS 3
+#define SPSC_LEN 3
+
+static ring_buffer_t spsc_rb;
+
+static void spsc_setup(void) {
+    ring_init(&spsc_rb, 8, model_storage);
+    model_track(&spsc_rb);
+}
+
+static void spsc_producer(void) {
+    uint8_t msg[SPSC_LEN];
+    for (size_t i = 0; i < SPSC_MSGS; i++) {
+        fill_msg(msg, SPSC_LEN, i);
+        while (!ring_push(&spsc_rb, msg, SPSC_LEN)) model_spin();
+    }
+}
+
+static void spsc_consumer(void) {
+    uint8_t msg[SPSC_LEN];
+    for (size_t i = 0; i < SPSC_MSGS; i++) {
+        while (!ring_pop(&spsc_rb, msg, SPSC_LEN)) model_spin();
+        MODEL_ASSERT(msg_matches(msg, SPSC_LEN, i));
+    }
+}
+
+static const model_test_t model_spsc_push_pop = {
+    spsc_setup, { spsc_producer, spsc_consumer }, 2, 3, false
+};
+
+/* Zero-copy both ways, every message split by the wrap of a 4-byte ring */
+static void spsc_zero_copy_setup(void) {
+    ring_init(&spsc_rb, 4, model_storage);
+    model_track(&spsc_rb);
+}
+
+static void spsc_reserve_producer(void) {
+    uint8_t msg[SPSC_LEN];
+    ring_span_t span;
+    for (size_t i = 0; i < SPSC_MSGS; i++) {
+        fill_msg(msg, SPSC_LEN, i);
+        while (!ring_reserve(&spsc_rb, SPSC_LEN, &span)) model_spin();
+        memcpy(span.first, msg, span.first_len);
+        if (span.second_len > 0) memcpy(span.second, msg + span.first_len, span.second_len);
+        ring_commit(&spsc_rb, SPSC_LEN);
+    }
+}
+
+typedef struct {
+    uint8_t bytes[SPSC_MSGS * SPSC_LEN];
+    size_t len;
+} spsc_drained_t;
+
+static spsc_drained_t spsc_drained;
+
+static size_t spsc_drain_fn(const ring_span_t *span, void *ctx) {
+    spsc_drained_t *d = ctx;
+    memcpy(d->bytes + d->len, span->first, span->first_len);
+    if (span->second_len > 0) memcpy(d->bytes + d->len + span->first_len, span->second, span->second_len);
+    d->len += span->first_len + span->second_len;
+    return span->first_len + span->second_len;
+}
+
+static void spsc_drain_consumer(void) {
+    spsc_drained.len = 0;
+    while (spsc_drained.len < sizeof(spsc_drained.bytes)) {
+        if (ring_drain(&spsc_rb, SIZE_MAX, spsc_drain_fn, &spsc_drained) == 0) model_spin();
+    }
+    for (size_t i = 0; i < SPSC_MSGS; i++) {
+        MODEL_ASSERT(msg_matches(spsc_drained.bytes + i * SPSC_LEN, SPSC_LEN, i));
+    }
+}
+
+static const model_test_t model_spsc_reserve_drain = {
+    spsc_zero_copy_setup, { spsc_reserve_producer, spsc_drain_consumer }, 2, 3, false
+};
+
+/* ============ MPSC ============ */
+
+#define MPSC_MSGS 2
+#define MPSC_LEN 2
+
+static ring_mpsc_t mpsc_q;
+
+static void mpsc_setup(void) {
+    ring_mpsc_init(&mpsc_q, 4, model_storage);
+    model_track(&mpsc_q.ring);
+}
+
+/* Producer p's message i is tagged p * MPSC_MSGS + i */
+static void mpsc_produce(size_t p) {
+    uint8_t msg[MPSC_LEN];
+    for (size_t i = 0; i < MPSC_MSGS; i++) {
+        fill_msg(msg, MPSC_LEN, p * MPSC_MSGS + i);
+        while (!ring_mpsc_push(&mpsc_q, msg, MPSC_LEN)) model_spin();
+    }
+}
+
+static void mpsc_producer0(void) { mpsc_produce(0); }
+static void mpsc_producer1(void) { mpsc_produce(1); }
+
+static void mpsc_consumer(void) {
+    uint8_t msg[MPSC_LEN];
+    size_t next[2] = { 0, 0 };
+
+    for (size_t n = 0; n < 2 * MPSC_MSGS; n++) {
+        while (!ring_mpsc_pop(&mpsc_q, msg, MPSC_LEN)) model_spin();
+        size_t tag = (size_t)(msg[0] - 1) / 16;
+        size_t p = tag / MPSC_MSGS;
+        MODEL_ASSERT(p < 2);
+        MODEL_ASSERT(tag % MPSC_MSGS == next[p]);       /* Per-producer order */
+        MODEL_ASSERT(msg_matches(msg, MPSC_LEN, tag));  /* Not interleaved */
+        next[p]++;
+    }
+}
+
+static const model_test_t model_mpsc_two_producers = {
+    mpsc_setup, { mpsc_producer0, mpsc_producer1, mpsc_consumer }, 3, 1, false
+};
+
+/* ============ Broadcast ============ */
+
+#define BCAST_MSGS 3
+#define BCAST_LEN 4
+
+static ring_broadcast_t bcast;
+static bool bcast_done;
+
+static void bcast_blocking_setup(void) {
+    ring_broadcast_init(&bcast, 8, model_storage, 2, RING_BROADCAST_BLOCKING);
+    model_track(&bcast.ring);
+    bcast_done = false;
+}
+
+static void bcast_producer(void) {
+    uint8_t msg[BCAST_LEN];
+    for (size_t i = 0; i < BCAST_MSGS; i++) {
+        fill_msg(msg, BCAST_LEN, i);
+        while (!ring_broadcast_push(&bcast, msg, BCAST_LEN)) model_spin();
+    }
+    bcast_done = true;
+}
+
+static void bcast_read_all(size_t reader) {
+    uint8_t msg[BCAST_LEN];
+    for (size_t i = 0; i < BCAST_MSGS; i++) {
+        while (!ring_broadcast_pop(&bcast, reader, msg, BCAST_LEN, NULL)) model_spin();
+        MODEL_ASSERT(msg_matches(msg, BCAST_LEN, i));
+    }
+}
+
+static void bcast_reader0(void) { bcast_read_all(0); }
+static void bcast_reader1(void) { bcast_read_all(1); }
+
+static const model_test_t model_broadcast_blocking = {
+    bcast_blocking_setup, { bcast_producer, bcast_reader0, bcast_reader1 }, 3, 1, false
+};
+
+static void bcast_lossy_setup(void) {
+    ring_broadcast_init(&bcast, 8, model_storage, 1, RING_BROADCAST_LOSSY);
+    model_track(&bcast.ring);
+    bcast_done = false;
+}
+
+/*
+ * A lossy reader may miss messages, but whatever it returns must be one
+ * whole message, newer than the last, and never a copy that raced.
+ */
+static void bcast_lossy_reader(void) {
+    uint8_t msg[BCAST_LEN];
+    size_t lost, next = 0;
+    model_thread_t *t = model_self();
+
+    for (;;) {
+        bool done = bcast_done;
+        t->tainted = false;
+        if (ring_broadcast_pop(&bcast, 0, msg, BCAST_LEN, &lost)) {
+            MODEL_ASSERT(!t->tainted);
+            size_t tag = (size_t)(msg[0] - 1) / 16;
+            MODEL_ASSERT(tag >= next && tag < BCAST_MSGS);
+            MODEL_ASSERT(msg_matches(msg, BCAST_LEN, tag));
+            next = tag + 1;
+        } else if (lost == 0) {
+            if (done) break;
+            model_spin();
+        }
+    }
+}
+
+static const model_test_t model_broadcast_lossy = {
+    bcast_lossy_setup, { bcast_producer, bcast_lossy_reader }, 2, 3, true
+};
+
+/* ============ Lossy (Overwrite-Oldest) ============ */
+
+#define LOSSY_MSGS 3
+#define LOSSY_LEN 4
+
+static ring_lossy_t lossy;
+static bool lossy_done;
+
+static void lossy_setup(void) {
+    ring_lossy_init(&lossy, 8, model_storage);
+    model_track(&lossy.ring);
+    lossy_done = false;
+}
+
+static void lossy_producer(void) {
+    uint8_t msg[LOSSY_LEN];
+    for (size_t i = 0; i < LOSSY_MSGS; i++) {
+        fill_msg(msg, LOSSY_LEN, i);
+        ring_lossy_push(&lossy, msg, LOSSY_LEN);
+    }
+    lossy_done = true;
+}
+
+typedef bool (*lossy_pop_fn_t)(ring_lossy_t *l, uint8_t *dst, size_t len, size_t *lost);
+
+static void lossy_read(lossy_pop_fn_t pop) {
+    uint8_t msg[LOSSY_LEN];
+    size_t lost, next = 0, seen_lost = 0;
+    model_thread_t *t = model_self();
+
+    for (;;) {
+        bool done = lossy_done;
+        t->tainted = false;
+        if (pop(&lossy, msg, LOSSY_LEN, &lost)) {
+            MODEL_ASSERT(!t->tainted);
+            size_t tag = (size_t)(msg[0] - 1) / 16;
+            MODEL_ASSERT(tag >= next && tag < LOSSY_MSGS);
+            MODEL_ASSERT(msg_matches(msg, LOSSY_LEN, tag));
+            next = tag + 1;
+        } else if (lost > 0) {
+            MODEL_ASSERT(lost % LOSSY_LEN == 0);        /* Skips land on push boundaries */
+            seen_lost += lost;
+        } else {
+            if (done) break;
+            model_spin();
+        }
+    }
+    MODEL_ASSERT(ring_lossy_lost(&lossy) == seen_lost);
+}
+
+static void lossy_reader(void) {
+    lossy_read(ring_lossy_pop);
+}
+
+static const model_test_t model_lossy_raw = {
+    lossy_setup, { lossy_producer, lossy_reader }, 2, 3, true
+};
+
+/* Records of 1..3 bytes, each tagging its index; 5 to 7 bytes framed in an 8-byte ring */
+static void lossy_msg_producer(void) {
+    uint8_t msg[3];
+    for (size_t i = 0; i < LOSSY_MSGS; i++) {
+        fill_msg(msg, i + 1, i);
+        ring_lossy_push_msg(&lossy, msg, i + 1);
+    }
+    lossy_done = true;
+}
+
+static void lossy_msg_reader(void) {
+    uint8_t msg[3];
+    size_t len, lost, next = 0;
+    model_thread_t *t = model_self();
+
+    for (;;) {
+        bool done = lossy_done;
+        t->tainted = false;
+        if (ring_lossy_pop_msg(&lossy, msg, sizeof(msg), &len, &lost)) {
+            MODEL_ASSERT(!t->tainted);
+            size_t tag = (size_t)(msg[0] - 1) / 16;
+            MODEL_ASSERT(tag >= next && tag < LOSSY_MSGS && len == tag + 1);
+            MODEL_ASSERT(msg_matches(msg, len, tag));
+            next = tag + 1;
+        } else if (lost == 0) {
+            if (done) break;
+            model_spin();
+        }
+    }
+}
+
+static const model_test_t model_lossy_records = {
+    lossy_setup, { lossy_msg_producer, lossy_msg_reader }, 2, 3, true
+};
+
+/* ============ Pipeline Stages ============ */
+
+#define PIPE_MSGS 2
+#define PIPE_LEN 2
+
+static ring_pipeline_t pipe_p;
+
+static void pipe_setup(void) {
+    ring_pipeline_init(&pipe_p, 4, model_storage, 2);
+    model_track(&pipe_p.ring);
+}
+
+static void pipe_producer(void) {
+    uint8_t msg[PIPE_LEN];
+    for (size_t i = 0; i < PIPE_MSGS; i++) {
+        fill_msg(msg, PIPE_LEN, i);
+        while (!ring_push(&pipe_p.ring, msg, PIPE_LEN)) model_spin();
+    }
+}
+
+/* Stage 0 rewrites each message in place; stage 1 must see the rewrite */
+static void pipe_stage0(void) {
+    ring_span_t span;
+    for (size_t i = 0; i < PIPE_MSGS; i++) {
+        while (!ring_stage_peek(&pipe_p, 0, PIPE_LEN, &span)) model_spin();
+        uint8_t b;
+        memcpy(&b, span.first, 1);
+        b = (uint8_t)(b + 100);
+        memcpy(span.first, &b, 1);
+        ring_stage_release(&pipe_p, 0, PIPE_LEN);
+    }
+}
+
+static void pipe_stage1(void) {
+    ring_span_t span;
+    uint8_t msg[PIPE_LEN], want[PIPE_LEN];
+    for (size_t i = 0; i < PIPE_MSGS; i++) {
+        while (!ring_stage_peek(&pipe_p, 1, PIPE_LEN, &span)) model_spin();
+        memcpy(msg, span.first, span.first_len);
+        if (span.second_len > 0) memcpy(msg + span.first_len, span.second, span.second_len);
+        fill_msg(want, PIPE_LEN, i);
+        want[0] = (uint8_t)(want[0] + 100);
+        MODEL_ASSERT(memcmp(msg, want, PIPE_LEN) == 0);
+        ring_stage_release(&pipe_p, 1, PIPE_LEN);
+    }
+}
+
+static const model_test_t model_pipeline_in_place = {
+    pipe_setup, { pipe_producer, pipe_stage0, pipe_stage1 }, 3, 2, false
+};
+
+/* ============ Mutation Checks (the search must catch these) ============ */
+
+/* ring_push() with the head published relaxed instead of release */
+static bool relaxed_publish_push(ring_buffer_t *rb, uint8_t *src, size_t len) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    if (len > ring_writable(rb, head, len)) return false;
+    ring_copy_in(rb, head & rb->mask, src, len);
+    atomic_store_explicit(&rb->head, head + len, memory_order_relaxed);
+    return true;
+}
+
+static void relaxed_producer(void) {
+    uint8_t msg[SPSC_LEN];
+    for (size_t i = 0; i < SPSC_MSGS; i++) {
+        fill_msg(msg, SPSC_LEN, i);
+        while (!relaxed_publish_push(&spsc_rb, msg, SPSC_LEN)) model_spin();
+    }
+}
+
+static const model_test_t model_relaxed_publish_is_caught = {
+    spsc_setup, { relaxed_producer, spsc_consumer }, 2, 2, false
+};
+
+/* ring_lossy_pop() without the acquire fence before re-checking the claim */
+static bool unfenced_lossy_pop(ring_lossy_t *l, uint8_t *dst, size_t len, size_t *lost) {
+    ring_buffer_t *rb = &l->ring;
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+
+    if (lost != NULL) *lost = 0;
+    if (!ring_lossy_readable(l, tail, len, lost)) return false;
+
+    ring_copy_out(rb, tail & rb->mask, dst, len);
+
+    size_t claim = atomic_load_explicit(&l->claim, memory_order_relaxed);
+    if (claim - tail > rb->capacity) {
+        ring_lossy_skip(l, tail, lost);
+        return false;
+    }
+    atomic_store_explicit(&rb->tail, tail + len, memory_order_release);
+    return true;
+}
+
+static void unfenced_lossy_reader(void) {
+    lossy_read(unfenced_lossy_pop);
+}
+
+static const model_test_t model_unfenced_seqlock_is_caught = {
+    lossy_setup, { lossy_producer, unfenced_lossy_reader }, 2, 3, true
+};
+
+/*
+ * ./test_model [N]: at least N preemptions per test. The defaults keep the
+ * whole run to a second or so; each extra preemption costs 10-50x.
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) model_min_preemptions = strtoul(argv[1], NULL, 10);
+
+    printf("Running model checks...\n\n");
+    printf("SPSC:\n");
+    RUN_MODEL(spsc_push_pop, true);
+    RUN_MODEL(spsc_reserve_drain, true);
+
+    printf("\nMPSC:\n");
+    RUN_MODEL(mpsc_two_producers, true);
+
+    printf("\nBroadcast:\n");
+    RUN_MODEL(broadcast_blocking, true);
+    RUN_MODEL(broadcast_lossy, true);
+
+    printf("\nLossy (Overwrite-Oldest):\n");
+    RUN_MODEL(lossy_raw, true);
+    RUN_MODEL(lossy_records, true);
+
+    printf("\nPipeline Stages:\n");
+    RUN_MODEL(pipeline_in_place, true);
+
+    printf("\nMutation Checks:\n");
+    RUN_MODEL(relaxed_publish_is_caught, false);
+    RUN_MODEL(unfenced_seqlock_is_caught, false);
+
+    printf("\n========================================\n");
+    printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -7,8 +7,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <sys/wait.h>
 
 #include "ring_buffer.c"
+#include "ring_mpsc.c"
+#include "ring_mpmc.c"
+#include "ring_broadcast.c"
+#include "ring_wait.c"
+#include "ring_shm.c"
+#include "ring_mirror.c"
+#include "ring_alloc.c"
+#include "ring_typed.c"
+#include "ring_hist.c"
+#include "ring_clock.c"
+#include "ring_lossy.c"
+#include "ring_log.c"
+#include "ring_sink.c"
+#include "ring_pipeline.c"
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -35,10 +50,12 @@ static int tests_failed = 0;
 #define ASSERT_FALSE(x) ASSERT(!(x))
 
 /* Helper to initialize buffer */
+/* Tests run one at a time, so they share one caller-provided backing region */
+static alignas(CACHE_LINE) uint8_t test_storage[BUFFER_SIZE];
+
 static void init_buffer(ring_buffer_t *rb) {
-    memset(rb, 0, sizeof(*rb));
-    atomic_store(&rb->head, 0);
-    atomic_store(&rb->tail, 0);
+    memset(test_storage, 0, sizeof(test_storage));
+    ring_init(rb, BUFFER_SIZE, test_storage);
 }
 
 /* ============ Basic Operations ============ */
@@ -95,19 +112,19 @@ TEST(push_pop_sequence) {
 
 /* ============ Capacity Tests ============ */
 
-TEST(max_capacity_is_buffer_size_minus_one) {
+TEST(max_capacity_is_buffer_size) {
     ring_buffer_t rb;
     init_buffer(&rb);
 
-    /* Buffer can hold BUFFER_SIZE - 1 bytes (one slot reserved) */
-    uint8_t data[BUFFER_SIZE];
+    /* Free-running counters tell full from empty, so every byte is usable */
+    uint8_t data[BUFFER_SIZE + 1];
     memset(data, 0xAA, sizeof(data));
 
-    /* Should fail for full BUFFER_SIZE */
-    ASSERT_FALSE(ring_push(&rb, data, BUFFER_SIZE));
+    /* Should fail for more than BUFFER_SIZE */
+    ASSERT_FALSE(ring_push(&rb, data, BUFFER_SIZE + 1));
 
-    /* Should succeed for BUFFER_SIZE - 1 */
-    ASSERT_TRUE(ring_push(&rb, data, BUFFER_SIZE - 1));
+    /* Should succeed for exactly BUFFER_SIZE */
+    ASSERT_TRUE(ring_push(&rb, data, BUFFER_SIZE));
 
     /* Buffer is now full, even 1 byte should fail */
     ASSERT_FALSE(ring_push(&rb, data, 1));
@@ -117,14 +134,14 @@ TEST(fill_and_drain) {
     ring_buffer_t rb;
     init_buffer(&rb);
 
-    uint8_t data[BUFFER_SIZE - 1];
+    uint8_t data[BUFFER_SIZE];
     for (size_t i = 0; i < sizeof(data); i++) {
         data[i] = (uint8_t)(i & 0xFF);
     }
 
     ASSERT_TRUE(ring_push(&rb, data, sizeof(data)));
 
-    uint8_t out[BUFFER_SIZE - 1];
+    uint8_t out[BUFFER_SIZE];
     ASSERT_TRUE(ring_pop(&rb, out, sizeof(out)));
 
     ASSERT_EQ(memcmp(data, out, sizeof(data)), 0);
@@ -197,14 +214,14 @@ TEST(wraparound_multiple_cycles) {
 
     /* Do multiple full cycles to stress wraparound */
     for (int cycle = 0; cycle < 10; cycle++) {
-        uint8_t data[BUFFER_SIZE - 1];
+        uint8_t data[BUFFER_SIZE];
         for (size_t i = 0; i < sizeof(data); i++) {
             data[i] = (uint8_t)((cycle + i) & 0xFF);
         }
 
         ASSERT_TRUE(ring_push(&rb, data, sizeof(data)));
 
-        uint8_t out[BUFFER_SIZE - 1];
+        uint8_t out[BUFFER_SIZE];
         ASSERT_TRUE(ring_pop(&rb, out, sizeof(out)));
 
         ASSERT_EQ(memcmp(data, out, sizeof(data)), 0);
@@ -259,6 +276,49 @@ TEST(alternating_push_pop) {
     }
 }
 
+TEST(counters_are_free_running) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t data[300] = {0};
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(ring_push(&rb, data, 300));
+        ASSERT_EQ(ring_used(&rb), 300);
+        ASSERT_TRUE(ring_pop(&rb, data, 200));
+        ASSERT_TRUE(ring_pop(&rb, data, 100));
+    }
+
+    /* Totals keep growing across laps instead of wrapping at the capacity */
+    ASSERT_EQ(ring_bytes_written(&rb), 3000);
+    ASSERT_EQ(ring_bytes_read(&rb), 3000);
+    ASSERT_EQ(ring_used(&rb), 0);
+}
+
+TEST(counters_survive_integer_overflow) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    /* Start just below the counter's wrap so the pushes cross it */
+    size_t start = SIZE_MAX - 100;
+    atomic_store(&rb.head, start);
+    atomic_store(&rb.tail, start);
+    rb.cached_head = start;
+    rb.cached_tail = start;
+
+    uint8_t data[BUFFER_SIZE], out[BUFFER_SIZE];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 13);
+
+    for (int lap = 0; lap < 3; lap++) {
+        ASSERT_TRUE(ring_push(&rb, data, BUFFER_SIZE));
+        ASSERT_FALSE(ring_push(&rb, data, 1));
+        ASSERT_EQ(ring_used(&rb), BUFFER_SIZE);
+        ASSERT_TRUE(ring_pop(&rb, out, BUFFER_SIZE));
+        ASSERT_EQ(memcmp(data, out, BUFFER_SIZE), 0);
+        ASSERT_FALSE(ring_pop(&rb, out, 1));
+    }
+    ASSERT_EQ(ring_bytes_written(&rb), start + 3 * BUFFER_SIZE);
+}
+
 /* ============ Data Integrity ============ */
 
 TEST(data_pattern_integrity) {
@@ -303,6 +363,1986 @@ TEST(fifo_order_preserved) {
     }
 }
 
+/* ============ Runtime Sizing ============ */
+
+TEST(init_rejects_non_power_of_two) {
+    ring_buffer_t rb;
+    ASSERT_FALSE(ring_init(&rb, 0, NULL));
+    ASSERT_FALSE(ring_init(&rb, 1000, NULL));
+    ASSERT_FALSE(ring_init(&rb, 4097, NULL));
+}
+
+TEST(init_rejects_misaligned_buffer) {
+    ring_buffer_t rb;
+    ASSERT_FALSE(ring_init(&rb, 64, test_storage + 1));
+}
+
+TEST(init_uses_caller_buffer) {
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init(&rb, 256, test_storage));
+    ASSERT_TRUE(rb.data == test_storage);
+    ASSERT_EQ(rb.capacity, 256);
+    ASSERT_EQ(rb.mask, 255);
+
+    uint8_t data[256];
+    memset(data, 0x5A, sizeof(data));
+    ASSERT_TRUE(ring_push(&rb, data, sizeof(data)));
+    ASSERT_FALSE(ring_push(&rb, data, 1));
+    ASSERT_EQ(test_storage[0], 0x5A);
+
+    ring_destroy(&rb);
+}
+
+TEST(init_allocates_large_ring) {
+    const size_t capacity = 1 << 20;
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init(&rb, capacity, NULL));
+    ASSERT_EQ(((uintptr_t)rb.data & (CACHE_LINE - 1)), 0);
+
+    uint8_t *data = malloc(capacity);
+    uint8_t *out = malloc(capacity);
+    for (size_t i = 0; i < capacity; i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+
+    /* Offset the indices so the bulk transfer wraps */
+    ASSERT_TRUE(ring_push(&rb, data, 1000));
+    ASSERT_TRUE(ring_pop(&rb, out, 1000));
+    ASSERT_TRUE(ring_push(&rb, data, capacity));
+    ASSERT_FALSE(ring_push(&rb, data, 1));
+    ASSERT_TRUE(ring_pop(&rb, out, capacity));
+    int same = memcmp(data, out, capacity) == 0;
+
+    free(data);
+    free(out);
+    ring_destroy(&rb);
+    ASSERT_TRUE(same);
+}
+
+TEST(tiny_ring) {
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init(&rb, 2, NULL));
+
+    for (int i = 0; i < 10; i++) {
+        uint8_t val[2] = { (uint8_t)i, (uint8_t)(i + 1) };
+        ASSERT_TRUE(ring_push(&rb, val, 2));
+        ASSERT_FALSE(ring_push(&rb, val, 1));
+
+        uint8_t out[2];
+        ASSERT_TRUE(ring_pop(&rb, out, 1));
+        ASSERT_TRUE(ring_pop(&rb, out + 1, 1));
+        ASSERT_EQ(out[0], val[0]);
+        ASSERT_EQ(out[1], val[1]);
+    }
+
+    ring_destroy(&rb);
+}
+
+/* ============ Zero-Copy API ============ */
+
+TEST(reserve_commit_roundtrip) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_reserve(&rb, 4, &span));
+    ASSERT_TRUE(span.first == rb.data);
+    ASSERT_EQ(span.first_len, 4);
+    ASSERT_TRUE(span.second == NULL);
+
+    /* Nothing is visible until commit */
+    uint8_t out[4];
+    memcpy(span.first, "abcd", 4);
+    ASSERT_FALSE(ring_pop(&rb, out, 1));
+
+    ring_commit(&rb, 4);
+    ASSERT_TRUE(ring_pop(&rb, out, 4));
+    ASSERT_EQ(memcmp(out, "abcd", 4), 0);
+}
+
+TEST(reserve_fails_when_full) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    ring_span_t span;
+    ASSERT_FALSE(ring_reserve(&rb, BUFFER_SIZE + 1, &span));
+    ASSERT_TRUE(ring_reserve(&rb, BUFFER_SIZE, &span));
+    ring_commit(&rb, BUFFER_SIZE);
+    ASSERT_FALSE(ring_reserve(&rb, 1, &span));
+}
+
+TEST(reserve_wrapped_reports_two_spans) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t fill[BUFFER_SIZE - 10];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push(&rb, fill, sizeof(fill)));
+    ASSERT_TRUE(ring_pop(&rb, fill, sizeof(fill)));
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_reserve(&rb, 30, &span));
+    ASSERT_EQ(span.first_len, 10);
+    ASSERT_TRUE(span.second == rb.data);
+    ASSERT_EQ(span.second_len, 20);
+
+    for (size_t i = 0; i < span.first_len; i++) span.first[i] = (uint8_t)i;
+    for (size_t i = 0; i < span.second_len; i++) span.second[i] = (uint8_t)(10 + i);
+    ring_commit(&rb, 30);
+
+    /* The consumer sees the same split */
+    ASSERT_TRUE(ring_peek(&rb, 30, &span));
+    ASSERT_EQ(span.first_len, 10);
+    ASSERT_EQ(span.second_len, 20);
+
+    uint8_t out[30];
+    ASSERT_TRUE(ring_pop(&rb, out, 30));
+    for (int i = 0; i < 30; i++) {
+        ASSERT_EQ(out[i], i);
+    }
+}
+
+TEST(reserve_contiguous_refuses_wrap) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t fill[BUFFER_SIZE - 10];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push(&rb, fill, sizeof(fill)));
+    ASSERT_TRUE(ring_pop(&rb, fill, sizeof(fill)));
+
+    ASSERT_TRUE(ring_reserve_contiguous(&rb, 30) == NULL);
+
+    uint8_t *p = ring_reserve_contiguous(&rb, 10);
+    ASSERT_TRUE(p == rb.data + BUFFER_SIZE - 10);
+}
+
+TEST(commit_less_than_reserved) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_reserve(&rb, 64, &span));
+    memcpy(span.first, "xyz", 3);
+    ring_commit(&rb, 3);
+
+    uint8_t out[4];
+    ASSERT_FALSE(ring_pop(&rb, out, 4));
+    ASSERT_TRUE(ring_pop(&rb, out, 3));
+    ASSERT_EQ(memcmp(out, "xyz", 3), 0);
+}
+
+TEST(peek_release) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t data[] = {1, 2, 3, 4, 5, 6};
+    ASSERT_TRUE(ring_push(&rb, data, 6));
+
+    ring_span_t span;
+    ASSERT_FALSE(ring_peek(&rb, 7, &span));
+    ASSERT_TRUE(ring_peek(&rb, 6, &span));
+    ASSERT_EQ(span.first_len, 6);
+    ASSERT_EQ(memcmp(span.first, data, 6), 0);
+
+    /* Peeking does not consume */
+    ASSERT_TRUE(ring_peek(&rb, 6, &span));
+
+    ring_release(&rb, 4);
+    uint8_t out[2];
+    ASSERT_FALSE(ring_pop(&rb, out, 3));
+    ASSERT_TRUE(ring_pop(&rb, out, 2));
+    ASSERT_EQ(out[0], 5);
+    ASSERT_EQ(out[1], 6);
+}
+
+/* ============ Batched API ============ */
+
+TEST(push_batch_all_fit) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t a[] = {1, 2}, b[] = {3}, c[] = {4, 5, 6};
+    ring_iovec_t in[] = { {a, 2}, {b, 1}, {c, 3} };
+    ASSERT_EQ(ring_push_batch(&rb, in, 3), 3);
+
+    uint8_t out[6];
+    ASSERT_TRUE(ring_pop(&rb, out, 6));
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ(out[i], i + 1);
+    }
+}
+
+TEST(push_batch_partial_prefix) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t fill[BUFFER_SIZE - 11];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push(&rb, fill, sizeof(fill)));
+
+    /* 10 bytes free: the first two fit, the third does not */
+    uint8_t msg[8] = {0};
+    ring_iovec_t in[] = { {msg, 4}, {msg, 4}, {msg, 4}, {msg, 1} };
+    ASSERT_EQ(ring_push_batch(&rb, in, 4), 2);
+
+    ASSERT_TRUE(ring_pop(&rb, fill, sizeof(fill)));
+    ASSERT_TRUE(ring_pop(&rb, msg, 8));
+    ASSERT_FALSE(ring_pop(&rb, msg, 1));
+}
+
+TEST(pop_batch_roundtrip_wrapped) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t fill[BUFFER_SIZE - 5];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push(&rb, fill, sizeof(fill)));
+    ASSERT_TRUE(ring_pop(&rb, fill, sizeof(fill)));
+
+    uint8_t src[16];
+    for (int i = 0; i < 16; i++) src[i] = (uint8_t)(i + 1);
+    ring_iovec_t in[] = { {src, 8}, {src + 8, 8} };
+    ASSERT_EQ(ring_push_batch(&rb, in, 2), 2);
+
+    uint8_t d1[3], d2[10], d3[8];
+    ring_iovec_t out[] = { {d1, 3}, {d2, 10}, {d3, 8} };
+    ASSERT_EQ(ring_pop_batch(&rb, out, 3), 2);
+    ASSERT_EQ(memcmp(d1, src, 3), 0);
+    ASSERT_EQ(memcmp(d2, src + 3, 10), 0);
+
+    /* The remaining 3 bytes are still there */
+    ASSERT_TRUE(ring_pop(&rb, d3, 3));
+    ASSERT_EQ(memcmp(d3, src + 13, 3), 0);
+}
+
+TEST(batch_empty) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    ring_iovec_t io[1];
+    ASSERT_EQ(ring_push_batch(&rb, io, 0), 0);
+    ASSERT_EQ(ring_pop_batch(&rb, io, 0), 0);
+
+    uint8_t out[1];
+    io[0].base = out;
+    io[0].len = 1;
+    ASSERT_EQ(ring_pop_batch(&rb, io, 1), 0);
+}
+
+/* ============ Message Framing ============ */
+
+TEST(msg_roundtrip_variable_sizes) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[100];
+    for (int i = 0; i < 100; i++) src[i] = (uint8_t)i;
+
+    ASSERT_TRUE(ring_push_msg(&rb, src, 1));
+    ASSERT_TRUE(ring_push_msg(&rb, src, 0));
+    ASSERT_TRUE(ring_push_msg(&rb, src, 100));
+
+    uint8_t out[100];
+    size_t len = 0;
+    ASSERT_TRUE(ring_pop_msg(&rb, out, sizeof(out), &len));
+    ASSERT_EQ(len, 1);
+    ASSERT_EQ(out[0], 0);
+    ASSERT_TRUE(ring_pop_msg(&rb, out, sizeof(out), &len));
+    ASSERT_EQ(len, 0);
+    ASSERT_TRUE(ring_pop_msg(&rb, out, sizeof(out), &len));
+    ASSERT_EQ(len, 100);
+    ASSERT_EQ(memcmp(out, src, 100), 0);
+
+    ASSERT_FALSE(ring_pop_msg(&rb, out, sizeof(out), &len));
+}
+
+TEST(msg_pop_too_small_keeps_message) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[20] = {7};
+    ASSERT_TRUE(ring_push_msg(&rb, src, 20));
+
+    uint8_t out[20];
+    size_t len = 0;
+    ASSERT_FALSE(ring_pop_msg(&rb, out, 10, &len));
+    ASSERT_EQ(len, 20);
+
+    ASSERT_TRUE(ring_pop_msg(&rb, out, 20, &len));
+    ASSERT_EQ(out[0], 7);
+}
+
+TEST(msg_wrapped_frame) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    /* Leave 12 bytes before the wrap point */
+    uint8_t fill[BUFFER_SIZE - 16];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push_msg(&rb, fill, sizeof(fill) - RING_MSG_HEADER));
+    size_t len;
+    ASSERT_TRUE(ring_pop_msg(&rb, fill, sizeof(fill), &len));
+
+    uint8_t src[30];
+    for (int i = 0; i < 30; i++) src[i] = (uint8_t)(i + 1);
+    ASSERT_TRUE(ring_push_msg(&rb, src, 30));
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_peek_msg(&rb, &span));
+    ASSERT_EQ(span.first_len, 12);
+    ASSERT_EQ(span.second_len, 18);
+
+    uint8_t out[30];
+    ASSERT_TRUE(ring_pop_msg(&rb, out, sizeof(out), &len));
+    ASSERT_EQ(len, 30);
+    ASSERT_EQ(memcmp(out, src, 30), 0);
+}
+
+TEST(msg_contiguous_pads_at_wrap) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t fill[BUFFER_SIZE - 16];
+    memset(fill, 0, sizeof(fill));
+    ASSERT_TRUE(ring_push_msg(&rb, fill, sizeof(fill) - RING_MSG_HEADER));
+    size_t len;
+    ASSERT_TRUE(ring_pop_msg(&rb, fill, sizeof(fill), &len));
+
+    uint8_t src[30];
+    for (int i = 0; i < 30; i++) src[i] = (uint8_t)(i + 1);
+    ASSERT_TRUE(ring_push_msg_contiguous(&rb, src, 30));
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_peek_msg(&rb, &span));
+    ASSERT_TRUE(span.first == rb.data + RING_MSG_HEADER);
+    ASSERT_EQ(span.first_len, 30);
+    ASSERT_TRUE(span.second == NULL);
+    ASSERT_EQ(memcmp(span.first, src, 30), 0);
+
+    ring_release_msg(&rb);
+    ASSERT_FALSE(ring_peek_msg(&rb, &span));
+
+    /* Padding was consumed with the message, so the whole ring is free */
+    ASSERT_TRUE(ring_push_msg(&rb, fill, sizeof(fill)));
+}
+
+TEST(msg_contiguous_rejects_over_half_capacity) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    /* Move head to the middle and drain, leaving the ring empty */
+    uint8_t fill[BUFFER_SIZE];
+    memset(fill, 0, sizeof(fill));
+    size_t len;
+    ASSERT_TRUE(ring_push_msg(&rb, fill, BUFFER_SIZE / 2 - RING_MSG_HEADER));
+    ASSERT_TRUE(ring_pop_msg(&rb, fill, sizeof(fill), &len));
+
+    /* Padding to the end plus a frame just over half would exceed the capacity */
+    ASSERT_FALSE(ring_push_msg_contiguous(&rb, fill, BUFFER_SIZE / 2 - RING_MSG_HEADER + 4));
+    ASSERT_EQ(atomic_load(&rb.head), BUFFER_SIZE / 2);
+
+    /* A frame of exactly half the capacity still fits */
+    ASSERT_TRUE(ring_push_msg_contiguous(&rb, fill, BUFFER_SIZE / 2 - RING_MSG_HEADER));
+    ring_span_t span;
+    ASSERT_TRUE(ring_peek_msg(&rb, &span));
+    ASSERT_TRUE(span.first == rb.data + BUFFER_SIZE / 2 + RING_MSG_HEADER);
+    ASSERT_TRUE(span.second == NULL);
+}
+
+TEST(msg_full_ring_fails) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[BUFFER_SIZE];
+    memset(src, 0, sizeof(src));
+    ASSERT_FALSE(ring_push_msg(&rb, src, BUFFER_SIZE - RING_MSG_HEADER + 1));
+    ASSERT_TRUE(ring_push_msg(&rb, src, BUFFER_SIZE - RING_MSG_HEADER));
+    ASSERT_FALSE(ring_push_msg(&rb, src, 0));
+}
+
+/* ============ MPSC ============ */
+
+TEST(mpsc_push_pop) {
+    ring_mpsc_t q;
+    ASSERT_TRUE(ring_mpsc_init(&q, BUFFER_SIZE, test_storage));
+
+    uint8_t a[] = {1, 2, 3}, b[] = {4, 5};
+    ASSERT_TRUE(ring_mpsc_push(&q, a, 3));
+    ASSERT_TRUE(ring_mpsc_push(&q, b, 2));
+
+    uint8_t out[5];
+    ASSERT_FALSE(ring_mpsc_pop(&q, out, 6));
+    ASSERT_TRUE(ring_mpsc_pop(&q, out, 5));
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(out[i], i + 1);
+    }
+
+    ring_mpsc_destroy(&q);
+}
+
+TEST(mpsc_capacity_and_wrap) {
+    ring_mpsc_t q;
+    ASSERT_TRUE(ring_mpsc_init(&q, BUFFER_SIZE, test_storage));
+
+    uint8_t data[BUFFER_SIZE + 1];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 3);
+    uint8_t out[BUFFER_SIZE];
+
+    ASSERT_FALSE(ring_mpsc_push(&q, data, BUFFER_SIZE + 1));
+    ASSERT_TRUE(ring_mpsc_push(&q, data, BUFFER_SIZE));
+    ASSERT_FALSE(ring_mpsc_push(&q, data, 1));
+    ASSERT_TRUE(ring_mpsc_pop(&q, out, BUFFER_SIZE - 100));
+
+    /* Wraps around the end of the data region */
+    ASSERT_TRUE(ring_mpsc_push(&q, data, 90));
+    ASSERT_TRUE(ring_mpsc_pop(&q, out, 100));
+    ASSERT_TRUE(ring_mpsc_pop(&q, out, 90));
+    ASSERT_EQ(memcmp(out, data, 90), 0);
+
+    ring_mpsc_destroy(&q);
+}
+
+/* ============ MPMC ============ */
+
+TEST(mpmc_init_rejects_bad_geometry) {
+    ring_mpmc_t q;
+    ASSERT_FALSE(ring_mpmc_init(&q, 0, 8, NULL));
+    ASSERT_FALSE(ring_mpmc_init(&q, 1, 8, NULL));
+    ASSERT_FALSE(ring_mpmc_init(&q, 12, 8, NULL));
+    ASSERT_FALSE(ring_mpmc_init(&q, 16, 0, NULL));
+}
+
+TEST(mpmc_fifo_full_empty) {
+    ring_mpmc_t q;
+    ASSERT_TRUE(ring_mpmc_init(&q, 4, 12, NULL));
+
+    uint8_t msg[12], out[12];
+    ASSERT_FALSE(ring_mpmc_pop(&q, out));
+
+    /* All slots are usable */
+    for (int i = 0; i < 4; i++) {
+        memset(msg, i, sizeof(msg));
+        ASSERT_TRUE(ring_mpmc_push(&q, msg));
+    }
+    ASSERT_FALSE(ring_mpmc_push(&q, msg));
+
+    for (int lap = 0; lap < 3; lap++) {
+        for (int i = 0; i < 4; i++) {
+            ASSERT_TRUE(ring_mpmc_pop(&q, out));
+            ASSERT_EQ(out[0], lap * 4 + i);
+            ASSERT_EQ(out[11], lap * 4 + i);
+            memset(msg, lap * 4 + i + 4, sizeof(msg));
+            ASSERT_TRUE(ring_mpmc_push(&q, msg));
+        }
+    }
+
+    ring_mpmc_destroy(&q);
+}
+
+TEST(mpmc_caller_buffer) {
+    ring_mpmc_t q;
+    ASSERT_TRUE(ring_mpmc_storage_size(8, 64) <= sizeof(test_storage));
+    ASSERT_TRUE(ring_mpmc_init(&q, 8, 64, test_storage));
+    ASSERT_TRUE(q.slots == test_storage);
+
+    uint8_t msg[64] = {42}, out[64];
+    ASSERT_TRUE(ring_mpmc_push(&q, msg));
+    ASSERT_TRUE(ring_mpmc_pop(&q, out));
+    ASSERT_EQ(out[0], 42);
+
+    ring_mpmc_destroy(&q);
+}
+
+/* ============ Broadcast ============ */
+
+TEST(broadcast_every_reader_sees_every_message) {
+    ring_broadcast_t b;
+    ASSERT_TRUE(ring_broadcast_init(&b, 64, test_storage, 3, RING_BROADCAST_BLOCKING));
+
+    uint8_t msg[] = {1, 2, 3, 4};
+    ASSERT_TRUE(ring_broadcast_push(&b, msg, 4));
+
+    for (size_t r = 0; r < 3; r++) {
+        uint8_t out[4];
+        ASSERT_EQ(ring_broadcast_lag(&b, r), 4);
+        ASSERT_TRUE(ring_broadcast_pop(&b, r, out, 4, NULL));
+        ASSERT_EQ(memcmp(out, msg, 4), 0);
+        ASSERT_FALSE(ring_broadcast_pop(&b, r, out, 1, NULL));
+    }
+
+    ring_broadcast_destroy(&b);
+}
+
+TEST(broadcast_blocking_gated_by_slowest_reader) {
+    ring_broadcast_t b;
+    ASSERT_TRUE(ring_broadcast_init(&b, 64, test_storage, 2, RING_BROADCAST_BLOCKING));
+
+    /* The full capacity is usable */
+    uint8_t data[64], out[64];
+    memset(data, 0x33, sizeof(data));
+    ASSERT_TRUE(ring_broadcast_push(&b, data, 64));
+    ASSERT_FALSE(ring_broadcast_push(&b, data, 1));
+
+    /* Reader 0 catching up is not enough; reader 1 still holds the space */
+    ASSERT_TRUE(ring_broadcast_pop(&b, 0, out, 64, NULL));
+    ASSERT_FALSE(ring_broadcast_push(&b, data, 1));
+
+    ASSERT_TRUE(ring_broadcast_pop(&b, 1, out, 16, NULL));
+    ASSERT_TRUE(ring_broadcast_push(&b, data, 16));
+    ASSERT_FALSE(ring_broadcast_push(&b, data, 1));
+
+    ring_broadcast_destroy(&b);
+}
+
+TEST(broadcast_lossy_reports_overrun) {
+    ring_broadcast_t b;
+    ASSERT_TRUE(ring_broadcast_init(&b, 64, test_storage, 2, RING_BROADCAST_LOSSY));
+
+    uint8_t msg[16], out[16];
+    size_t lost = 0;
+
+    /* Reader 0 keeps up, reader 1 does not read at all */
+    for (int i = 0; i < 10; i++) {
+        memset(msg, i, sizeof(msg));
+        ASSERT_TRUE(ring_broadcast_push(&b, msg, 16));
+        ASSERT_TRUE(ring_broadcast_pop(&b, 0, out, 16, &lost));
+        ASSERT_EQ(lost, 0);
+        ASSERT_EQ(out[0], i);
+    }
+
+    /* 160 bytes written into a 64-byte ring: reader 1 was lapped */
+    ASSERT_EQ(ring_broadcast_lag(&b, 1), 160);
+    ASSERT_FALSE(ring_broadcast_pop(&b, 1, out, 16, &lost));
+    ASSERT_EQ(lost, 160);
+    ASSERT_EQ(ring_broadcast_lag(&b, 1), 0);
+
+    /* Back in sync from the live edge */
+    memset(msg, 99, sizeof(msg));
+    ASSERT_TRUE(ring_broadcast_push(&b, msg, 16));
+    ASSERT_TRUE(ring_broadcast_pop(&b, 1, out, 16, &lost));
+    ASSERT_EQ(lost, 0);
+    ASSERT_EQ(out[0], 99);
+
+    ASSERT_FALSE(ring_broadcast_push(&b, msg, 65));
+    ring_broadcast_destroy(&b);
+}
+
+TEST(broadcast_rejects_bad_reader_count) {
+    ring_broadcast_t b;
+    ASSERT_FALSE(ring_broadcast_init(&b, 64, NULL, 0, RING_BROADCAST_BLOCKING));
+    ASSERT_FALSE(ring_broadcast_init(&b, 64, NULL, RING_BROADCAST_MAX_READERS + 1,
+                                     RING_BROADCAST_BLOCKING));
+}
+
+/* ============ Wait Strategies ============ */
+
+TEST(wait_push_pop_without_contention) {
+    ring_wait_strategy_t strategies[] = {
+        RING_WAIT_SPIN, RING_WAIT_PAUSE, RING_WAIT_YIELD, RING_WAIT_FUTEX
+    };
+
+    for (size_t s = 0; s < 4; s++) {
+        ring_buffer_t rb;
+        ring_wait_t w;
+        init_buffer(&rb);
+        ring_wait_init(&w, strategies[s], RING_WAIT_DEFAULT_SPINS);
+
+        uint8_t data[] = {9, 8, 7}, out[3];
+        ASSERT_TRUE(ring_push_wait(&rb, &w, data, 3));
+        ASSERT_TRUE(ring_pop_wait(&rb, &w, out, 3));
+        ASSERT_EQ(memcmp(out, data, 3), 0);
+    }
+}
+
+TEST(wait_rejects_impossible_length) {
+    ring_buffer_t rb;
+    ring_wait_t w;
+    init_buffer(&rb);
+    ring_wait_init(&w, RING_WAIT_FUTEX, 0);
+
+    uint8_t data[BUFFER_SIZE + 1];
+    ASSERT_FALSE(ring_push_wait(&rb, &w, data, BUFFER_SIZE + 1));
+    ASSERT_FALSE(ring_pop_wait(&rb, &w, data, BUFFER_SIZE + 1));
+}
+
+/* ============ Shared Memory ============ */
+
+static void shm_test_name(char *name, size_t size) {
+    snprintf(name, size, "/ring_test_unit_%d", (int)getpid());
+}
+
+TEST(shm_create_attach_roundtrip) {
+    char name[64];
+    shm_test_name(name, sizeof(name));
+    ring_shm_unlink(name);
+
+    ring_shm_t producer, consumer;
+    ASSERT_TRUE(ring_shm_create(&producer, name, 4096));
+    ASSERT_FALSE(ring_shm_create(&consumer, name, 4096));   /* Already exists */
+    ASSERT_TRUE(ring_shm_attach(&consumer, name));
+    ASSERT_EQ(consumer.capacity, 4096);
+
+    /* Two mappings of the same segment */
+    ASSERT_TRUE(producer.data != consumer.data);
+
+    uint8_t data[100], out[100];
+    for (int i = 0; i < 100; i++) data[i] = (uint8_t)(i ^ 0x5A);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(ring_shm_push(&producer, data, 100));
+        ASSERT_TRUE(ring_shm_pop(&consumer, out, 100));
+        ASSERT_EQ(memcmp(out, data, 100), 0);
+    }
+    ASSERT_FALSE(ring_shm_pop(&consumer, out, 1));
+
+    ring_shm_detach(&producer);
+    ring_shm_detach(&consumer);
+    ASSERT_TRUE(ring_shm_unlink(name));
+}
+
+TEST(shm_attach_rejects_bad_header) {
+    char name[64];
+    shm_test_name(name, sizeof(name));
+    ring_shm_unlink(name);
+
+    ring_shm_t s, other;
+    ASSERT_FALSE(ring_shm_attach(&other, name));         /* Missing */
+    ASSERT_FALSE(ring_shm_create(&s, name, 1000));       /* Not a power of two */
+
+    ASSERT_TRUE(ring_shm_create(&s, name, 64));
+    s.hdr->version = RING_SHM_VERSION + 1;
+    ASSERT_FALSE(ring_shm_attach(&other, name));
+    s.hdr->version = RING_SHM_VERSION;
+    atomic_store(&s.hdr->magic, 0);
+    ASSERT_FALSE(ring_shm_attach(&other, name));
+
+    ring_shm_detach(&s);
+    ring_shm_unlink(name);
+}
+
+TEST(shm_role_takeover_from_dead_owner) {
+    char name[64];
+    shm_test_name(name, sizeof(name));
+    ring_shm_unlink(name);
+
+    ring_shm_t s;
+    ASSERT_TRUE(ring_shm_create(&s, name, 64));
+
+    /* A child claims the producer role, publishes one message, and dies
+     * without detaching, leaving unpublished bytes after it */
+    pid_t child = fork();
+    if (child == 0) {
+        ring_shm_t c;
+        if (!ring_shm_attach(&c, name) || !ring_shm_claim(&c, RING_SHM_PRODUCER)) _exit(1);
+        uint8_t msg[4] = {1, 2, 3, 4};
+        ring_shm_push(&c, msg, 4);
+        memset(c.data + 4, 0xEE, 8);    /* Half-written, never published */
+        _exit(0);
+    }
+    int status;
+    waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    ASSERT_EQ(atomic_load(&s.hdr->producer_pid), child);
+
+    /* A role held by a live process can't be taken... */
+    atomic_store(&s.hdr->consumer_pid, (int)getppid());
+    ASSERT_FALSE(ring_shm_claim(&s, RING_SHM_CONSUMER));
+    atomic_store(&s.hdr->consumer_pid, 0);
+
+    /* ...but the dead producer's can */
+    ASSERT_TRUE(ring_shm_claim(&s, RING_SHM_PRODUCER));
+    ASSERT_TRUE(ring_shm_claim(&s, RING_SHM_CONSUMER));
+
+    uint8_t msg[4] = {5, 6, 7, 8}, out[8];
+    ASSERT_TRUE(ring_shm_push(&s, msg, 4));
+    ASSERT_TRUE(ring_shm_pop(&s, out, 8));
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(out[i], i + 1);
+    }
+
+    ring_shm_detach(&s);
+    ring_shm_unlink(name);
+}
+
+/* ============ Mirrored Ring ============ */
+
+TEST(mirrored_init_requires_page_multiple) {
+    ring_buffer_t rb;
+    ASSERT_FALSE(ring_init_mirrored(&rb, 64));
+    ASSERT_FALSE(ring_init_mirrored(&rb, 3 * 4096));
+}
+
+TEST(mirrored_halves_alias) {
+    size_t capacity = (size_t)sysconf(_SC_PAGESIZE) * 4;
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init_mirrored(&rb, capacity));
+    ASSERT_TRUE(rb.mirrored);
+
+    rb.data[5] = 0x77;
+    ASSERT_EQ(rb.data[capacity + 5], 0x77);
+    rb.data[capacity + 9] = 0x88;
+    ASSERT_EQ(rb.data[9], 0x88);
+
+    ring_destroy(&rb);
+}
+
+TEST(mirrored_wrap_is_single_span) {
+    size_t capacity = (size_t)sysconf(_SC_PAGESIZE);
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init_mirrored(&rb, capacity));
+
+    uint8_t *fill = calloc(1, capacity);
+    ASSERT_TRUE(ring_push(&rb, fill, capacity - 10));
+    ASSERT_TRUE(ring_pop(&rb, fill, capacity - 10));
+    free(fill);
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_reserve(&rb, 30, &span));
+    ASSERT_EQ(span.first_len, 30);
+    ASSERT_TRUE(span.second == NULL);
+    ASSERT_TRUE(ring_reserve_contiguous(&rb, 30) == span.first);
+    for (int i = 0; i < 30; i++) span.first[i] = (uint8_t)(i + 1);
+    ring_commit(&rb, 30);
+
+    /* The bytes past the wrap landed at the start of the region */
+    ASSERT_EQ(rb.data[0], 11);
+
+    ASSERT_TRUE(ring_peek(&rb, 30, &span));
+    ASSERT_EQ(span.first_len, 30);
+    ASSERT_TRUE(span.second == NULL);
+
+    uint8_t out[30];
+    ASSERT_TRUE(ring_pop(&rb, out, 30));
+    for (int i = 0; i < 30; i++) {
+        ASSERT_EQ(out[i], i + 1);
+    }
+
+    ring_destroy(&rb);
+}
+
+TEST(mirrored_framed_needs_no_padding) {
+    size_t capacity = (size_t)sysconf(_SC_PAGESIZE);
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init_mirrored(&rb, capacity));
+
+    uint8_t *fill = calloc(1, capacity);
+    size_t len;
+    ASSERT_TRUE(ring_push_msg(&rb, fill, capacity - 16 - RING_MSG_HEADER));
+    ASSERT_TRUE(ring_pop_msg(&rb, fill, capacity, &len));
+    free(fill);
+
+    /* Would need padding on a plain ring; here the frame just wraps */
+    uint8_t src[40] = {1, 2, 3};
+    ASSERT_TRUE(ring_push_msg_contiguous(&rb, src, 40));
+    ring_span_t span;
+    ASSERT_TRUE(ring_peek_msg(&rb, &span));
+    ASSERT_TRUE(span.first == rb.data + capacity - 16 + RING_MSG_HEADER);
+    ASSERT_EQ(span.first_len, 40);
+    ASSERT_TRUE(span.second == NULL);
+    ASSERT_EQ(memcmp(span.first, src, 40), 0);
+
+    ring_destroy(&rb);
+}
+
+/* ============ Page-Aware Allocation ============ */
+
+TEST(alloc_opts_rejects_non_page_multiple) {
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = RING_ALLOC_OPTS_DEFAULT;
+    ASSERT_FALSE(ring_init_opts(&rb, 64, &opts));
+    ASSERT_FALSE(ring_init_opts(&rb, 3 * 4096, &opts));
+
+    /* Smaller than one huge page can't be backed by huge pages */
+    opts.pages = RING_PAGES_HUGE_2M;
+    ASSERT_FALSE(ring_init_opts(&rb, (size_t)1 << 20, &opts));
+}
+
+TEST(alloc_opts_default_pages) {
+    size_t capacity = 16 * (size_t)sysconf(_SC_PAGESIZE);
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = RING_ALLOC_OPTS_DEFAULT;
+    ASSERT_TRUE(ring_init_opts(&rb, capacity, &opts));
+    ASSERT_EQ(rb.capacity, capacity);
+    ASSERT_FALSE(rb.mirrored);
+
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < 100; i++) src[i] = (uint8_t)i;
+    for (int lap = 0; lap < 1000; lap++) {
+        ASSERT_TRUE(ring_push(&rb, src, 100));
+        ASSERT_TRUE(ring_pop(&rb, dst, 100));
+    }
+    ASSERT_EQ(memcmp(src, dst, 100), 0);
+
+    ring_destroy(&rb);
+    ASSERT_TRUE(rb.data == NULL);
+}
+
+TEST(alloc_opts_transparent_huge_pages) {
+    size_t capacity = (size_t)4 << 20;
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = { RING_PAGES_THP, -1, true };
+    ASSERT_TRUE(ring_init_opts(&rb, capacity, &opts));
+
+    uint8_t src[8] = {1, 2, 3, 4, 5, 6, 7, 8}, dst[8];
+    ASSERT_TRUE(ring_push(&rb, src, 8));
+    ASSERT_TRUE(ring_pop(&rb, dst, 8));
+    ASSERT_EQ(memcmp(src, dst, 8), 0);
+
+    ring_destroy(&rb);
+}
+
+TEST(alloc_opts_hugetlb_fails_cleanly) {
+    /* Needs reserved hugetlb pages; either works or fails without side effects */
+    size_t capacity = (size_t)2 << 20;
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = { RING_PAGES_HUGE_2M, -1, true };
+    if (ring_init_opts(&rb, capacity, &opts)) {
+        uint8_t byte = 42;
+        ASSERT_TRUE(ring_push(&rb, &byte, 1));
+        ASSERT_TRUE(ring_pop(&rb, &byte, 1));
+        ASSERT_EQ(byte, 42);
+        ring_destroy(&rb);
+    }
+}
+
+TEST(alloc_opts_numa_bind) {
+    size_t capacity = 16 * (size_t)sysconf(_SC_PAGESIZE);
+    ring_buffer_t rb;
+    ring_alloc_opts_t opts = { RING_PAGES_DEFAULT, 0, true };
+
+    /* Node 0 exists wherever mbind() does; other builds refuse to bind */
+    if (ring_init_opts(&rb, capacity, &opts)) {
+        uint8_t byte = 7;
+        ASSERT_TRUE(ring_push(&rb, &byte, 1));
+        ASSERT_TRUE(ring_pop(&rb, &byte, 1));
+        ASSERT_EQ(byte, 7);
+        ring_destroy(&rb);
+    }
+
+    opts.numa_node = 100000;
+    ASSERT_FALSE(ring_init_opts(&rb, capacity, &opts));
+}
+
+/* ============ Typed Rings ============ */
+
+typedef struct {
+    uint64_t id;
+    uint32_t qty;
+    uint8_t side;
+} test_event_t;
+
+RING_DEFINE(test_event_ring, test_event_t, 8)
+
+static test_event_ring_t typed_ring;
+
+TEST(typed_ring_fifo_order) {
+    test_event_ring_init(&typed_ring);
+
+    test_event_t out;
+    ASSERT_FALSE(test_event_ring_pop(&typed_ring, &out));
+
+    for (uint64_t i = 0; i < 5; i++) {
+        test_event_t ev = { i, (uint32_t)(i * 10), (uint8_t)(i & 1) };
+        ASSERT_TRUE(test_event_ring_push(&typed_ring, &ev));
+    }
+    for (uint64_t i = 0; i < 5; i++) {
+        ASSERT_TRUE(test_event_ring_pop(&typed_ring, &out));
+        ASSERT_EQ(out.id, i);
+        ASSERT_EQ(out.qty, i * 10);
+        ASSERT_EQ(out.side, i & 1);
+    }
+    ASSERT_FALSE(test_event_ring_pop(&typed_ring, &out));
+}
+
+TEST(typed_ring_full_at_capacity) {
+    test_event_ring_init(&typed_ring);
+
+    test_event_t ev = {0};
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(test_event_ring_push(&typed_ring, &ev));
+    }
+    ASSERT_FALSE(test_event_ring_push(&typed_ring, &ev));
+
+    ASSERT_TRUE(test_event_ring_pop(&typed_ring, &ev));
+    ASSERT_TRUE(test_event_ring_push(&typed_ring, &ev));
+}
+
+TEST(typed_ring_wraparound) {
+    test_event_ring_init(&typed_ring);
+
+    test_event_t ev, out;
+    for (uint64_t i = 0; i < 100; i++) {
+        ev.id = i;
+        ASSERT_TRUE(test_event_ring_push(&typed_ring, &ev));
+        if (i % 3 == 2) {
+            ASSERT_TRUE(test_event_ring_push(&typed_ring, &ev));
+            ASSERT_TRUE(test_event_ring_pop(&typed_ring, &out));
+        }
+        ASSERT_TRUE(test_event_ring_pop(&typed_ring, &out));
+    }
+    ASSERT_FALSE(test_event_ring_pop(&typed_ring, &out));
+}
+
+/* ============ Instrumentation ============ */
+
+TEST(stats_count_ops_failures_and_bytes) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t data[BUFFER_SIZE + 1] = {0};
+    ASSERT_TRUE(ring_push(&rb, data, 100));
+    ASSERT_FALSE(ring_push(&rb, data, BUFFER_SIZE + 1));
+    ASSERT_FALSE(ring_pop(&rb, data, 200));
+    ASSERT_TRUE(ring_pop(&rb, data, 60));
+    ASSERT_TRUE(ring_pop(&rb, data, 40));
+
+    ring_stats_t st;
+#ifdef RING_STATS
+    ASSERT_TRUE(ring_stats_snapshot(&rb, &st));
+    ASSERT_EQ(st.producer.ops, 1);
+    ASSERT_EQ(st.producer.failed, 1);
+    ASSERT_EQ(st.producer.bytes, 100);
+    ASSERT_EQ(st.consumer.ops, 2);
+    ASSERT_EQ(st.consumer.failed, 1);
+    ASSERT_EQ(st.consumer.bytes, 100);
+#else
+    ASSERT_FALSE(ring_stats_snapshot(&rb, &st));
+    ASSERT_EQ(st.producer.ops, 0);
+#endif
+}
+
+TEST(stats_high_water_and_occupancy) {
+#ifdef RING_STATS
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    /* Fill in eighths: publishes land in buckets 1..7, the full ring in 7 */
+    uint8_t data[BUFFER_SIZE / 8] = {0};
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(ring_push(&rb, data, sizeof(data)));
+    }
+
+    ring_stats_t st;
+    ASSERT_TRUE(ring_stats_snapshot(&rb, &st));
+    ASSERT_EQ(st.producer.high_water, BUFFER_SIZE);
+    ASSERT_EQ(st.producer.occupancy[0], 0);
+    for (int b = 1; b < RING_STATS_BUCKETS - 1; b++) {
+        ASSERT_EQ(st.producer.occupancy[b], 1);
+    }
+    ASSERT_EQ(st.producer.occupancy[RING_STATS_BUCKETS - 1], 2);
+
+    /* Draining to empty: the consumer's last publish lands in bucket 0 */
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(ring_pop(&rb, data, sizeof(data)));
+    }
+    ASSERT_TRUE(ring_stats_snapshot(&rb, &st));
+    ASSERT_EQ(st.consumer.ops, 8);
+    ASSERT_EQ(st.consumer.high_water, BUFFER_SIZE - sizeof(data));
+    ASSERT_EQ(st.consumer.occupancy[0], 1);
+#endif
+}
+
+TEST(stats_cover_batch_zero_copy_and_framing) {
+#ifdef RING_STATS
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t a[10] = {0}, b[20] = {0};
+    ring_iovec_t iov[2] = { { a, sizeof(a) }, { b, sizeof(b) } };
+    ASSERT_EQ(ring_push_batch(&rb, iov, 2), 2);
+    ASSERT_EQ(ring_pop_batch(&rb, iov, 2), 2);
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_reserve(&rb, 16, &span));
+    ring_commit(&rb, 16);
+    ASSERT_TRUE(ring_peek(&rb, 16, &span));
+    ring_release(&rb, 16);
+
+    size_t len;
+    ASSERT_TRUE(ring_push_msg(&rb, a, 5));
+    ASSERT_FALSE(ring_pop_msg(&rb, b, 2, &len));
+    ASSERT_TRUE(ring_pop_msg(&rb, b, sizeof(b), &len));
+
+    ring_stats_t st;
+    ASSERT_TRUE(ring_stats_snapshot(&rb, &st));
+    ASSERT_EQ(st.producer.ops, 3);
+    ASSERT_EQ(st.producer.bytes, 30 + 16 + 5);
+    ASSERT_EQ(st.consumer.ops, 3);
+    ASSERT_EQ(st.consumer.failed, 1);
+    ASSERT_EQ(st.consumer.bytes, 30 + 16 + 5);
+#endif
+}
+
+/* ============ Latency Histogram ============ */
+
+static ring_hist_t test_hist, test_hist_other;
+
+TEST(hist_small_values_are_exact) {
+    ring_hist_init(&test_hist);
+    ASSERT_EQ(ring_hist_percentile(&test_hist, 50.0), 0);
+    ASSERT_EQ(ring_hist_min(&test_hist), 0);
+
+    for (uint64_t v = 1; v <= 100; v++) ring_hist_record(&test_hist, v);
+
+    ASSERT_EQ(ring_hist_count(&test_hist), 100);
+    ASSERT_EQ(ring_hist_min(&test_hist), 1);
+    ASSERT_EQ(ring_hist_max(&test_hist), 100);
+    ASSERT_EQ(ring_hist_percentile(&test_hist, 50.0), 50);
+    ASSERT_EQ(ring_hist_percentile(&test_hist, 99.0), 99);
+    ASSERT_EQ(ring_hist_percentile(&test_hist, 100.0), 100);
+    ASSERT_TRUE(ring_hist_mean(&test_hist) == 50.5);
+}
+
+TEST(hist_buckets_cover_range_with_bounded_error) {
+    /* Every bucket's range is contiguous with the next and within 1/128 */
+    uint64_t values[] = { 255, 256, 257, 1000, 4095, 4096, 123456789, UINT64_MAX / 3, UINT64_MAX };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint64_t v = values[i];
+        size_t idx = ring_hist_index(v);
+        ASSERT_TRUE(idx < RING_HIST_BUCKETS);
+        uint64_t high = ring_hist_bucket_high(idx);
+        ASSERT_TRUE(high >= v);
+        ASSERT_TRUE(high - v <= v / 128);
+        if (idx > 0) ASSERT_TRUE(ring_hist_bucket_high(idx - 1) < v);
+    }
+    ASSERT_EQ(ring_hist_index(UINT64_MAX), RING_HIST_BUCKETS - 1);
+}
+
+TEST(hist_tail_percentiles) {
+    ring_hist_init(&test_hist);
+
+    /* 999,000 fast samples, 980 slow, 20 very slow */
+    for (int i = 0; i < 999000; i++) ring_hist_record(&test_hist, 200);
+    for (int i = 0; i < 980; i++) ring_hist_record(&test_hist, 50000);
+    for (int i = 0; i < 20; i++) ring_hist_record(&test_hist, 2000000);
+
+    uint64_t p50 = ring_hist_percentile(&test_hist, 50.0);
+    uint64_t p9999 = ring_hist_percentile(&test_hist, 99.99);
+    uint64_t p99999 = ring_hist_percentile(&test_hist, 99.999);
+    ASSERT_EQ(p50, 200);
+    ASSERT_TRUE(p9999 >= 50000 && p9999 <= 50000 + 50000 / 128);
+    ASSERT_EQ(p99999, 2000000);
+    ASSERT_EQ(ring_hist_max(&test_hist), 2000000);
+}
+
+TEST(hist_merge) {
+    ring_hist_init(&test_hist);
+    ring_hist_init(&test_hist_other);
+
+    ring_hist_record(&test_hist, 10);
+    ring_hist_record(&test_hist_other, 5);
+    ring_hist_record(&test_hist_other, 90000);
+    ring_hist_merge(&test_hist, &test_hist_other);
+
+    ASSERT_EQ(ring_hist_count(&test_hist), 3);
+    ASSERT_EQ(ring_hist_min(&test_hist), 5);
+    ASSERT_EQ(ring_hist_max(&test_hist), 90000);
+    ASSERT_EQ(ring_hist_percentile(&test_hist, 50.0), 10);
+}
+
+/* ============ Clock ============ */
+
+TEST(clock_monotonic_fallback) {
+    ring_clock_t c;
+    ASSERT_TRUE(ring_clock_init(&c, RING_CLOCK_MONOTONIC));
+    ASSERT_EQ(c.source, RING_CLOCK_MONOTONIC);
+    ASSERT_EQ(ring_clock_to_ns(&c, 12345), 12345);
+
+    uint64_t a = ring_clock_now(&c);
+    uint64_t b = ring_clock_now_ordered(&c);
+    ASSERT_TRUE(b >= a);
+}
+
+TEST(clock_auto_measures_real_time) {
+    ring_clock_t c;
+    ASSERT_TRUE(ring_clock_init(&c, RING_CLOCK_AUTO));
+    ASSERT_TRUE(c.source != RING_CLOCK_AUTO);
+
+    uint64_t start = ring_clock_now(&c);
+    struct timespec pause = { 0, 20000000 };
+    nanosleep(&pause, NULL);
+    uint64_t elapsed = ring_clock_to_ns(&c, ring_clock_now_ordered(&c) - start);
+
+    /* 20 ms sleep; allow for scheduler slack but catch a bad calibration */
+    ASSERT_TRUE(elapsed >= 15000000);
+    ASSERT_TRUE(elapsed < 500000000);
+}
+
+TEST(clock_cycles_when_available) {
+    ring_clock_t c;
+    if (!ring_clock_init(&c, RING_CLOCK_CYCLES)) {
+        ASSERT_FALSE(ring_clock_has_cycles());
+        ASSERT_EQ(c.source, RING_CLOCK_MONOTONIC);
+        return;
+    }
+    ASSERT_EQ(c.source, RING_CLOCK_CYCLES);
+    ASSERT_TRUE(c.ns_per_tick > 0.01 && c.ns_per_tick < 100.0);
+}
+
+/* ============ Copy Hints ============ */
+
+TEST(stream_push_roundtrip_any_alignment) {
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init(&rb, 4096, NULL));
+
+    static uint8_t src[2100], dst[2100], fill[64];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(i * 7 + 3);
+
+    /* Lengths either side of RING_STREAM_MIN, odd start offsets, and wraps */
+    const size_t lens[] = { 1, 63, RING_STREAM_MIN - 1, RING_STREAM_MIN, 300, 1000, 2049 };
+    const size_t shifts[] = { 0, 1, 17, 63 };
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        for (size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); s++) {
+            ASSERT_TRUE(ring_push(&rb, fill, shifts[s]));
+            ASSERT_TRUE(ring_pop(&rb, fill, shifts[s]));
+
+            memset(dst, 0, sizeof(dst));
+            ASSERT_TRUE(ring_push_hint(&rb, src, lens[l], RING_HINT_STREAM));
+            ASSERT_TRUE(ring_pop(&rb, dst, lens[l]));
+            ASSERT_EQ(memcmp(dst, src, lens[l]), 0);
+        }
+    }
+
+    ring_destroy(&rb);
+}
+
+TEST(prefetch_pop_preserves_data) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < 100; i++) src[i] = (uint8_t)(i + 1);
+
+    /* Enough laps to wrap; sometimes more data is queued, sometimes none */
+    for (int round = 0; round < 40; round++) {
+        ASSERT_TRUE(ring_push(&rb, src, 100));
+        if (round % 2) ASSERT_TRUE(ring_push(&rb, src, 100));
+
+        ASSERT_TRUE(ring_pop_hint(&rb, dst, 100, RING_HINT_PREFETCH));
+        ASSERT_EQ(memcmp(dst, src, 100), 0);
+        if (round % 2) {
+            ASSERT_TRUE(ring_pop_hint(&rb, dst, 100, RING_HINT_PREFETCH));
+            ASSERT_EQ(memcmp(dst, src, 100), 0);
+        }
+    }
+    ASSERT_FALSE(ring_pop_hint(&rb, dst, 1, RING_HINT_PREFETCH));
+}
+
+TEST(ring_hints_apply_to_every_copy_path) {
+    ring_buffer_t rb;
+    ASSERT_TRUE(ring_init(&rb, 4096, NULL));
+    ring_set_hints(&rb, RING_HINT_STREAM | RING_HINT_PREFETCH);
+
+    static uint8_t src[1500], dst[1500];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(i ^ 0x5a);
+
+    for (int round = 0; round < 6; round++) {
+        ASSERT_TRUE(ring_push(&rb, src, sizeof(src)));
+        ASSERT_TRUE(ring_pop(&rb, dst, sizeof(dst)));
+        ASSERT_EQ(memcmp(dst, src, sizeof(src)), 0);
+
+        size_t len;
+        memset(dst, 0, sizeof(dst));
+        ASSERT_TRUE(ring_push_msg(&rb, src, 700));
+        ASSERT_TRUE(ring_pop_msg(&rb, dst, sizeof(dst), &len));
+        ASSERT_EQ(len, 700);
+        ASSERT_EQ(memcmp(dst, src, 700), 0);
+
+        ring_iovec_t in[2] = { { src, 400 }, { src + 400, 500 } };
+        ring_iovec_t out[2] = { { dst, 400 }, { dst + 400, 500 } };
+        memset(dst, 0, sizeof(dst));
+        ASSERT_EQ(ring_push_batch(&rb, in, 2), 2);
+        ASSERT_EQ(ring_pop_batch(&rb, out, 2), 2);
+        ASSERT_EQ(memcmp(dst, src, 900), 0);
+    }
+
+    ring_destroy(&rb);
+    ASSERT_EQ(rb.hints, 0);
+}
+
+/* ============ Copy Kernels ============ */
+
+TEST(copy_kernels_exact_for_any_length_and_alignment) {
+    static uint8_t src[400], dst[400 + 128];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(i * 13 + 1);
+
+    for (size_t k = 0; k < RING_NUM_COPY_KERNELS; k++) {
+        const ring_copy_kernel_t *kernel = &ring_copy_kernels[k];
+        if (!kernel->supported()) continue;
+
+        for (size_t offset = 0; offset < 64; offset += 7) {
+            for (size_t len = 0; len <= 300; len++) {
+                memset(dst, 0xee, sizeof(dst));
+                kernel->copy(dst + offset, src + 1, len);
+                ASSERT_EQ(memcmp(dst + offset, src + 1, len), 0);
+
+                /* Nothing written outside [offset, offset + len) */
+                for (size_t i = 0; i < offset; i++) ASSERT_EQ(dst[i], 0xee);
+                ASSERT_EQ(dst[offset + len], 0xee);
+            }
+        }
+    }
+}
+
+TEST(copy_kernel_best_is_default_and_supported) {
+    const ring_copy_kernel_t *best = ring_copy_kernel_best();
+    ASSERT_TRUE(best->supported());
+    ASSERT_TRUE(ring_copy_kernel_find(best->name) == best);
+    ASSERT_TRUE(ring_copy_kernel_find("memcpy") != NULL);
+    ASSERT_TRUE(ring_copy_kernel_find("no-such-kernel") == NULL);
+
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    ASSERT_TRUE(rb.copy == best->copy);
+    ASSERT_EQ(strcmp(ring_copy_kernel_name(&rb), best->name), 0);
+
+    ASSERT_FALSE(ring_set_copy_kernel(&rb, "no-such-kernel"));
+    ASSERT_TRUE(rb.copy == best->copy);
+    ASSERT_TRUE(ring_set_copy_kernel(&rb, "memcpy"));
+    ASSERT_EQ(strcmp(ring_copy_kernel_name(&rb), "memcpy"), 0);
+}
+
+TEST(every_copy_kernel_survives_wraparound) {
+    uint8_t src[333], dst[333];
+    for (size_t i = 0; i < sizeof(src); i++) src[i] = (uint8_t)(i + 5);
+
+    for (size_t k = 0; k < RING_NUM_COPY_KERNELS; k++) {
+        ring_buffer_t rb;
+        init_buffer(&rb);
+        if (!ring_set_copy_kernel(&rb, ring_copy_kernels[k].name)) continue;
+
+        /* 333 is coprime with 1024, so the split point lands everywhere */
+        for (int round = 0; round < 20; round++) {
+            memset(dst, 0, sizeof(dst));
+            ASSERT_TRUE(ring_push(&rb, src, sizeof(src)));
+            ASSERT_TRUE(ring_pop(&rb, dst, sizeof(dst)));
+            ASSERT_EQ(memcmp(dst, src, sizeof(src)), 0);
+        }
+    }
+}
+
+/* ============ Write Combining ============ */
+
+TEST(staged_pushes_publish_at_byte_threshold) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    ring_set_coalesce(&rb, 16, 0);
+
+    uint8_t b = 0;
+    for (int i = 0; i < 15; i++) {
+        b = (uint8_t)i;
+        ASSERT_TRUE(ring_push_staged(&rb, &b, 1));
+    }
+    ASSERT_EQ(ring_staged(&rb), 15);
+    ASSERT_EQ(ring_used(&rb), 0);
+    ASSERT_FALSE(ring_pop(&rb, &b, 1));
+
+    b = 15;
+    ASSERT_TRUE(ring_push_staged(&rb, &b, 1));
+    ASSERT_EQ(ring_staged(&rb), 0);
+    ASSERT_EQ(ring_used(&rb), 16);
+
+    uint8_t out[16];
+    ASSERT_TRUE(ring_pop(&rb, out, 16));
+    for (int i = 0; i < 16; i++) {
+        ASSERT_EQ(out[i], i);
+    }
+}
+
+TEST(staged_pushes_publish_at_message_count_and_flush) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    ring_set_coalesce(&rb, 0, 4);
+
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (int i = 0; i < 3; i++) ASSERT_TRUE(ring_push_staged(&rb, data, 8));
+    ASSERT_EQ(ring_used(&rb), 0);
+    ASSERT_TRUE(ring_push_staged(&rb, data, 8));
+    ASSERT_EQ(ring_used(&rb), 32);
+
+    ASSERT_TRUE(ring_push_staged(&rb, data, 5));
+    ASSERT_EQ(ring_used(&rb), 32);
+    ring_flush(&rb);
+    ASSERT_EQ(ring_used(&rb), 37);
+    ASSERT_EQ(ring_staged(&rb), 0);
+
+    /* Flushing with nothing staged changes nothing */
+    ring_flush(&rb);
+    ASSERT_EQ(ring_bytes_written(&rb), 37);
+}
+
+TEST(staged_push_that_does_not_fit_publishes_and_wraps) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    ring_set_coalesce(&rb, 0, 0);
+
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < 100; i++) src[i] = (uint8_t)(i * 3);
+
+    /* Move the counters so the staged run crosses the wrap point */
+    ASSERT_TRUE(ring_push(&rb, src, 70));
+    ASSERT_TRUE(ring_pop(&rb, dst, 70));
+
+    size_t pushed = 0;
+    while (ring_push_staged(&rb, src, 100)) pushed++;
+    ASSERT_EQ(pushed, BUFFER_SIZE / 100);
+    ASSERT_EQ(ring_staged(&rb), 0);
+    ASSERT_EQ(ring_used(&rb), pushed * 100);
+
+    for (size_t i = 0; i < pushed; i++) {
+        ASSERT_TRUE(ring_pop(&rb, dst, 100));
+        ASSERT_EQ(memcmp(dst, src, 100), 0);
+    }
+    ASSERT_FALSE(ring_pop(&rb, dst, 1));
+}
+
+/* ============ Draining ============ */
+
+TEST(pop_available_takes_backlog_up_to_cap) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[64], dst[64];
+    for (int i = 0; i < 64; i++) src[i] = (uint8_t)(i + 1);
+    ASSERT_EQ(ring_pop_available(&rb, dst, sizeof(dst)), 0);
+
+    ASSERT_TRUE(ring_push(&rb, src, 10));
+    ASSERT_TRUE(ring_push(&rb, src + 10, 20));
+    ASSERT_EQ(ring_pop_available(&rb, dst, sizeof(dst)), 30);
+    ASSERT_EQ(memcmp(dst, src, 30), 0);
+    ASSERT_EQ(ring_used(&rb), 0);
+
+    ASSERT_TRUE(ring_push(&rb, src, 50));
+    ASSERT_EQ(ring_pop_available(&rb, dst, 20), 20);
+    ASSERT_EQ(ring_pop_available(&rb, dst + 20, 64), 30);
+    ASSERT_EQ(memcmp(dst, src, 50), 0);
+}
+
+TEST(pop_available_across_wrap) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+
+    uint8_t src[200], dst[200];
+    for (int i = 0; i < 200; i++) src[i] = (uint8_t)(i ^ 0x3c);
+
+    uint8_t *fill = calloc(1, BUFFER_SIZE);
+    ASSERT_TRUE(ring_push(&rb, fill, BUFFER_SIZE - 50));
+    ASSERT_TRUE(ring_pop(&rb, fill, BUFFER_SIZE - 50));
+    free(fill);
+
+    ASSERT_TRUE(ring_push(&rb, src, 200));
+    ASSERT_EQ(ring_pop_available(&rb, dst, sizeof(dst)), 200);
+    ASSERT_EQ(memcmp(dst, src, 200), 0);
+}
+
+typedef struct {
+    int calls;
+    size_t first_len;
+    size_t second_len;
+    uint8_t bytes[256];
+} drain_capture_t;
+
+/* Copies the span and consumes whole 8-byte records only */
+static size_t drain_records(const ring_span_t *span, void *ctx) {
+    drain_capture_t *c = (drain_capture_t *)ctx;
+    c->calls++;
+    c->first_len = span->first_len;
+    c->second_len = span->second_len;
+    memcpy(c->bytes, span->first, span->first_len);
+    if (span->second != NULL) memcpy(c->bytes + span->first_len, span->second, span->second_len);
+
+    size_t total = span->first_len + span->second_len;
+    return total - total % 8;
+}
+
+TEST(drain_hands_over_spans_and_keeps_remainder) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    drain_capture_t c = {0};
+
+    /* Empty: callback not called */
+    ASSERT_EQ(ring_drain(&rb, SIZE_MAX, drain_records, &c), 0);
+    ASSERT_EQ(c.calls, 0);
+
+    uint8_t *fill = calloc(1, BUFFER_SIZE);
+    ASSERT_TRUE(ring_push(&rb, fill, BUFFER_SIZE - 20));
+    ASSERT_TRUE(ring_pop(&rb, fill, BUFFER_SIZE - 20));
+    free(fill);
+
+    uint8_t src[45];
+    for (int i = 0; i < 45; i++) src[i] = (uint8_t)(i + 100);
+    ASSERT_TRUE(ring_push(&rb, src, 45));
+
+    /* 45 bytes across the wrap; 40 consumed, 5 left behind */
+    ASSERT_EQ(ring_drain(&rb, SIZE_MAX, drain_records, &c), 40);
+    ASSERT_EQ(c.calls, 1);
+    ASSERT_EQ(c.first_len, 20);
+    ASSERT_EQ(c.second_len, 25);
+    ASSERT_EQ(memcmp(c.bytes, src, 45), 0);
+    ASSERT_EQ(ring_used(&rb), 5);
+
+    /* A cap limits what is offered */
+    ASSERT_TRUE(ring_push(&rb, src, 11));
+    ASSERT_EQ(ring_drain(&rb, 8, drain_records, &c), 8);
+    ASSERT_EQ(c.first_len + c.second_len, 8);
+    ASSERT_EQ(ring_used(&rb), 8);
+}
+
+/* ============ Lossy (Overwrite-Oldest) ============ */
+
+TEST(lossy_push_keeps_order_when_consumer_keeps_up) {
+    ring_lossy_t l;
+    ASSERT_TRUE(ring_lossy_init(&l, 64, test_storage));
+
+    uint8_t msg[16], out[16];
+    size_t lost = 1;
+    ASSERT_FALSE(ring_lossy_pop(&l, out, 16, &lost));
+    ASSERT_EQ(lost, 0);
+
+    /* Many laps of the ring, never more than one message behind */
+    for (int i = 0; i < 100; i++) {
+        memset(msg, i, sizeof(msg));
+        ASSERT_TRUE(ring_lossy_push(&l, msg, 16));
+        ASSERT_TRUE(ring_lossy_pop(&l, out, 16, &lost));
+        ASSERT_EQ(lost, 0);
+        ASSERT_EQ(out[0], i);
+        ASSERT_EQ(out[15], i);
+    }
+    ASSERT_EQ(ring_lossy_lost(&l), 0);
+
+    uint8_t big[65] = {0};
+    ASSERT_TRUE(ring_lossy_push(&l, big, 64));
+    ASSERT_FALSE(ring_lossy_push(&l, big, 65));
+    ring_lossy_destroy(&l);
+}
+
+TEST(lossy_lapped_consumer_skips_to_live_edge) {
+    ring_lossy_t l;
+    ASSERT_TRUE(ring_lossy_init(&l, 64, test_storage));
+
+    uint8_t msg[16], out[16];
+    size_t lost = 0;
+
+    /* 160 bytes into a 64-byte ring with nobody reading: every push succeeds */
+    for (int i = 0; i < 10; i++) {
+        memset(msg, i, sizeof(msg));
+        ASSERT_TRUE(ring_lossy_push(&l, msg, 16));
+    }
+    ASSERT_EQ(ring_lossy_lag(&l), 160);
+
+    ASSERT_FALSE(ring_lossy_pop(&l, out, 16, &lost));
+    ASSERT_EQ(lost, 160);
+    ASSERT_EQ(ring_lossy_lag(&l), 0);
+    ASSERT_EQ(ring_lossy_lost(&l), 160);
+
+    memset(msg, 99, sizeof(msg));
+    ASSERT_TRUE(ring_lossy_push(&l, msg, 16));
+    ASSERT_TRUE(ring_lossy_pop(&l, out, 16, &lost));
+    ASSERT_EQ(lost, 0);
+    ASSERT_EQ(out[0], 99);
+    ASSERT_EQ(ring_lossy_lost(&l), 160);
+    ring_lossy_destroy(&l);
+}
+
+TEST(lossy_pop_detects_overwrite_during_copy) {
+    ring_lossy_t l;
+    ASSERT_TRUE(ring_lossy_init(&l, 64, test_storage));
+
+    uint8_t msg[16] = {0}, out[16];
+    size_t lost = 0;
+    ASSERT_TRUE(ring_lossy_push(&l, msg, 16));
+    ASSERT_TRUE(ring_lossy_push(&l, msg, 16));
+
+    /* As if the producer had claimed the next 64 bytes, wrapping onto the
+     * unread data, while the consumer was copying */
+    atomic_store(&l.claim, 32 + 64);
+    ASSERT_FALSE(ring_lossy_pop(&l, out, 16, &lost));
+    ASSERT_EQ(lost, 32);
+    ASSERT_EQ(ring_lossy_lag(&l), 0);
+    ring_lossy_destroy(&l);
+}
+
+TEST(lossy_records_rejected_when_capacity_below_header) {
+    ring_lossy_t l;
+    uint8_t rec[100] = {0};
+
+    /* Too small for even an empty record; raw pushes still work */
+    ASSERT_TRUE(ring_lossy_init(&l, 2, NULL));
+    ASSERT_FALSE(ring_lossy_push_msg(&l, rec, 0));
+    ASSERT_FALSE(ring_lossy_push_msg(&l, rec, sizeof(rec)));
+    ASSERT_TRUE(ring_lossy_push(&l, rec, 2));
+    ring_lossy_destroy(&l);
+
+    /* Exactly a header: only empty records fit */
+    ASSERT_TRUE(ring_lossy_init(&l, RING_LOSSY_HEADER, NULL));
+    ASSERT_FALSE(ring_lossy_push_msg(&l, rec, 1));
+    ASSERT_TRUE(ring_lossy_push_msg(&l, rec, 0));
+    ring_lossy_destroy(&l);
+}
+
+TEST(lossy_records_resume_on_record_boundary) {
+    ring_lossy_t l;
+    ASSERT_TRUE(ring_lossy_init(&l, 128, test_storage));
+
+    char rec[128] = {0}, out[64];
+    size_t len = 0, lost = 0;
+
+    /* Variable-length records, read back whole across the wrap */
+    for (size_t i = 1; i <= 40; i++) {
+        memset(rec, (int)i, i);
+        ASSERT_TRUE(ring_lossy_push_msg(&l, rec, i));
+        ASSERT_TRUE(ring_lossy_pop_msg(&l, out, sizeof(out), &len, &lost));
+        ASSERT_EQ(len, i);
+        ASSERT_EQ(lost, 0);
+        ASSERT_EQ(out[0], (char)i);
+        ASSERT_EQ(out[i - 1], (char)i);
+    }
+
+    /* Too big for the caller's buffer: left in place */
+    memset(rec, 7, 40);
+    ASSERT_TRUE(ring_lossy_push_msg(&l, rec, 40));
+    ASSERT_FALSE(ring_lossy_pop_msg(&l, out, 16, &len, &lost));
+    ASSERT_EQ(len, 40);
+    ASSERT_EQ(lost, 0);
+    ASSERT_TRUE(ring_lossy_pop_msg(&l, out, sizeof(out), &len, &lost));
+    ASSERT_EQ(len, 40);
+
+    /* Lapped: skip everything, then read the next whole record */
+    for (int i = 0; i < 10; i++) ASSERT_TRUE(ring_lossy_push_msg(&l, rec, 30));
+    ASSERT_FALSE(ring_lossy_pop_msg(&l, out, sizeof(out), &len, &lost));
+    ASSERT_EQ(lost, 10 * (RING_LOSSY_HEADER + 30));
+
+    memset(rec, 42, 5);
+    ASSERT_TRUE(ring_lossy_push_msg(&l, rec, 5));
+    ASSERT_TRUE(ring_lossy_pop_msg(&l, out, sizeof(out), &len, &lost));
+    ASSERT_EQ(len, 5);
+    ASSERT_EQ(out[4], 42);
+
+    ASSERT_TRUE(ring_lossy_push_msg(&l, rec, 128 - RING_LOSSY_HEADER));
+    ASSERT_FALSE(ring_lossy_push_msg(&l, rec, 128 - RING_LOSSY_HEADER + 1));
+    ring_lossy_destroy(&l);
+}
+
+/* ============ Async Logger ============ */
+
+static ring_log_t test_log;
+
+/* Decode `f` from the start into a heap string; *ok is the decoder's verdict */
+static char *decode_log(FILE *f, bool *ok) {
+    char *text = NULL;
+    size_t len = 0;
+    FILE *out = open_memstream(&text, &len);
+    rewind(f);
+    *ok = ring_log_decode(f, out);
+    fclose(out);
+    return text;
+}
+
+TEST(log_format_parsing) {
+    ring_log_format_t f;
+
+    ASSERT_TRUE(ring_log_parse_format("no args, 100%% sure", &f));
+    ASSERT_EQ(f.num_args, 0);
+    ASSERT_EQ(f.fixed, RING_LOG_RECORD_HEADER);
+
+    ASSERT_TRUE(ring_log_parse_format("%d %-8u %hhx %ld %llu %zu %jd %td %5.2f %lf %c %s %p", &f));
+    ASSERT_EQ(f.num_args, 13);
+    ASSERT_EQ(f.args[0], RING_LOG_ARG_INT);
+    ASSERT_EQ(f.args[2], RING_LOG_ARG_INT);
+    ASSERT_EQ(f.args[3], RING_LOG_ARG_LONG);
+    ASSERT_EQ(f.args[5], RING_LOG_ARG_SIZE);
+    ASSERT_EQ(f.args[9], RING_LOG_ARG_DOUBLE);
+    ASSERT_EQ(f.args[11], RING_LOG_ARG_STR);
+    ASSERT_EQ(f.args[12], RING_LOG_ARG_PTR);
+    ASSERT_EQ(f.fixed, RING_LOG_RECORD_HEADER + 4 * 4 + 8 * 8 + 2);
+
+    ASSERT_FALSE(ring_log_parse_format("%n", &f));
+    ASSERT_FALSE(ring_log_parse_format("%*d", &f));
+    ASSERT_FALSE(ring_log_parse_format("%Lf", &f));
+    ASSERT_FALSE(ring_log_parse_format("%ls", &f));
+    ASSERT_FALSE(ring_log_parse_format("trailing %", &f));
+    ASSERT_FALSE(ring_log_parse_format("%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d%d", &f));
+}
+
+TEST(log_round_trip_matches_printf) {
+    FILE *f = tmpfile();
+    ASSERT_TRUE(f != NULL);
+    ASSERT_FALSE(ring_log_open(&test_log, fileno(f), 1000));
+    ASSERT_TRUE(ring_log_open(&test_log, fileno(f), 4096));
+
+    const char *fmt = "order %d qty %zu px %.2f side %s flags %#x %hhd %lld%% %-4c|";
+    int id = ring_log_format(&test_log, fmt);
+    ASSERT_EQ(id, 0);
+    ASSERT_EQ(ring_log_format(&test_log, "bad %n"), -1);
+
+    ring_log_writer_t *w = ring_log_writer(&test_log);
+    ASSERT_TRUE(w != NULL);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(ring_log(w, id, -i, (size_t)1 << (40 + i), 1.25 * i, i ? "sell" : "buy",
+                             0xab + i, -1 - i, -1234567890123LL * i, 'A' + i));
+    }
+    ASSERT_TRUE(ring_log_close(&test_log));
+
+    bool ok;
+    char *text = decode_log(f, &ok);
+    ASSERT_TRUE(ok);
+
+    char *line = text;
+    for (int i = 0; i < 3; i++) {
+        char expect[256];
+        snprintf(expect, sizeof(expect), fmt, -i, (size_t)1 << (40 + i), 1.25 * i,
+                 i ? "sell" : "buy", 0xab + i, -1 - i, -1234567890123LL * i, 'A' + i);
+
+        char *msg = strstr(line, "] w0 ");
+        ASSERT_TRUE(msg != NULL);
+        msg += strlen("] w0 ");
+        char *nl = strchr(msg, '\n');
+        ASSERT_TRUE(nl != NULL);
+        ASSERT_EQ((size_t)(nl - msg), strlen(expect));
+        ASSERT_EQ(memcmp(msg, expect, strlen(expect)), 0);
+        line = nl + 1;
+    }
+    ASSERT_EQ(*line, '\0');
+
+    free(text);
+    fclose(f);
+}
+
+TEST(log_long_strings_truncate_to_record_limit) {
+    FILE *f = tmpfile();
+    ASSERT_TRUE(ring_log_open(&test_log, fileno(f), 4096));
+    int id = ring_log_format(&test_log, "%d:%s:%s");
+    ring_log_writer_t *w = ring_log_writer(&test_log);
+
+    char big[2000];
+    memset(big, 'z', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    ASSERT_TRUE(ring_log(w, id, 7, big, big));
+    ASSERT_TRUE(ring_log(w, id, 8, NULL, "ok"));
+    ASSERT_EQ(ring_bytes_written(&w->ring), RING_LOG_MAX_RECORD + RING_LOG_RECORD_HEADER + 4 + 2 + 6 + 2 + 2);
+    ASSERT_TRUE(ring_log_close(&test_log));
+
+    bool ok;
+    char *text = decode_log(f, &ok);
+    ASSERT_TRUE(ok);
+    char *second = strchr(text, '\n') + 1;
+    ASSERT_TRUE(strstr(second, "w0 8:(null):ok\n") != NULL);
+
+    /* First record: both strings share what's left of the 512-byte record */
+    size_t zs = 0;
+    for (char *p = text; p < second; p++) zs += *p == 'z';
+    ASSERT_EQ(zs, RING_LOG_MAX_RECORD - RING_LOG_RECORD_HEADER - 4 - 2 - 2);
+
+    free(text);
+    fclose(f);
+}
+
+TEST(log_rejects_unregistered_format) {
+    FILE *f = tmpfile();
+    ASSERT_TRUE(ring_log_open(&test_log, fileno(f), 4096));
+    int bad = ring_log_format(&test_log, "%n");
+    ASSERT_EQ(bad, -1);
+    int id = ring_log_format(&test_log, "tick %u");
+    ring_log_writer_t *w = ring_log_writer(&test_log);
+
+    /* Neither written nor counted as a drop */
+    ASSERT_FALSE(ring_log(w, bad, 1u));
+    ASSERT_FALSE(ring_log(w, id + 1, 1u));
+    ASSERT_EQ(ring_bytes_written(&w->ring), 0);
+    ASSERT_EQ(ring_log_dropped(&test_log), 0);
+    ASSERT_TRUE(ring_log(w, id, 1u));
+    ASSERT_TRUE(ring_log_close(&test_log));
+    fclose(f);
+}
+
+TEST(log_decode_reports_truncated_file) {
+    FILE *f = tmpfile();
+    ASSERT_TRUE(ring_log_open(&test_log, fileno(f), 4096));
+    int id = ring_log_format(&test_log, "tick %u");
+    ring_log_writer_t *w = ring_log_writer(&test_log);
+    ASSERT_TRUE(ring_log(w, id, 1u));
+    ring_log_flush(&test_log);
+    ASSERT_TRUE(ring_log(w, id, 2u));
+    ASSERT_TRUE(ring_log_close(&test_log));
+
+    long size = ftell(f);
+    uint8_t *bytes = malloc((size_t)size);
+    rewind(f);
+    ASSERT_EQ(fread(bytes, 1, (size_t)size, f), (size_t)size);
+    fclose(f);
+
+    /* A crash mid-write: the last block is cut short */
+    FILE *cut = fmemopen(bytes, (size_t)size - 3, "rb");
+    bool ok;
+    char *text = decode_log(cut, &ok);
+    ASSERT_FALSE(ok);
+    ASSERT_TRUE(strstr(text, "tick 1\n") != NULL);
+    ASSERT_TRUE(strstr(text, "tick 2") == NULL);
+    free(text);
+    fclose(cut);
+
+    /* Not a log at all */
+    memset(bytes, 0, sizeof(ring_log_file_header_t));
+    cut = fmemopen(bytes, (size_t)size, "rb");
+    text = decode_log(cut, &ok);
+    ASSERT_FALSE(ok);
+    free(text);
+    fclose(cut);
+    free(bytes);
+}
+
+TEST(log_decode_rejects_corrupt_blocks) {
+    struct {
+        ring_log_file_header_t hdr;
+        ring_log_block_t block;
+        char payload[4];
+    } file = { { RING_LOG_MAGIC, RING_LOG_VERSION, 0, 1.0 }, { RING_LOG_DEFINE, 4, 0 }, "x %u" };
+    bool ok;
+
+    /* Format ids past the registration limit, up to the one that wraps id + 1 */
+    uint32_t bad_ids[] = { RING_LOG_MAX_FORMATS, UINT32_MAX };
+    for (size_t i = 0; i < 2; i++) {
+        file.block.id = bad_ids[i];
+        FILE *f = fmemopen(&file, sizeof(file), "rb");
+        free(decode_log(f, &ok));
+        ASSERT_FALSE(ok);
+        fclose(f);
+    }
+
+    /* A block claiming more payload than any writer's ring can hold */
+    file.block.id = 0;
+    file.block.len = UINT32_MAX;
+    FILE *f = fmemopen(&file, sizeof(file), "rb");
+    free(decode_log(f, &ok));
+    ASSERT_FALSE(ok);
+    fclose(f);
+
+    /* The same block, intact, decodes */
+    file.block.len = 4;
+    f = fmemopen(&file, sizeof(file), "rb");
+    free(decode_log(f, &ok));
+    ASSERT_TRUE(ok);
+    fclose(f);
+}
+
+/* ============ File Descriptor Sink ============ */
+
+/* Ring wrapped so that `len` pushed bytes straddle the end */
+static void push_wrapped(ring_buffer_t *rb, const uint8_t *src, size_t len) {
+    uint8_t *fill = calloc(1, rb->capacity);
+    size_t lead = rb->capacity - len / 2;
+    ASSERT_TRUE(ring_push(rb, fill, lead));
+    ASSERT_TRUE(ring_pop(rb, fill, lead));
+    free(fill);
+    ASSERT_TRUE(ring_push(rb, (uint8_t *)src, len));
+}
+
+TEST(writev_sends_both_segments_and_consumes) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < 100; i++) src[i] = (uint8_t)(i * 7 + 1);
+    push_wrapped(&rb, src, sizeof(src));
+
+    ASSERT_EQ(ring_writev(&rb, fds[1], 30), 30);
+    ASSERT_EQ(ring_used(&rb), 70);
+    ASSERT_EQ(ring_writev(&rb, fds[1], SIZE_MAX), 70);
+    ASSERT_EQ(ring_used(&rb), 0);
+    ASSERT_EQ(ring_writev(&rb, fds[1], SIZE_MAX), 0);
+
+    ASSERT_EQ(read(fds[0], dst, sizeof(dst)), (ssize_t)sizeof(dst));
+    ASSERT_EQ(memcmp(dst, src, sizeof(src)), 0);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(writev_short_write_consumes_only_what_was_written) {
+    ring_buffer_t rb;
+    size_t capacity = (size_t)1 << 18;
+    ASSERT_TRUE(ring_init(&rb, capacity, NULL));
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+
+    uint8_t *data = calloc(1, capacity);
+    ASSERT_TRUE(ring_push(&rb, data, capacity));
+
+    /* The pipe takes less than the ring holds, then reports EAGAIN */
+    ssize_t n = ring_writev(&rb, fds[1], SIZE_MAX);
+    ASSERT_TRUE(n > 0 && (size_t)n < capacity);
+    ASSERT_EQ(ring_used(&rb), capacity - (size_t)n);
+    ASSERT_EQ(ring_writev(&rb, fds[1], SIZE_MAX), -1);
+    ASSERT_EQ(errno, EAGAIN);
+    ASSERT_EQ(ring_used(&rb), capacity - (size_t)n);
+
+    free(data);
+    close(fds[0]);
+    close(fds[1]);
+    ring_destroy(&rb);
+}
+
+TEST(sink_io_uring_advances_tail_on_completion) {
+    ring_buffer_t rb;
+    init_buffer(&rb);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    ring_sink_t s;
+    if (ring_sink_init(&s, &rb, fds[1], RING_SINK_IO_URING)) {
+        uint8_t src[300], dst[300];
+        for (int i = 0; i < 300; i++) src[i] = (uint8_t)(i ^ 0x55);
+        push_wrapped(&rb, src, 200);
+
+        ASSERT_TRUE(ring_sink_submit(&s));
+        ASSERT_EQ(ring_sink_in_flight(&s), 200);
+        ASSERT_TRUE(ring_push(&rb, src + 200, 100));
+        ASSERT_TRUE(ring_sink_submit(&s));      /* One write at a time */
+        ASSERT_EQ(ring_sink_in_flight(&s), 200);
+
+        ASSERT_TRUE(ring_sink_complete(&s, true));
+        ASSERT_EQ(ring_sink_in_flight(&s), 0);
+        ASSERT_EQ(ring_used(&rb), 100);
+
+        ASSERT_TRUE(ring_sink_flush(&s));
+        ASSERT_EQ(ring_used(&rb), 0);
+        ASSERT_EQ(read(fds[0], dst, sizeof(dst)), (ssize_t)sizeof(dst));
+        ASSERT_EQ(memcmp(dst, src, sizeof(src)), 0);
+        ring_sink_destroy(&s);
+    }
+
+    /* The writev mode is always there, and consumes as it goes */
+    ASSERT_TRUE(ring_sink_init(&s, &rb, fds[1], RING_SINK_WRITEV));
+    uint8_t msg[5] = { 1, 2, 3, 4, 5 }, out[5];
+    ASSERT_TRUE(ring_push(&rb, msg, sizeof(msg)));
+    ASSERT_TRUE(ring_sink_poll(&s));
+    ASSERT_EQ(ring_used(&rb), 0);
+    ASSERT_EQ(read(fds[0], out, sizeof(out)), (ssize_t)sizeof(out));
+    ASSERT_EQ(memcmp(out, msg, sizeof(msg)), 0);
+    ring_sink_destroy(&s);
+
+    /* Errors stick */
+    close(fds[0]);
+    close(fds[1]);
+    ASSERT_TRUE(ring_sink_init(&s, &rb, fds[1], RING_SINK_WRITEV));
+    ASSERT_TRUE(ring_push(&rb, msg, sizeof(msg)));
+    ASSERT_FALSE(ring_sink_submit(&s));
+    ASSERT_EQ(s.error, EBADF);
+    ASSERT_FALSE(ring_sink_flush(&s));
+    ASSERT_EQ(ring_used(&rb), sizeof(msg));
+    ring_sink_destroy(&s);
+}
+
+/* ============ Pipeline Stages ============ */
+
+TEST(pipeline_stage_reads_only_what_upstream_released) {
+    ring_pipeline_t p;
+    ASSERT_FALSE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, 0));
+    ASSERT_FALSE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, RING_PIPELINE_MAX_STAGES + 1));
+    ASSERT_TRUE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, 3));
+
+    uint8_t msg[16];
+    memset(msg, 0xAB, sizeof(msg));
+    ring_span_t span;
+
+    /* Nothing published yet */
+    ASSERT_FALSE(ring_stage_peek(&p, 0, sizeof(msg), &span));
+
+    ASSERT_TRUE(ring_push(&p.ring, msg, sizeof(msg)));
+    ASSERT_EQ(ring_stage_lag(&p, 0), sizeof(msg));
+    ASSERT_FALSE(ring_stage_peek(&p, 1, 1, &span));
+    ASSERT_FALSE(ring_stage_peek(&p, 2, 1, &span));
+
+    /* Stage 0 rewrites the message in place; stage 1 sees the change */
+    ASSERT_TRUE(ring_stage_peek(&p, 0, sizeof(msg), &span));
+    ASSERT_EQ(span.first_len, sizeof(msg));
+    memset(span.first, 0x11, span.first_len);
+    ring_stage_release(&p, 0, sizeof(msg));
+    ASSERT_EQ(ring_stage_lag(&p, 0), 0);
+    ASSERT_EQ(ring_stage_lag(&p, 1), sizeof(msg));
+    ASSERT_FALSE(ring_stage_peek(&p, 2, 1, &span));
+
+    ASSERT_TRUE(ring_stage_peek(&p, 1, sizeof(msg), &span));
+    ASSERT_EQ(span.first[0], 0x11);
+    ASSERT_EQ(span.first[15], 0x11);
+    ring_stage_release(&p, 1, sizeof(msg));
+
+    /* Only the last stage frees space for the producer */
+    ASSERT_EQ(ring_used(&p.ring), sizeof(msg));
+    ASSERT_TRUE(ring_stage_peek(&p, 2, sizeof(msg), &span));
+    ring_stage_release(&p, 2, sizeof(msg));
+    ASSERT_EQ(ring_used(&p.ring), 0);
+    ring_pipeline_destroy(&p);
+}
+
+TEST(pipeline_producer_gated_by_last_stage) {
+    ring_pipeline_t p;
+    ASSERT_TRUE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, 2));
+
+    uint8_t block[BUFFER_SIZE];
+    memset(block, 0, sizeof(block));
+    ASSERT_TRUE(ring_push(&p.ring, block, sizeof(block)));
+    ASSERT_FALSE(ring_push(&p.ring, block, 1));
+
+    ring_span_t span;
+    ASSERT_TRUE(ring_stage_peek(&p, 0, sizeof(block), &span));
+    ring_stage_release(&p, 0, sizeof(block));
+    ASSERT_FALSE(ring_push(&p.ring, block, 1));     /* Stage 0 done isn't enough */
+
+    ASSERT_TRUE(ring_stage_peek(&p, 1, 100, &span));
+    ring_stage_release(&p, 1, 100);
+    ASSERT_TRUE(ring_push(&p.ring, block, 100));
+
+    /* A single stage is an ordinary consumer */
+    ASSERT_TRUE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, 1));
+    ASSERT_TRUE(ring_push(&p.ring, block, 8));
+    ASSERT_TRUE(ring_stage_peek(&p, 0, 8, &span));
+    ring_stage_release(&p, 0, 8);
+    ASSERT_EQ(ring_used(&p.ring), 0);
+    ring_pipeline_destroy(&p);
+}
+
+static size_t pipeline_add_one(const ring_span_t *span, void *ctx) {
+    size_t *calls = ctx;
+    (*calls)++;
+    for (size_t i = 0; i < span->first_len; i++) span->first[i]++;
+    for (size_t i = 0; i < span->second_len; i++) span->second[i]++;
+    return span->first_len + span->second_len;
+}
+
+TEST(pipeline_stage_drain_processes_backlog_across_wrap) {
+    ring_pipeline_t p;
+    ASSERT_TRUE(ring_pipeline_init(&p, BUFFER_SIZE, test_storage, 2));
+
+    /* Walk every cursor to just before the end, so 200 bytes straddle it */
+    size_t lead = BUFFER_SIZE - 100;
+    uint8_t data[BUFFER_SIZE];
+    memset(data, 0, sizeof(data));
+    ASSERT_TRUE(ring_push(&p.ring, data, lead));
+    ring_stage_release(&p, 0, lead);
+    ring_stage_release(&p, 1, lead);
+    ASSERT_TRUE(ring_push(&p.ring, data, 200));
+
+    size_t calls = 0;
+    ASSERT_EQ(ring_stage_drain(&p, 1, SIZE_MAX, pipeline_add_one, &calls), 0);
+    ASSERT_EQ(calls, 0);
+    ASSERT_EQ(ring_stage_drain(&p, 0, SIZE_MAX, pipeline_add_one, &calls), 200);
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(ring_stage_drain(&p, 0, SIZE_MAX, pipeline_add_one, &calls), 0);
+    ASSERT_EQ(calls, 1);
+
+    ASSERT_EQ(ring_stage_drain(&p, 1, 50, pipeline_add_one, &calls), 50);
+    ASSERT_EQ(ring_stage_drain(&p, 1, SIZE_MAX, pipeline_add_one, &calls), 150);
+    ASSERT_EQ(ring_used(&p.ring), 0);
+
+    /* Every byte went through both stages exactly once */
+    ring_copy_out(&p.ring, lead & p.ring.mask, data, 200);
+    for (int i = 0; i < 200; i++) ASSERT_EQ(data[i], 2);
+    ring_pipeline_destroy(&p);
+}
+
 int main(void) {
     printf("Running unit tests...\n\n");
     printf("Basic Operations:\n");
@@ -312,7 +2352,7 @@ int main(void) {
     RUN_TEST(push_pop_sequence);
 
     printf("\nCapacity Tests:\n");
-    RUN_TEST(max_capacity_is_buffer_size_minus_one);
+    RUN_TEST(max_capacity_is_buffer_size);
     RUN_TEST(fill_and_drain);
     RUN_TEST(partial_pop);
     RUN_TEST(pop_more_than_available_fails);
@@ -326,11 +2366,145 @@ int main(void) {
     RUN_TEST(zero_length_push);
     RUN_TEST(zero_length_pop);
     RUN_TEST(alternating_push_pop);
+    RUN_TEST(counters_are_free_running);
+    RUN_TEST(counters_survive_integer_overflow);
 
     printf("\nData Integrity:\n");
     RUN_TEST(data_pattern_integrity);
     RUN_TEST(fifo_order_preserved);
 
+    printf("\nRuntime Sizing:\n");
+    RUN_TEST(init_rejects_non_power_of_two);
+    RUN_TEST(init_rejects_misaligned_buffer);
+    RUN_TEST(init_uses_caller_buffer);
+    RUN_TEST(init_allocates_large_ring);
+    RUN_TEST(tiny_ring);
+
+    printf("\nZero-Copy API:\n");
+    RUN_TEST(reserve_commit_roundtrip);
+    RUN_TEST(reserve_fails_when_full);
+    RUN_TEST(reserve_wrapped_reports_two_spans);
+    RUN_TEST(reserve_contiguous_refuses_wrap);
+    RUN_TEST(commit_less_than_reserved);
+    RUN_TEST(peek_release);
+
+    printf("\nBatched API:\n");
+    RUN_TEST(push_batch_all_fit);
+    RUN_TEST(push_batch_partial_prefix);
+    RUN_TEST(pop_batch_roundtrip_wrapped);
+    RUN_TEST(batch_empty);
+
+    printf("\nMessage Framing:\n");
+    RUN_TEST(msg_roundtrip_variable_sizes);
+    RUN_TEST(msg_pop_too_small_keeps_message);
+    RUN_TEST(msg_wrapped_frame);
+    RUN_TEST(msg_contiguous_pads_at_wrap);
+    RUN_TEST(msg_contiguous_rejects_over_half_capacity);
+    RUN_TEST(msg_full_ring_fails);
+
+    printf("\nMPSC:\n");
+    RUN_TEST(mpsc_push_pop);
+    RUN_TEST(mpsc_capacity_and_wrap);
+
+    printf("\nMPMC:\n");
+    RUN_TEST(mpmc_init_rejects_bad_geometry);
+    RUN_TEST(mpmc_fifo_full_empty);
+    RUN_TEST(mpmc_caller_buffer);
+
+    printf("\nBroadcast:\n");
+    RUN_TEST(broadcast_every_reader_sees_every_message);
+    RUN_TEST(broadcast_blocking_gated_by_slowest_reader);
+    RUN_TEST(broadcast_lossy_reports_overrun);
+    RUN_TEST(broadcast_rejects_bad_reader_count);
+
+    printf("\nWait Strategies:\n");
+    RUN_TEST(wait_push_pop_without_contention);
+    RUN_TEST(wait_rejects_impossible_length);
+
+    printf("\nShared Memory:\n");
+    RUN_TEST(shm_create_attach_roundtrip);
+    RUN_TEST(shm_attach_rejects_bad_header);
+    RUN_TEST(shm_role_takeover_from_dead_owner);
+
+    printf("\nMirrored Ring:\n");
+    RUN_TEST(mirrored_init_requires_page_multiple);
+    RUN_TEST(mirrored_halves_alias);
+    RUN_TEST(mirrored_wrap_is_single_span);
+    RUN_TEST(mirrored_framed_needs_no_padding);
+
+    printf("\nPage-Aware Allocation:\n");
+    RUN_TEST(alloc_opts_rejects_non_page_multiple);
+    RUN_TEST(alloc_opts_default_pages);
+    RUN_TEST(alloc_opts_transparent_huge_pages);
+    RUN_TEST(alloc_opts_hugetlb_fails_cleanly);
+    RUN_TEST(alloc_opts_numa_bind);
+
+    printf("\nTyped Rings:\n");
+    RUN_TEST(typed_ring_fifo_order);
+    RUN_TEST(typed_ring_full_at_capacity);
+    RUN_TEST(typed_ring_wraparound);
+
+    printf("\nInstrumentation:\n");
+    RUN_TEST(stats_count_ops_failures_and_bytes);
+    RUN_TEST(stats_high_water_and_occupancy);
+    RUN_TEST(stats_cover_batch_zero_copy_and_framing);
+
+    printf("\nLatency Histogram:\n");
+    RUN_TEST(hist_small_values_are_exact);
+    RUN_TEST(hist_buckets_cover_range_with_bounded_error);
+    RUN_TEST(hist_tail_percentiles);
+    RUN_TEST(hist_merge);
+
+    printf("\nClock:\n");
+    RUN_TEST(clock_monotonic_fallback);
+    RUN_TEST(clock_auto_measures_real_time);
+    RUN_TEST(clock_cycles_when_available);
+
+    printf("\nCopy Hints:\n");
+    RUN_TEST(stream_push_roundtrip_any_alignment);
+    RUN_TEST(prefetch_pop_preserves_data);
+    RUN_TEST(ring_hints_apply_to_every_copy_path);
+
+    printf("\nCopy Kernels:\n");
+    RUN_TEST(copy_kernels_exact_for_any_length_and_alignment);
+    RUN_TEST(copy_kernel_best_is_default_and_supported);
+    RUN_TEST(every_copy_kernel_survives_wraparound);
+
+    printf("\nWrite Combining:\n");
+    RUN_TEST(staged_pushes_publish_at_byte_threshold);
+    RUN_TEST(staged_pushes_publish_at_message_count_and_flush);
+    RUN_TEST(staged_push_that_does_not_fit_publishes_and_wraps);
+
+    printf("\nDraining:\n");
+    RUN_TEST(pop_available_takes_backlog_up_to_cap);
+    RUN_TEST(pop_available_across_wrap);
+    RUN_TEST(drain_hands_over_spans_and_keeps_remainder);
+
+    printf("\nLossy (Overwrite-Oldest):\n");
+    RUN_TEST(lossy_push_keeps_order_when_consumer_keeps_up);
+    RUN_TEST(lossy_lapped_consumer_skips_to_live_edge);
+    RUN_TEST(lossy_pop_detects_overwrite_during_copy);
+    RUN_TEST(lossy_records_rejected_when_capacity_below_header);
+    RUN_TEST(lossy_records_resume_on_record_boundary);
+
+    printf("\nAsync Logger:\n");
+    RUN_TEST(log_format_parsing);
+    RUN_TEST(log_round_trip_matches_printf);
+    RUN_TEST(log_long_strings_truncate_to_record_limit);
+    RUN_TEST(log_rejects_unregistered_format);
+    RUN_TEST(log_decode_reports_truncated_file);
+    RUN_TEST(log_decode_rejects_corrupt_blocks);
+
+    printf("\nFile Descriptor Sink:\n");
+    RUN_TEST(writev_sends_both_segments_and_consumes);
+    RUN_TEST(writev_short_write_consumes_only_what_was_written);
+    RUN_TEST(sink_io_uring_advances_tail_on_completion);
+
+    printf("\nPipeline Stages:\n");
+    RUN_TEST(pipeline_stage_reads_only_what_upstream_released);
+    RUN_TEST(pipeline_producer_gated_by_last_stage);
+    RUN_TEST(pipeline_stage_drain_processes_backlog_across_wrap);
+
     printf("\n========================================\n");
     printf("Results: %d passed, %d failed\n", tests_passed, tests_failed);
 